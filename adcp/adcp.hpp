@@ -290,12 +290,13 @@ std::tuple<PP, SP> Setup(size_t LOG_MAXIMUM_COINS, size_t MAX_RECEIVER_NUM, size
     return {pp, sp};
 }
 
-/* initialize the encryption part for faster decryption */
-void Initialize(PP &pp)
+/* initialize the encryption part for faster decryption: the returned solver is passed to the algorithms that decrypt */
+DLogSolver Initialize(PP &pp)
 {
     std::cout << "initialize ADCP >>>" << std::endl;  
-    TwistedExponentialElGamal::Initialize(pp.enc_part); 
+    DLogSolver dlog_solver = TwistedExponentialElGamal::Initialize(pp.enc_part); 
     PrintSplitLine('-'); 
+    return dlog_solver; 
 }
 
 /* create an account for input identity */
@@ -326,7 +327,7 @@ Account CreateAccount(PP &pp, std::string identity, BigInt &init_balance, BigInt
 }
 
 /* update Account if CTx is valid */
-bool UpdateAccount(PP &pp, ToOneCTx &newCTx, Account &Acct_sender, Account &Acct_receiver)
+bool UpdateAccount(PP &pp, const DLogSolver &dlog_solver, ToOneCTx &newCTx, Account &Acct_sender, Account &Acct_receiver)
 {    
     std::cout << "update accounts >>>" << std::endl;
     
@@ -337,25 +338,25 @@ bool UpdateAccount(PP &pp, ToOneCTx &newCTx, Account &Acct_sender, Account &Acct
 
     // update sender's balance
     Acct_sender.balance_ct = TwistedExponentialElGamal::HomoSub(Acct_sender.balance_ct, c_out); 
-    Acct_sender.m = TwistedExponentialElGamal::Dec(pp.enc_part, Acct_sender.sk, Acct_sender.balance_ct); 
+    Acct_sender.m = TwistedExponentialElGamal::Dec(pp.enc_part, dlog_solver, Acct_sender.sk, Acct_sender.balance_ct); 
     SaveAccount(Acct_sender, Acct_sender.identity+".account"); 
 
     // update receiver's balance
     Acct_receiver.balance_ct = TwistedExponentialElGamal::HomoAdd(Acct_receiver.balance_ct, c_in); 
-    Acct_receiver.m = TwistedExponentialElGamal::Dec(pp.enc_part, Acct_receiver.sk, Acct_receiver.balance_ct);
+    Acct_receiver.m = TwistedExponentialElGamal::Dec(pp.enc_part, dlog_solver, Acct_receiver.sk, Acct_receiver.balance_ct);
     SaveAccount(Acct_receiver, Acct_receiver.identity+".account"); 
         
     return true; 
 } 
 
 /* reveal the balance */ 
-BigInt RevealBalance(PP &pp, Account &Acct)
+BigInt RevealBalance(PP &pp, const DLogSolver &dlog_solver, Account &Acct)
 {
-    return TwistedExponentialElGamal::Dec(pp.enc_part, Acct.sk, Acct.balance_ct); 
+    return TwistedExponentialElGamal::Dec(pp.enc_part, dlog_solver, Acct.sk, Acct.balance_ct); 
 }
 
 /* supervisor opens CTx */
-BigInt SuperviseCTx(SP &sp, PP &pp, ToOneCTx &ctx)
+BigInt SuperviseCTx(SP &sp, PP &pp, const DLogSolver &dlog_solver, ToOneCTx &ctx)
 {
     std::cout << "Supervise " << GetCTxFileName(ctx) << std::endl; 
     auto start_time = std::chrono::steady_clock::now(); 
@@ -364,7 +365,7 @@ BigInt SuperviseCTx(SP &sp, PP &pp, ToOneCTx &ctx)
     TwistedExponentialElGamal::CT ct; 
     ct.X = ctx.transfer_ct.vec_X[2];
     ct.Y = ctx.transfer_ct.Y;  
-    BigInt v = TwistedExponentialElGamal::Dec(pp.enc_part, sp.ska, ct); 
+    BigInt v = TwistedExponentialElGamal::Dec(pp.enc_part, dlog_solver, sp.ska, ct); 
 
     std::cout << ctx.pks.ToHexString() << " transfers " << BN_bn2dec(v.bn_ptr) 
     << " coins to " << ctx.pkr.ToHexString() << std::endl; 
@@ -616,7 +617,7 @@ bool VerifyCTx(PP &pp, ToOneCTx &newCTx)
 }
 
 /* check if a ctx is valid and update accounts if so */
-bool Miner(PP &pp, ToOneCTx &newCTx, Account &Acct_sender, Account &Acct_receiver)
+bool Miner(PP &pp, const DLogSolver &dlog_solver, ToOneCTx &newCTx, Account &Acct_sender, Account &Acct_receiver)
 {
     if (newCTx.pks != Acct_sender.pk){
         std::cout << "sender does not match CTx" << std::endl; 
@@ -630,7 +631,7 @@ bool Miner(PP &pp, ToOneCTx &newCTx, Account &Acct_sender, Account &Acct_receive
 
     std::string ctx_file = GetCTxFileName(newCTx); 
     if(VerifyCTx(pp, newCTx) == true){
-        UpdateAccount(pp, newCTx, Acct_sender, Acct_receiver);
+        UpdateAccount(pp, dlog_solver, newCTx, Acct_sender, Acct_receiver);
         SaveCTx(newCTx, ctx_file);  
         std::cout << ctx_file << " is recorded on the blockchain" << std::endl; 
         return true; 
@@ -849,7 +850,7 @@ bool AuditPolicy(PP &pp, ECPoint pk, ToOneCTx &ctx1, ToOneCTx &ctx2,
 
 
 /*  generate a NIZK proof for limit predicate */
-bool JustifyPolicy(PP &pp, Account &Acct_user, std::vector<ToOneCTx> &ctx_set, 
+bool JustifyPolicy(PP &pp, const DLogSolver &dlog_solver, Account &Acct_user, std::vector<ToOneCTx> &ctx_set, 
                    LimitPolicy &policy, Gadget::Proof_type2 &limit_proof)
 {
     for(auto i = 0; i < ctx_set.size(); i++){
@@ -881,7 +882,7 @@ bool JustifyPolicy(PP &pp, Account &Acct_user, std::vector<ToOneCTx> &ctx_set,
 
     std::string transcript_str = ""; 
 
-    Gadget::Prove(gadget_pp, instance, policy.LEFT_BOUND, policy.RIGHT_BOUND, witness, transcript_str, limit_proof); 
+    Gadget::Prove(gadget_pp, dlog_solver, instance, policy.LEFT_BOUND, policy.RIGHT_BOUND, witness, transcript_str, limit_proof); 
     
     auto end_time = std::chrono::steady_clock::now(); 
 
@@ -1393,13 +1394,13 @@ void PrintCTx(ToManyCTx &newCTx)
 }
 
 /* update Account if CTx is valid */
-bool UpdateAccount(PP &pp, ToManyCTx &newCTx, Account &Acct_sender, std::vector<Account> &vec_Acct_receiver)
+bool UpdateAccount(PP &pp, const DLogSolver &dlog_solver, ToManyCTx &newCTx, Account &Acct_sender, std::vector<Account> &vec_Acct_receiver)
 {    
     Acct_sender.sn = Acct_sender.sn + bn_1;
 
     // update sender's balance
     Acct_sender.balance_ct = TwistedExponentialElGamal::HomoSub(Acct_sender.balance_ct, newCTx.sender_transfer_ct); 
-    Acct_sender.m = TwistedExponentialElGamal::Dec(pp.enc_part, Acct_sender.sk, Acct_sender.balance_ct); 
+    Acct_sender.m = TwistedExponentialElGamal::Dec(pp.enc_part, dlog_solver, Acct_sender.sk, Acct_sender.balance_ct); 
     SaveAccount(Acct_sender, Acct_sender.identity+".account"); 
 
     TwistedExponentialElGamal::CT c_in; 
@@ -1408,7 +1409,7 @@ bool UpdateAccount(PP &pp, ToManyCTx &newCTx, Account &Acct_sender, std::vector<
         c_in.Y = newCTx.vec_receiver_transfer_ct[i].Y;
         // update receiver's balance
         vec_Acct_receiver[i].balance_ct = TwistedExponentialElGamal::HomoAdd(vec_Acct_receiver[i].balance_ct, c_in); 
-        vec_Acct_receiver[i].m = TwistedExponentialElGamal::Dec(pp.enc_part, vec_Acct_receiver[i].sk, vec_Acct_receiver[i].balance_ct);
+        vec_Acct_receiver[i].m = TwistedExponentialElGamal::Dec(pp.enc_part, dlog_solver, vec_Acct_receiver[i].sk, vec_Acct_receiver[i].balance_ct);
         SaveAccount(vec_Acct_receiver[i], vec_Acct_receiver[i].identity+".account"); 
     }
 
@@ -1417,7 +1418,7 @@ bool UpdateAccount(PP &pp, ToManyCTx &newCTx, Account &Acct_sender, std::vector<
 
 
 /* check if a ctx is valid and update accounts if so */
-bool Miner(PP &pp, ToManyCTx &newCTx, Account &Acct_sender, std::vector<Account> &vec_Acct_receiver)
+bool Miner(PP &pp, const DLogSolver &dlog_solver, ToManyCTx &newCTx, Account &Acct_sender, std::vector<Account> &vec_Acct_receiver)
 {
     if (newCTx.pks != Acct_sender.pk){
         std::cout << "sender does not match CTx" << std::endl; 
@@ -1432,7 +1433,7 @@ bool Miner(PP &pp, ToManyCTx &newCTx, Account &Acct_sender, std::vector<Account>
 
     std::string ctx_file = GetCTxFileName(newCTx); 
     if(VerifyCTx(pp, newCTx) == true){
-        UpdateAccount(pp, newCTx, Acct_sender, vec_Acct_receiver);
+        UpdateAccount(pp, dlog_solver, newCTx, Acct_sender, vec_Acct_receiver);
         SaveCTx(newCTx, ctx_file);  
         std::cout << ctx_file << " is recorded on the blockchain" << std::endl; 
         return true; 
@@ -1445,7 +1446,7 @@ bool Miner(PP &pp, ToManyCTx &newCTx, Account &Acct_sender, std::vector<Account>
 
 
 /* supervisor opens CTx */
-std::vector<BigInt> SuperviseCTx(SP &sp, PP &pp, ToManyCTx &ctx)
+std::vector<BigInt> SuperviseCTx(SP &sp, PP &pp, const DLogSolver &dlog_solver, ToManyCTx &ctx)
 {
     size_t n = ctx.vec_pkr.size();
     std::vector<BigInt> vec_v(n); 
@@ -1459,7 +1460,7 @@ std::vector<BigInt> SuperviseCTx(SP &sp, PP &pp, ToManyCTx &ctx)
     for(auto i = 0; i < n; i++){
         ct.X = ctx.vec_receiver_transfer_ct[i].vec_X[1];
         ct.Y = ctx.vec_receiver_transfer_ct[i].Y;  
-        vec_v[i] = TwistedExponentialElGamal::Dec(pp.enc_part, sp.ska, ct);
+        vec_v[i] = TwistedExponentialElGamal::Dec(pp.enc_part, dlog_solver, sp.ska, ct);
         std::cout << BN_bn2dec(vec_v[i].bn_ptr) << " coins to " << ctx.vec_pkr[i].ToHexString() << std::endl; 
     } 
 
@@ -9,23 +9,39 @@ inline size_t BN_BYTE_LEN;    // the byte length of bigint
 inline size_t INT_BYTE_LEN; 
 //inline size_t FIELD_BYTE_LEN;  // each scalar field element is 256 bit 
 
-inline BN_CTX *bn_ctx[NUMBER_OF_THREADS]; // define ctx for ecc operations
+/*
+** ctx for ecc operations: BN_CTX is not thread safe, so every OS thread owns one
+** call sites keep the form bn_ctx[omp_get_thread_num()], the index is ignored and the calling thread's ctx is returned
+** a plain array indexed by omp thread number breaks once two std::threads each start an OpenMP team
+** (e.g. running two protocol roles concurrently), since both teams number their threads from 0
+*/
+struct BNContextHolder{
+    BN_CTX *ctx; 
+    BNContextHolder(){
+        ctx = BN_CTX_new(); 
+        if (ctx == nullptr) std::cerr << "bn_ctx initialize fails" << std::endl;
+    }
+    ~BNContextHolder(){ BN_CTX_free(ctx); }
+};
+
+struct BNContextPool{
+    inline BN_CTX* operator[](size_t) const {
+        static thread_local BNContextHolder holder; 
+        return holder.ctx; 
+    }
+};
+
+inline const BNContextPool bn_ctx; 
 
 
 void BN_Initialize(){
-    for(auto i = 0; i < NUMBER_OF_THREADS; i++){
-        bn_ctx[i] = BN_CTX_new();
-        if (bn_ctx[i] == nullptr) std::cerr << "bn_ctx initialize fails" << std::endl;
-    }
+    bn_ctx[0]; // create the ctx of main thread
     //BN_BIT_LEN = BN_BYTE_LEN * 8; 
     INT_BYTE_LEN = sizeof(size_t); 
 }
 
-void BN_Finalize(){
-    for(auto i = 0; i < NUMBER_OF_THREADS; i++){
-        BN_CTX_free(bn_ctx[i]);
-    }
-} 
+// each ctx is released when its owner thread exits
+void BN_Finalize(){} 
 
 
 // wrapper class for openssl BIGNUM
@@ -88,6 +88,15 @@ block BytesToBlock(const std::vector<uint8_t> &vec_A)
     return _mm_load_si128((block*)&output[0]);
 }
 
+// hash a fixed-width item stored in a contiguous buffer
+__attribute__((target("sse2")))
+block BytesToBlock(const uint8_t* input, size_t LEN) 
+{
+    unsigned char output[HASH_OUTPUT_LEN];
+    BasicHash(input, LEN, output); 
+    return _mm_load_si128((block*)&output[0]);
+}
+
 BigInt StringToBigInt(const std::string& str_input){
     unsigned char output[HASH_OUTPUT_LEN]; 
     const unsigned char* input = reinterpret_cast<const unsigned char*>(str_input.c_str());
@@ -207,6 +216,29 @@ int BlockToBytes(const block &var, uint8_t* output, size_t LEN)
     return 1; 
 }
 
+/*
+** batch version of BlockToBytes(input[i], output+32*i, 32)
+** the two CBC rounds of AES::BATCH_SIZE inputs are pipelined through FastECBEnc
+** (the second plaintext block is zero, so its CBC input is exactly the first ciphertext)
+*/
+__attribute__((target("aes,sse2")))
+void BlocksToBytes(const block* input, uint8_t* output, size_t LEN)
+{
+    block c0[AES::BATCH_SIZE];
+    block c1[AES::BATCH_SIZE];
+    for(size_t i = 0; i < LEN; i += AES::BATCH_SIZE){
+        size_t CURRENT_LEN = std::min(AES::BATCH_SIZE, LEN - i);
+        for(auto j = 0; j < CURRENT_LEN; j++) c0[j] = _mm_xor_si128(_mm_loadu_si128(input+i+j), AES::IV);
+        AES::FastECBEnc(AES::fixed_enc_key, c0, CURRENT_LEN, c1);
+        memcpy(c0, c1, CURRENT_LEN*sizeof(block));
+        AES::FastECBEnc(AES::fixed_enc_key, c1, CURRENT_LEN);
+        for(auto j = 0; j < CURRENT_LEN; j++){
+            _mm_storeu_si128((block*)(output+(i+j)*32), c0[j]);
+            _mm_storeu_si128((block*)(output+(i+j)*32+16), c1[j]);
+        }
+    }
+}
+
 // fast and threadsafe block to ecpoint hash using low level openssl code
 inline ECPoint BlockToECPoint(const block &var)
 {
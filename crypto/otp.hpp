@@ -54,6 +54,37 @@ std::vector<uint8_t> Dec(block &key, std::vector<uint8_t>& ciphertext)
     return plaintext; 
 }
 
+/*
+** in-place variant for fixed-width items living in a contiguous buffer:
+** the pad is expanded batch by batch on the stack and xored straight into output,
+** the keystream is identical to the one used by Enc/Dec above
+** plaintext and ciphertext may point to the same memory
+*/
+inline void XORPad(block &key, const uint8_t* input, uint8_t* output, size_t LEN)
+{
+    PRG::Seed seed = PRG::SetSeed(&key, 0);
+    block pad[AES::BATCH_SIZE];
+    const size_t BATCH_BYTE_LEN = AES::BATCH_SIZE*sizeof(block);
+    for(size_t offset = 0; offset < LEN; offset += BATCH_BYTE_LEN){
+        size_t CURRENT_LEN = std::min(BATCH_BYTE_LEN, LEN - offset);
+        size_t BLOCK_NUM = (CURRENT_LEN + sizeof(block) - 1)/sizeof(block);
+        for(auto j = 0; j < BLOCK_NUM; j++) pad[j] = Block::MakeBlock(0LL, seed.counter++);
+        AES::FastECBEnc(seed.aes_key, pad, BLOCK_NUM);
+        uint8_t* pad_ptr = reinterpret_cast<uint8_t*>(pad);
+        for(auto j = 0; j < CURRENT_LEN; j++) output[offset+j] = input[offset+j]^pad_ptr[j];
+    }
+}
+
+inline void Enc(block &key, const uint8_t* plaintext, uint8_t* ciphertext, size_t LEN)
+{
+    XORPad(key, plaintext, ciphertext, LEN);
+}
+
+inline void Dec(block &key, const uint8_t* ciphertext, uint8_t* plaintext, size_t LEN)
+{
+    XORPad(key, ciphertext, plaintext, LEN);
+}
+
 std::string Enc(block &key, std::string& str_plaintext)
 {
     size_t LEN = str_plaintext.size(); 
@@ -0,0 +1,539 @@
+/*
+** Binary fuse filter, following "Binary Fuse Filters: Fast and Smaller Than Xor Filters" (Graf and Lemire, JEA 2022)
+** (1) 3-wise construction with byte-granular fingerprints, so that the false positive rate matches a statistical parameter
+** (2) add serialize/deserialize interfaces
+** (3) multi-threaded construction peels all slots of degree one in rounds, batch queries prefetch the three slots
+** it is a static filter: all elements are given at construction, after which only Contain is supported
+*/
+
+#ifndef KUNLUN_BINARY_FUSE_FILTER_HPP
+#define KUNLUN_BINARY_FUSE_FILTER_HPP
+
+#include "../include/std.inc"
+#include "../utility/serialization.hpp"
+#include "../utility/murmurhash3.hpp"
+#include "../utility/print.hpp"
+#include "../crypto/block.hpp"
+#include "../crypto/ec_point.hpp"
+#include "../crypto/ec_25519.hpp"
+
+// number of keys whose three slots are prefetched before their fingerprints are compared
+inline const size_t FUSE_BATCH_WINDOW = 16; 
+
+/*
+** each element is first compressed to a 128-bit digest: the low half decides the three slots, the high half the fingerprint
+** a filter with fingerprint_byte_len = ceil(lambda/8) costs about 1.125*8*ceil(lambda/8) bits per element
+** and has false positive probability 2^{-8*fingerprint_byte_len}
+*/
+
+class BinaryFuseFilter{
+public:
+    uint64_t seed; // re-drawn whenever peeling fails
+    uint32_t segment_length;
+    uint32_t segment_length_mask;
+    uint32_t segment_count;
+    uint32_t segment_count_length;
+    uint32_t array_length;
+    uint32_t fingerprint_byte_len; // 1 to 8
+    size_t element_num;
+
+    // array_length fingerprints of fingerprint_byte_len bytes, followed by 8 bytes of padding for unaligned loads
+    std::vector<uint8_t> fingerprint_table;
+
+    size_t max_build_attempt = 100;
+
+    BinaryFuseFilter() {};
+
+    BinaryFuseFilter(size_t projected_element_num, size_t statistical_security_parameter)
+    {
+        fingerprint_byte_len = std::min<size_t>(8, std::max<size_t>(1, (statistical_security_parameter + 7)/8));
+        seed = 0x9E3779B97F4A7C15ULL;
+        element_num = 0;
+        SetSize(std::max<size_t>(2, projected_element_num));
+    }
+
+    ~BinaryFuseFilter() {};
+
+    // segment length and size factor follow the reference implementation for arity 3
+    void SetSize(size_t n)
+    {
+        segment_length = uint32_t(1) << int(floor(log(double(n))/log(3.33) + 2.25));
+        if(segment_length > 262144) segment_length = 262144;
+        segment_length_mask = segment_length - 1;
+        double size_factor = std::max(1.125, 0.875 + 0.25*log(1000000.0)/log(double(n)));
+        uint32_t capacity = uint32_t(round(double(n)*size_factor));
+        uint32_t init_segment_count = (capacity + segment_length - 1)/segment_length - 2;
+        array_length = (init_segment_count + 2)*segment_length;
+        segment_count = (array_length + segment_length - 1)/segment_length;
+        segment_count = (segment_count <= 2) ? 1 : segment_count - 2;
+        array_length = (segment_count + 2)*segment_length;
+        segment_count_length = segment_count*segment_length;
+        fingerprint_table.assign(size_t(array_length)*fingerprint_byte_len + 8, 0);
+    }
+
+    size_t ObjectSize()
+    {
+        // seed + element_num + 6 uint32_t parameters + table_content
+        return 2*sizeof(uint64_t) + 6*sizeof(uint32_t) + size_t(array_length)*fingerprint_byte_len;
+    }
+
+    inline uint64_t FingerprintMask() const
+    {
+        return (fingerprint_byte_len == 8) ? ~uint64_t(0) : ((uint64_t(1) << (8*fingerprint_byte_len)) - 1);
+    }
+
+    inline void ComputeSlot(uint64_t hash_value, uint32_t slot[3]) const
+    {
+        uint64_t hl = uint64_t(((unsigned __int128)hash_value * segment_count_length) >> 64);
+        slot[0] = uint32_t(hl);
+        slot[1] = slot[0] + segment_length;
+        slot[2] = slot[1] + segment_length;
+        slot[1] ^= uint32_t(hash_value >> 18) & segment_length_mask;
+        slot[2] ^= uint32_t(hash_value) & segment_length_mask;
+    }
+
+    inline void ComputeSlot(const block &digest, uint32_t slot[3]) const
+    {
+        uint64_t word[2];
+        memcpy(word, &digest, sizeof(block));
+        ComputeSlot(fmix64(word[0] ^ seed), slot);
+    }
+
+    inline uint64_t ComputeFingerprint(const block &digest) const
+    {
+        uint64_t word[2];
+        memcpy(word, &digest, sizeof(block));
+        return fmix64(word[1] ^ seed) & FingerprintMask();
+    }
+
+    inline uint64_t ReadFingerprint(uint32_t slot) const
+    {
+        uint64_t fingerprint;
+        memcpy(&fingerprint, fingerprint_table.data() + size_t(slot)*fingerprint_byte_len, sizeof(uint64_t));
+        return fingerprint & FingerprintMask();
+    }
+
+    // only works for little-endian
+    inline void WriteFingerprint(uint32_t slot, uint64_t fingerprint)
+    {
+        memcpy(fingerprint_table.data() + size_t(slot)*fingerprint_byte_len, &fingerprint, fingerprint_byte_len);
+    }
+
+    static inline block PlainDigest(const void* input, size_t LEN)
+    {
+        block digest;
+        MurmurHash3_x64_128(input, static_cast<int>(LEN), fixed_salt32, &digest);
+        return digest;
+    }
+
+    template <typename ElementType> // Note: T must be a C++ POD type.
+    static inline block Digest(const ElementType& element)
+    {
+        return PlainDigest(&element, sizeof(ElementType));
+    }
+
+    static inline block Digest(const std::string& str)
+    {
+        return PlainDigest(str.data(), str.size());
+    }
+
+    static inline block Digest(const ECPoint &A)
+    {
+        int thread_num = omp_get_thread_num();
+        #ifdef ECPOINT_COMPRESSED
+            unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
+            memset(buffer, 0, POINT_COMPRESSED_BYTE_LEN);
+            EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+            return PlainDigest(buffer, POINT_COMPRESSED_BYTE_LEN);
+        #else
+            unsigned char buffer[POINT_BYTE_LEN];
+            memset(buffer, 0, POINT_BYTE_LEN);
+            EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, bn_ctx[thread_num]);
+            return PlainDigest(buffer, POINT_BYTE_LEN);
+        #endif
+    }
+
+    static inline block Digest(const EC25519Point &A)
+    {
+        return PlainDigest(A.px, 32);
+    }
+
+    // one peeling attempt under the current seed
+    bool TryBuild(const std::vector<block> &vec_digest)
+    {
+        size_t NUM = vec_digest.size();
+        std::vector<uint32_t> vec_count(array_length, 0);
+        std::vector<uint32_t> vec_xor_index(array_length, 0); // xor of the indices of elements mapped to each slot
+
+        uint32_t slot[3];
+        for(auto i = 0; i < NUM; i++){
+            ComputeSlot(vec_digest[i], slot);
+            for(auto j = 0; j < 3; j++){
+                vec_count[slot[j]]++;
+                vec_xor_index[slot[j]] ^= i;
+            }
+        }
+
+        std::vector<uint32_t> vec_alone;
+        for(auto s = 0; s < array_length; s++){
+            if(vec_count[s] == 1) vec_alone.emplace_back(s);
+        }
+
+        // peel: (element index, the slot of that element which becomes its home)
+        std::vector<std::pair<uint32_t, uint8_t>> vec_peeled;
+        vec_peeled.reserve(NUM);
+        while(!vec_alone.empty()){
+            uint32_t s = vec_alone.back();
+            vec_alone.pop_back();
+            if(vec_count[s] != 1) continue;
+            uint32_t i = vec_xor_index[s];
+            ComputeSlot(vec_digest[i], slot);
+            uint8_t home = (slot[0] == s) ? 0 : ((slot[1] == s) ? 1 : 2);
+            vec_peeled.emplace_back(i, home);
+            for(auto j = 0; j < 3; j++){
+                vec_count[slot[j]]--;
+                vec_xor_index[slot[j]] ^= i;
+                if(vec_count[slot[j]] == 1) vec_alone.emplace_back(slot[j]);
+            }
+        }
+        if(vec_peeled.size() != NUM) return false;
+
+        // assign in reverse peeling order
+        std::fill(fingerprint_table.begin(), fingerprint_table.end(), 0);
+        for(auto it = vec_peeled.rbegin(); it != vec_peeled.rend(); it++){
+            ComputeSlot(vec_digest[it->first], slot);
+            uint8_t home = it->second;
+            uint64_t fingerprint = ComputeFingerprint(vec_digest[it->first])
+                                 ^ ReadFingerprint(slot[(home+1)%3]) ^ ReadFingerprint(slot[(home+2)%3]);
+            WriteFingerprint(slot[home], fingerprint);
+        }
+        return true;
+    }
+
+    /*
+    ** multi-threaded peeling attempt: every round removes, in parallel, the elements held by the slots of degree one,
+    ** and collects the slots whose degree drops to one for the next round; counts and xor-indices are updated atomically
+    ** an element held by several slots of degree one is peeled from the smallest of them, so the result is deterministic
+    ** elements peeled in the same round never occupy each other's home slots, so each round is assigned in parallel
+    */
+    bool TryBuildParallel(const std::vector<block> &vec_digest)
+    {
+        size_t NUM = vec_digest.size();
+        size_t THREAD_NUM = NUMBER_OF_THREADS; 
+        std::vector<uint32_t> vec_slot(3*NUM);
+        std::vector<uint32_t> vec_count(array_length, 0);
+        std::vector<uint32_t> vec_xor_index(array_length, 0);
+
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto i = 0; i < NUM; i++){
+            ComputeSlot(vec_digest[i], vec_slot.data() + 3*i);
+            for(auto j = 0; j < 3; j++){
+                #pragma omp atomic
+                vec_count[vec_slot[3*i+j]]++;
+                #pragma omp atomic
+                vec_xor_index[vec_slot[3*i+j]] ^= uint32_t(i);
+            }
+        }
+
+        std::vector<uint32_t> vec_alone;
+        for(auto s = 0; s < array_length; s++){
+            if(vec_count[s] == 1) vec_alone.emplace_back(s);
+        }
+
+        std::vector<std::pair<uint32_t, uint8_t>> vec_peeled;
+        vec_peeled.reserve(NUM);
+        std::vector<size_t> vec_round_begin;
+        std::vector<std::vector<std::pair<uint32_t, uint8_t>>> vec_local_peeled(THREAD_NUM);
+        std::vector<std::vector<uint32_t>> vec_local_alone(THREAD_NUM);
+        while(!vec_alone.empty()){
+            // pick the elements to peel: counts are not modified in this phase
+            #pragma omp parallel num_threads(THREAD_NUM)
+            {
+                std::vector<std::pair<uint32_t, uint8_t>> &local_peeled = vec_local_peeled[omp_get_thread_num()];
+                local_peeled.clear();
+                #pragma omp for
+                for(auto k = 0; k < vec_alone.size(); k++){
+                    uint32_t s = vec_alone[k];
+                    if(vec_count[s] != 1) continue;
+                    uint32_t i = vec_xor_index[s];
+                    const uint32_t *slot = vec_slot.data() + 3*i;
+                    bool smallest = true;
+                    uint8_t home = 0;
+                    for(auto j = 0; j < 3; j++){
+                        if(slot[j] == s) home = j;
+                        else if(slot[j] < s && vec_count[slot[j]] == 1) smallest = false;
+                    }
+                    if(smallest) local_peeled.emplace_back(i, home);
+                }
+            }
+            size_t ROUND_BEGIN = vec_peeled.size();
+            vec_round_begin.emplace_back(ROUND_BEGIN);
+            for(auto t = 0; t < THREAD_NUM; t++){
+                vec_peeled.insert(vec_peeled.end(), vec_local_peeled[t].begin(), vec_local_peeled[t].end());
+            }
+
+            // remove them, slots whose count drops from 2 to 1 form the next round
+            #pragma omp parallel num_threads(THREAD_NUM)
+            {
+                std::vector<uint32_t> &local_alone = vec_local_alone[omp_get_thread_num()];
+                local_alone.clear();
+                #pragma omp for
+                for(auto k = ROUND_BEGIN; k < vec_peeled.size(); k++){
+                    uint32_t i = vec_peeled[k].first;
+                    for(auto j = 0; j < 3; j++){
+                        uint32_t s = vec_slot[3*i+j];
+                        uint32_t old_count;
+                        #pragma omp atomic capture
+                        old_count = vec_count[s]--;
+                        #pragma omp atomic
+                        vec_xor_index[s] ^= i;
+                        if(old_count == 2) local_alone.emplace_back(s);
+                    }
+                }
+            }
+            vec_alone.clear();
+            for(auto t = 0; t < THREAD_NUM; t++){
+                vec_alone.insert(vec_alone.end(), vec_local_alone[t].begin(), vec_local_alone[t].end());
+            }
+        }
+        if(vec_peeled.size() != NUM) return false;
+
+        // assign round by round in reverse peeling order
+        std::fill(fingerprint_table.begin(), fingerprint_table.end(), 0);
+        vec_round_begin.emplace_back(NUM);
+        for(auto r = vec_round_begin.size() - 1; r > 0; r--){
+            #pragma omp parallel for num_threads(THREAD_NUM)
+            for(auto k = vec_round_begin[r-1]; k < vec_round_begin[r]; k++){
+                uint32_t i = vec_peeled[k].first;
+                uint8_t home = vec_peeled[k].second;
+                const uint32_t *slot = vec_slot.data() + 3*i;
+                uint64_t fingerprint = ComputeFingerprint(vec_digest[i])
+                                     ^ ReadFingerprint(slot[(home+1)%3]) ^ ReadFingerprint(slot[(home+2)%3]);
+                WriteFingerprint(slot[home], fingerprint);
+            }
+        }
+        return true;
+    }
+
+    // build from distinct digests; duplicated digests never peel, so they are removed after the first failure
+    bool BuildDigest(std::vector<block> vec_digest)
+    {
+        if(vec_digest.size() > std::numeric_limits<uint32_t>::max()){
+            std::cerr << "binary fuse filter supports at most 2^32 elements" << std::endl;
+            return false;
+        }
+        SetSize(std::max<size_t>(2, vec_digest.size()));
+
+        for(auto attempt = 0; attempt < max_build_attempt; attempt++){
+            bool status = (NUMBER_OF_THREADS > 1) ? TryBuildParallel(vec_digest) : TryBuild(vec_digest); 
+            if(status == true){
+                element_num = vec_digest.size();
+                return true;
+            }
+            seed = fmix64(seed + attempt + 1);
+            if(attempt == 0){
+                std::sort(vec_digest.begin(), vec_digest.end(), BlockCompare());
+                vec_digest.erase(std::unique(vec_digest.begin(), vec_digest.end(), [](const block &a, const block &b){
+                    return Block::Compare(a, b);
+                }), vec_digest.end());
+            }
+        }
+        std::cerr << "binary fuse filter construction fails" << std::endl;
+        return false;
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline bool Build(const Container<T, Allocator>& container)
+    {
+        std::vector<block> vec_digest(container.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < container.size(); i++){
+            vec_digest[i] = Digest(container[i]);
+        }
+        return BuildDigest(vec_digest);
+    }
+
+    inline bool ContainDigest(const block &digest) const
+    {
+        uint32_t slot[3];
+        ComputeSlot(digest, slot);
+        uint64_t fingerprint = ReadFingerprint(slot[0]) ^ ReadFingerprint(slot[1]) ^ ReadFingerprint(slot[2]);
+        return fingerprint == ComputeFingerprint(digest);
+    }
+
+    inline std::vector<uint8_t> ContainDigest(const std::vector<block> &vec_digest) const
+    {
+        std::vector<uint8_t> vec_indication_bit(vec_digest.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < vec_digest.size(); i++){
+            vec_indication_bit[i] = ContainDigest(vec_digest[i]);
+        }
+        return vec_indication_bit;
+    }
+
+    template <typename ElementType>
+    inline bool Contain(const ElementType& element) const
+    {
+        return ContainDigest(Digest(element));
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline std::vector<uint8_t> Contain(const Container<T, Allocator>& container) const
+    {
+        std::vector<uint8_t> vec_indication_bit(container.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < container.size(); i++){
+            vec_indication_bit[i] = ContainDigest(Digest(container[i]));
+        }
+        return vec_indication_bit;
+    }
+
+    /*
+    ** query ITEM_NUM keys of ITEM_LEN bytes stored contiguously: for each window of FUSE_BATCH_WINDOW keys,
+    ** the three slots of every key are computed and prefetched first, then the fingerprints are compared
+    */
+    inline std::vector<uint8_t> PlainContainBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM) const
+    {
+        std::vector<uint8_t> vec_indication_bit(ITEM_NUM);
+        size_t WINDOW_NUM = (ITEM_NUM + FUSE_BATCH_WINDOW - 1)/FUSE_BATCH_WINDOW;
+
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto w = 0; w < WINDOW_NUM; w++){
+            size_t BEGIN = w*FUSE_BATCH_WINDOW;
+            size_t LEN = std::min(FUSE_BATCH_WINDOW, ITEM_NUM - BEGIN);
+            uint32_t slot[FUSE_BATCH_WINDOW][3];
+            uint64_t fingerprint[FUSE_BATCH_WINDOW];
+            for(auto i = 0; i < LEN; i++){
+                block digest = PlainDigest(input + (BEGIN+i)*ITEM_LEN, ITEM_LEN);
+                ComputeSlot(digest, slot[i]);
+                fingerprint[i] = ComputeFingerprint(digest);
+                for(auto j = 0; j < 3; j++){
+                    __builtin_prefetch(fingerprint_table.data() + size_t(slot[i][j])*fingerprint_byte_len);
+                }
+            }
+            for(auto i = 0; i < LEN; i++){
+                vec_indication_bit[BEGIN+i] = 
+                    (ReadFingerprint(slot[i][0]) ^ ReadFingerprint(slot[i][1]) ^ ReadFingerprint(slot[i][2])) == fingerprint[i];
+            }
+        }
+        return vec_indication_bit;
+    }
+
+    inline std::vector<uint8_t> ContainBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM) const
+    {
+        return PlainContainBatch(input, ITEM_LEN, ITEM_NUM);
+    }
+
+    inline std::vector<uint8_t> ContainBatch(const block* input, size_t ITEM_NUM) const
+    {
+        return PlainContainBatch(reinterpret_cast<const uint8_t*>(input), sizeof(block), ITEM_NUM);
+    }
+
+    inline std::vector<uint8_t> ContainBatch(const EC25519Point* input, size_t ITEM_NUM) const
+    {
+        return PlainContainBatch(reinterpret_cast<const uint8_t*>(input), 32, ITEM_NUM);
+    }
+
+    inline std::vector<uint8_t> Contain(const std::vector<block> &vec_A) const
+    {
+        return ContainBatch(vec_A.data(), vec_A.size());
+    }
+
+    inline std::vector<uint8_t> Contain(const std::vector<EC25519Point> &vec_A) const
+    {
+        return ContainBatch(vec_A.data(), vec_A.size());
+    }
+
+    // write object to file
+    inline bool WriteObject(std::string file_name)
+    {
+        std::ofstream fout;
+        fout.open(file_name, std::ios::binary);
+        if(!fout){
+            std::cerr << file_name << " open error" << std::endl;
+            return false;
+        }
+        char *buffer = new char[ObjectSize()];
+        WriteObject(buffer);
+        fout.write(buffer, ObjectSize());
+        delete[] buffer;
+        fout.close();
+
+        #ifdef DEBUG
+            std::cout << "'" <<file_name << "' size = " << ObjectSize() << " bytes" << std::endl;
+        #endif
+
+        return true;
+    }
+
+    // read object from file
+    inline bool ReadObject(std::string file_name)
+    {
+        std::ifstream fin;
+        fin.open(file_name, std::ios::binary | std::ios::ate);
+        if(!fin){
+            std::cerr << file_name << " open error" << std::endl;
+            return false;
+        }
+        size_t file_size = fin.tellg();
+        fin.seekg(0);
+        char *buffer = new char[file_size];
+        fin.read(buffer, file_size);
+        bool status = ReadObject(buffer);
+        delete[] buffer;
+        return status;
+    }
+
+    // write object to buffer
+    inline bool WriteObject(char* buffer)
+    {
+        if(buffer == nullptr){
+            std::cerr << "allocate memory for binary fuse filter fails" << std::endl;
+            return false;
+        }
+        size_t offset = 0;
+        memcpy(buffer + offset, &seed, sizeof(uint64_t)); offset += sizeof(uint64_t);
+        memcpy(buffer + offset, &element_num, sizeof(uint64_t)); offset += sizeof(uint64_t);
+        memcpy(buffer + offset, &segment_length, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &segment_length_mask, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &segment_count, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &segment_count_length, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &array_length, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &fingerprint_byte_len, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, fingerprint_table.data(), size_t(array_length)*fingerprint_byte_len);
+        return true;
+    }
+
+    // read object from buffer
+    inline bool ReadObject(char* buffer)
+    {
+        if(buffer == nullptr){
+            std::cerr << "allocate memory for binary fuse filter fails" << std::endl;
+            return false;
+        }
+        size_t offset = 0;
+        memcpy(&seed, buffer + offset, sizeof(uint64_t)); offset += sizeof(uint64_t);
+        memcpy(&element_num, buffer + offset, sizeof(uint64_t)); offset += sizeof(uint64_t);
+        memcpy(&segment_length, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&segment_length_mask, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&segment_count, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&segment_count_length, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&array_length, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&fingerprint_byte_len, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        fingerprint_table.assign(size_t(array_length)*fingerprint_byte_len + 8, 0);
+        memcpy(fingerprint_table.data(), buffer + offset, size_t(array_length)*fingerprint_byte_len);
+        return true;
+    }
+
+    void PrintInfo() const{
+        PrintSplitLine('-');
+        std::cout << "BinaryFuseFilter Status:" << std::endl;
+        std::cout << "inserted element num = " << element_num << std::endl;
+        std::cout << "fingerprint length = " << 8*fingerprint_byte_len << " bits" << std::endl;
+        std::cout << "hashtable size = " << ((size_t(array_length)*fingerprint_byte_len) >> 10) << " KB" << std::endl;
+        std::cout << "bits per element = " << double(array_length)*fingerprint_byte_len*8/element_num << std::endl;
+        PrintSplitLine('-');
+    }
+};
+
+#endif
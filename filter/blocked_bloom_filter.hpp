@@ -0,0 +1,419 @@
+/*
+** Split-block Bloom filter, following "Cache-, Hash- and Space-Efficient Bloom Filters" (Putze, Sanders and Singler, WEA 2007)
+** and the split-block layout of Apache Parquet/Impala
+** (1) each element touches a single 64-byte block, i.e., one cache line, instead of hash_num random positions
+** (2) the block is split into 16 32-bit lanes, the probe masks are derived from one 128-bit hash with AVX2 multiply-shift
+** (3) add serialize/deserialize interfaces
+*/
+
+#ifndef KUNLUN_BLOCKED_BLOOM_FILTER_HPP
+#define KUNLUN_BLOCKED_BLOOM_FILTER_HPP
+
+#include "../include/std.inc"
+#include "../utility/serialization.hpp"
+#include "../utility/murmurhash3.hpp"
+#include "../utility/print.hpp"
+#include "../crypto/block.hpp"
+#include "../crypto/ec_point.hpp"
+#include "../crypto/ec_25519.hpp"
+
+/*
+** an element is compressed to a 128-bit digest:
+** the low 64 bits pick the block by multiply-shift range reduction (no modulo, block_num needs not be a power of two),
+** the high 64 bits give h1, h2, and round t sets one bit in each of the 8 lanes of half (t mod 2) of the block,
+** at position (h1 + t*h2) * salt[j] >> 27 for lane j; hence hash_num = 8*round_num bits per element
+**
+** the false positive probability is no longer (1-e^{-kn/m})^k, since the load of a block varies:
+** with load L, a lane receiving b bits per element is set at a given position w.p. 1-(1-1/32)^{bL}, so
+** FPR = sum_L Poisson(L; n/block_num) * prod_{half} (1-(1-1/32)^{b_half*L})^{8*b_half}
+** the constructor searches round_num and the largest load per block that keep FPR below 2^{-lambda};
+** the price of a single cache miss is space: about 165 bits per element for lambda = 40 (versus 1.44*lambda = 58),
+** the gap shrinks for smaller lambda, e.g., about 39 bits per element for lambda = 20 (versus 29)
+*/
+
+inline const uint32_t blocked_bloom_salt[8] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                                              0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+
+struct alignas(64) BloomBlock{
+    uint32_t word[16]; // lanes 0-7 form the first half, lanes 8-15 the second half
+};
+
+class BlockedBloomFilter{
+public:
+    uint32_t random_seed; // seed of the digest
+    uint32_t round_num; // hash_num = 8*round_num
+    uint32_t block_num;
+    std::vector<BloomBlock> block_table;
+
+    size_t projected_element_num;
+    size_t inserted_element_num;
+
+    BlockedBloomFilter() {};
+
+    BlockedBloomFilter(size_t max_element_num, size_t statistical_security_parameter)
+    {
+        random_seed = fixed_salt32;
+        double target = pow(2, -double(statistical_security_parameter));
+
+        // for every round_num, bisect the largest average load that meets the target, then keep the best one
+        double best_load = 0;
+        for(uint32_t r = 1; r <= 16; r++){
+            double low = 0, high = 64;
+            for(auto i = 0; i < 60; i++){
+                double mid = (low + high)/2;
+                if(FalsePositiveProbability(mid, r) <= target) low = mid;
+                else high = mid;
+            }
+            if(low > best_load){
+                best_load = low;
+                round_num = r;
+            }
+        }
+        block_num = std::max<uint32_t>(1, uint32_t(ceil(double(max_element_num)/best_load)));
+        block_table.assign(block_num, BloomBlock());
+        projected_element_num = max_element_num;
+        inserted_element_num = 0;
+    }
+
+    ~BlockedBloomFilter() {};
+
+    // load = average number of elements per block
+    static double FalsePositiveProbability(double load, uint32_t round_num)
+    {
+        double bit_per_lane[2] = {double((round_num + 1)/2), double(round_num/2)};
+        double fpr = 0;
+        double poisson = exp(-load); // Pr[L = 0]
+        for(size_t L = 0; L < 64*16; L++){
+            double fpr_L = 1;
+            for(auto h = 0; h < 2; h++){
+                fpr_L *= pow(1 - pow(1 - 1.0/32, bit_per_lane[h]*L), 8*bit_per_lane[h]);
+            }
+            fpr += poisson*fpr_L;
+            poisson *= load/(L + 1);
+            if(L > load && poisson < 1e-300) break;
+        }
+        return fpr;
+    }
+
+    size_t ObjectSize()
+    {
+        // random_seed + round_num + block_num + projected_element_num + inserted_element_num + table_content
+        return 3*sizeof(uint32_t) + 2*sizeof(size_t) + size_t(block_num)*sizeof(BloomBlock);
+    }
+
+    inline block PlainDigest(const void* input, size_t LEN) const
+    {
+        block digest;
+        MurmurHash3_x64_128(input, static_cast<int>(LEN), random_seed, &digest);
+        return digest;
+    }
+
+    template <typename ElementType> // Note: T must be a C++ POD type.
+    inline block Digest(const ElementType& element) const
+    {
+        return PlainDigest(&element, sizeof(ElementType));
+    }
+
+    inline block Digest(const std::string& str) const
+    {
+        return PlainDigest(str.data(), str.size());
+    }
+
+    inline block Digest(const ECPoint &A) const
+    {
+        int thread_num = omp_get_thread_num();
+        #ifdef ECPOINT_COMPRESSED
+            unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
+            EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+            return PlainDigest(buffer, POINT_COMPRESSED_BYTE_LEN);
+        #else
+            unsigned char buffer[POINT_BYTE_LEN];
+            EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, bn_ctx[thread_num]);
+            return PlainDigest(buffer, POINT_BYTE_LEN);
+        #endif
+    }
+
+    inline block Digest(const EC25519Point &A) const
+    {
+        return PlainDigest(A.px, 32);
+    }
+
+    inline uint32_t BlockIndex(const block &digest) const
+    {
+        uint64_t word[2];
+        memcpy(word, &digest, sizeof(block));
+        return uint32_t(((unsigned __int128)word[0] * block_num) >> 64);
+    }
+
+    // the 16 lane masks of an element: mask[j] has round_num/2 or so bits set
+    inline void ComputeMask(const block &digest, uint32_t mask[16]) const
+    {
+        uint64_t word[2];
+        memcpy(word, &digest, sizeof(block));
+        uint32_t h1 = uint32_t(word[1]);
+        uint32_t h2 = uint32_t(word[1] >> 32) | 1;
+        memset(mask, 0, 16*sizeof(uint32_t));
+        for(auto t = 0; t < round_num; t++){
+            uint32_t h = h1 + t*h2;
+            uint32_t *half_mask = mask + 8*(t & 1);
+            for(auto j = 0; j < 8; j++) half_mask[j] |= uint32_t(1) << ((h*blocked_bloom_salt[j]) >> 27);
+        }
+    }
+
+    __attribute__((target("avx2")))
+    inline void ComputeMaskAVX2(const block &digest, __m256i &mask_lo, __m256i &mask_hi) const
+    {
+        uint64_t word[2];
+        memcpy(word, &digest, sizeof(block));
+        uint32_t h1 = uint32_t(word[1]);
+        uint32_t h2 = uint32_t(word[1] >> 32) | 1;
+        const __m256i salt = _mm256_loadu_si256((const __m256i*)blocked_bloom_salt);
+        const __m256i one = _mm256_set1_epi32(1);
+        mask_lo = _mm256_setzero_si256();
+        mask_hi = _mm256_setzero_si256();
+        for(auto t = 0; t < round_num; t++){
+            __m256i h = _mm256_mullo_epi32(_mm256_set1_epi32(h1 + t*h2), salt);
+            __m256i mask = _mm256_sllv_epi32(one, _mm256_srli_epi32(h, 27));
+            if(t & 1) mask_hi = _mm256_or_si256(mask_hi, mask);
+            else mask_lo = _mm256_or_si256(mask_lo, mask);
+        }
+    }
+
+    static inline bool HasAVX2()
+    {
+        static const bool has_avx2 = __builtin_cpu_supports("avx2");
+        return has_avx2;
+    }
+
+    __attribute__((target("avx2")))
+    inline void InsertDigestAVX2(const block &digest)
+    {
+        __m256i mask_lo, mask_hi;
+        ComputeMaskAVX2(digest, mask_lo, mask_hi);
+        __m256i *ptr = reinterpret_cast<__m256i*>(block_table[BlockIndex(digest)].word);
+        _mm256_store_si256(ptr, _mm256_or_si256(_mm256_load_si256(ptr), mask_lo));
+        _mm256_store_si256(ptr + 1, _mm256_or_si256(_mm256_load_si256(ptr + 1), mask_hi));
+    }
+
+    __attribute__((target("avx2")))
+    inline bool ContainDigestAVX2(const block &digest) const
+    {
+        __m256i mask_lo, mask_hi;
+        ComputeMaskAVX2(digest, mask_lo, mask_hi);
+        const __m256i *ptr = reinterpret_cast<const __m256i*>(block_table[BlockIndex(digest)].word);
+        // testc returns 1 iff all bits of the mask are set in the block
+        return _mm256_testc_si256(_mm256_load_si256(ptr), mask_lo) & _mm256_testc_si256(_mm256_load_si256(ptr + 1), mask_hi);
+    }
+
+    // set the bits of digest in its block without counting it
+    inline void SetDigestBits(const block &digest)
+    {
+        if(HasAVX2()) InsertDigestAVX2(digest);
+        else{
+            uint32_t mask[16];
+            ComputeMask(digest, mask);
+            uint32_t *word = block_table[BlockIndex(digest)].word;
+            for(auto j = 0; j < 16; j++) word[j] |= mask[j];
+        }
+    }
+
+    // not thread-safe: concurrent inserts into the same block may lose bits, use Insert(container) instead
+    inline void InsertDigest(const block &digest)
+    {
+        SetDigestBits(digest);
+        inserted_element_num++;
+    }
+
+    inline bool ContainDigest(const block &digest) const
+    {
+        if(HasAVX2()) return ContainDigestAVX2(digest);
+        uint32_t mask[16];
+        ComputeMask(digest, mask);
+        const uint32_t *word = block_table[BlockIndex(digest)].word;
+        for(auto j = 0; j < 16; j++){
+            if((word[j] & mask[j]) != mask[j]) return false;
+        }
+        return true;
+    }
+
+    template <typename ElementType>
+    inline void Insert(const ElementType& element)
+    {
+        InsertDigest(Digest(element));
+    }
+
+    /*
+    ** the block range is split into THREAD_NUM stripes, and the digests are grouped by stripe with a parallel counting sort:
+    ** thread t counts the stripes of its own slice of digests, a prefix sum gives every (slice, stripe) pair its offset,
+    ** and thread t scatters its slice; then thread s inserts the digests of stripe s, so that no two threads write the same block
+    ** every pass is O(n/THREAD_NUM) per thread, at the price of one extra copy of the digests
+    */
+    inline void InsertDigest(const std::vector<block> &vec_digest)
+    {
+        size_t THREAD_NUM = std::max<size_t>(1, std::min<size_t>(NUMBER_OF_THREADS, block_num));
+        if(THREAD_NUM == 1){
+            for(auto i = 0; i < vec_digest.size(); i++) SetDigestBits(vec_digest[i]);
+            inserted_element_num += vec_digest.size();
+            return;
+        }
+        size_t LEN = vec_digest.size();
+        size_t STRIPE_LEN = (size_t(block_num) + THREAD_NUM - 1)/THREAD_NUM;
+        size_t SLICE_LEN = (LEN + THREAD_NUM - 1)/THREAD_NUM;
+
+        // offset[t*THREAD_NUM + s] = number of digests of slice t that fall in stripe s, then where they go
+        std::vector<size_t> offset(THREAD_NUM*THREAD_NUM, 0);
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto t = 0; t < THREAD_NUM; t++){
+            for(auto i = t*SLICE_LEN; i < std::min(LEN, (t+1)*SLICE_LEN); i++){
+                offset[t*THREAD_NUM + BlockIndex(vec_digest[i])/STRIPE_LEN]++;
+            }
+        }
+        // stripe s occupies [stripe_begin[s], stripe_begin[s+1]), and inside it slice t comes before slice t+1
+        std::vector<size_t> stripe_begin(THREAD_NUM + 1, 0);
+        size_t sum = 0;
+        for(auto s = 0; s < THREAD_NUM; s++){
+            stripe_begin[s] = sum;
+            for(auto t = 0; t < THREAD_NUM; t++){
+                size_t count = offset[t*THREAD_NUM + s];
+                offset[t*THREAD_NUM + s] = sum;
+                sum += count;
+            }
+        }
+        stripe_begin[THREAD_NUM] = sum;
+
+        std::vector<block> vec_sorted_digest(LEN);
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto t = 0; t < THREAD_NUM; t++){
+            for(auto i = t*SLICE_LEN; i < std::min(LEN, (t+1)*SLICE_LEN); i++){
+                vec_sorted_digest[offset[t*THREAD_NUM + BlockIndex(vec_digest[i])/STRIPE_LEN]++] = vec_digest[i];
+            }
+        }
+
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto s = 0; s < THREAD_NUM; s++){
+            for(auto i = stripe_begin[s]; i < stripe_begin[s+1]; i++) SetDigestBits(vec_sorted_digest[i]);
+        }
+        inserted_element_num += LEN;
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline void Insert(const Container<T, Allocator>& container)
+    {
+        std::vector<block> vec_digest(container.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < container.size(); i++){
+            vec_digest[i] = Digest(container[i]);
+        }
+        InsertDigest(vec_digest);
+    }
+
+    template <typename ElementType>
+    inline bool Contain(const ElementType& element) const
+    {
+        return ContainDigest(Digest(element));
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline std::vector<uint8_t> Contain(const Container<T, Allocator>& container) const
+    {
+        std::vector<uint8_t> vec_indication_bit(container.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < container.size(); i++){
+            vec_indication_bit[i] = ContainDigest(Digest(container[i]));
+        }
+        return vec_indication_bit;
+    }
+
+    inline void Clear()
+    {
+        std::fill(block_table.begin(), block_table.end(), BloomBlock());
+        inserted_element_num = 0;
+    }
+
+    // write object to file
+    inline bool WriteObject(std::string file_name)
+    {
+        std::ofstream fout;
+        fout.open(file_name, std::ios::binary);
+        if(!fout){
+            std::cerr << file_name << " open error" << std::endl;
+            return false;
+        }
+        char *buffer = new char[ObjectSize()];
+        WriteObject(buffer);
+        fout.write(buffer, ObjectSize());
+        delete[] buffer;
+        fout.close();
+
+        #ifdef DEBUG
+            std::cout << "'" <<file_name << "' size = " << ObjectSize() << " bytes" << std::endl;
+        #endif
+
+        return true;
+    }
+
+    // read object from file
+    inline bool ReadObject(std::string file_name)
+    {
+        std::ifstream fin;
+        fin.open(file_name, std::ios::binary | std::ios::ate);
+        if(!fin){
+            std::cerr << file_name << " open error" << std::endl;
+            return false;
+        }
+        size_t file_size = fin.tellg();
+        fin.seekg(0);
+        char *buffer = new char[file_size];
+        fin.read(buffer, file_size);
+        bool status = ReadObject(buffer);
+        delete[] buffer;
+        return status;
+    }
+
+    // write object to buffer
+    inline bool WriteObject(char* buffer)
+    {
+        if(buffer == nullptr){
+            std::cerr << "allocate memory for blocked bloom filter fails" << std::endl;
+            return false;
+        }
+        size_t offset = 0;
+        memcpy(buffer + offset, &random_seed, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &round_num, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &block_num, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &projected_element_num, sizeof(size_t)); offset += sizeof(size_t);
+        memcpy(buffer + offset, &inserted_element_num, sizeof(size_t)); offset += sizeof(size_t);
+        memcpy(buffer + offset, block_table.data(), size_t(block_num)*sizeof(BloomBlock));
+        return true;
+    }
+
+    // read object from buffer
+    inline bool ReadObject(char* buffer)
+    {
+        if(buffer == nullptr){
+            std::cerr << "allocate memory for blocked bloom filter fails" << std::endl;
+            return false;
+        }
+        size_t offset = 0;
+        memcpy(&random_seed, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&round_num, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&block_num, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&projected_element_num, buffer + offset, sizeof(size_t)); offset += sizeof(size_t);
+        memcpy(&inserted_element_num, buffer + offset, sizeof(size_t)); offset += sizeof(size_t);
+        block_table.resize(block_num);
+        memcpy(block_table.data(), buffer + offset, size_t(block_num)*sizeof(BloomBlock));
+        return true;
+    }
+
+    void PrintInfo() const{
+        PrintSplitLine('-');
+        std::cout << "BlockedBloomFilter Status:" << std::endl;
+        std::cout << "inserted element num = " << inserted_element_num << std::endl;
+        std::cout << "hash num = " << 8*round_num << " (in one 64-byte block)" << std::endl;
+        std::cout << "hashtable size = " << ((size_t(block_num)*sizeof(BloomBlock)) >> 10) << " KB" << std::endl;
+        std::cout << "bits per element = " << double(block_num)*sizeof(BloomBlock)*8/inserted_element_num << std::endl;
+        PrintSplitLine('-');
+    }
+};
+
+#endif
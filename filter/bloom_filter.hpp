@@ -2,6 +2,12 @@
 ** Modified from https://github.com/ArashPartow/bloom
 ** (1) simplify the design
 ** (2) add serialize/deserialize interfaces
+** (3) add batch interfaces over contiguous keys: bit positions are computed for a window of keys and prefetched,
+**     batch insert writes the table in disjoint partitions, one per thread, so that no atomic operation is needed
+** (4) derive the hash_num salted hashes of a key in one multi-lane pass of the keyed hash
+** (5) add memory-mapped files: the bit table of a mapped filter is queried in place from a read-only mapping
+** (6) add compressed serialization following "Compressed Bloom Filters" (Mitzenmacher, ToN 2002):
+**     a sparser table with fewer hash functions, whose set-bit positions are Golomb-Rice coded per chunk
 */
 
 #ifndef KUNLUN_BLOOM_FILTER_HPP
@@ -12,12 +18,35 @@
 #include "../crypto/ec_point.hpp" // cause we need to insert EC Point to filter
 #include "../crypto/ec_25519.hpp"
 #include "../utility/murmurhash3.hpp"
+#include "../utility/mapped_file.hpp"
+#include "../utility/golomb_coding.hpp"
 
 //00000001 00000010 00000100 00001000 00010000 00100000 01000000 10000000
 inline const uint8_t bit_mask[8] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80};
 
+// number of keys whose bit positions are computed and prefetched before the table is touched
+inline const size_t BLOOM_BATCH_WINDOW = 16; 
+// number of hash functions evaluated per key in the first pass of batch contain: half of the bits are set, so most missing keys die here
+inline const size_t BLOOM_BATCH_FIRST_PROBE = 2; 
+// number of hash functions evaluated per key in each later pass of batch contain
+inline const size_t BLOOM_BATCH_PROBE = 8; 
+// batch contain prefetches only for tables larger than this, smaller tables stay in cache and the plain loop is faster
+inline const size_t BLOOM_BATCH_PREFETCH_BYTES = size_t(1) << 21; 
+// number of keys bucketed per round of batch insert, bounds the memory of the bucketed bit positions
+inline const size_t BLOOM_BATCH_ROUND = size_t(1) << 14; 
+// number of salted hashes derived per call of the multi-salt hash, a multiple of BLOOM_BATCH_PROBE and BLOOM_BATCH_FIRST_PROBE
+inline const size_t BLOOM_HASH_GROUP = 16; 
+
+// magic of the memory-mapped file, see WriteMappedObject
+inline const char BLOOM_FILTER_MAGIC[8] = "KLBLOOM"; 
+// number of table bits per independently coded chunk of the compressed form, a multiple of 8
+inline const size_t BLOOM_COMPRESS_CHUNK = size_t(1) << 20; 
+// largest hash_num of the fixed hash_num constructor and of a compressed filter, well above lambda = 40 used throughout
+inline const size_t BLOOM_MAX_HASH_NUM = 128; 
+
 // selection of keyed hash for bloom filter
 #define FastKeyedHash LiteMurmurHash // an alternative choice is MurmurHash3 
+#define FastKeyedHashMultiSalt LiteMurmurHashMultiSalt // must compute the same function as FastKeyedHash
 
 /*
   Note:A distinct hash function need not be implementation-wise distinct. 
@@ -67,6 +96,13 @@ std::vector<uint32_t> GenUniqueSaltVector(size_t hash_num, uint32_t random_seed)
    return vec_salt; 
 }
 
+// parameters of the compressed form, see BloomFilter::WriteCompressedObject
+struct CompressedBloomHeader{
+   uint32_t rice_param; 
+   std::vector<uint32_t> vec_chunk_byte_len; // coded bytes of each chunk
+   std::vector<uint32_t> vec_chunk_one_num; // set bits of each chunk
+}; 
+
 class BloomFilter{
 public:
    uint32_t random_seed; // used to generate vec_salt
@@ -79,6 +115,10 @@ public:
     
    size_t projected_element_num; // n
    size_t inserted_element_num;
+
+   // set by MapObject: the bit table is read in place from the mapping and bit_table stays empty
+   std::shared_ptr<MappedFile::Mapping> mapping; 
+   const uint8_t* mapped_table = nullptr; 
 /*
   find the number of hash functions and minimum amount of storage bits required 
   to construct a bloom filter consistent with the user defined false positive probability
@@ -103,6 +143,33 @@ BloomFilter(size_t max_element_num, size_t statistical_security_parameter)
    inserted_element_num = 0; 
 }
 
+/*
+** fix hash_num instead of letting it equal the statistical security parameter: 
+** the table grows to m = -k*n/ln(1 - 2^{-lambda/k}) bits so that the false positive probability stays 2^{-lambda}, 
+** a small k gives a sparse table that compresses well, e.g. k = lambda/5 sends about 13% fewer bits than the standard filter
+*/
+BloomFilter(size_t max_element_num, size_t statistical_security_parameter, size_t hash_num)
+{
+   if(hash_num == 0 || hash_num > BLOOM_MAX_HASH_NUM){
+      std::cerr << "bloom filter takes 1 to " << BLOOM_MAX_HASH_NUM << " hash functions" << std::endl;
+      exit(1); // EXIT_FAILURE
+   }
+   double table_bits = -double(hash_num) * max_element_num / log1p(-pow(2, -double(statistical_security_parameter)/hash_num)); 
+   if(table_bits > double(UINT32_MAX - 0x07)){
+      std::cerr << "bloom filter with " << hash_num << " hash functions exceeds 2^32 bits" << std::endl;
+      exit(1); // EXIT_FAILURE
+   }
+   this->hash_num = hash_num; 
+   random_seed = static_cast<uint32_t>(0xA5A5A5A55A5A5A5A * 0xA5A5A5A5 + 1); 
+   vec_salt = GenUniqueSaltVector(hash_num, random_seed);   
+   table_size = static_cast<uint32_t>(ceil(table_bits));
+   table_size = ((table_size+0x07) >> 3) << 3; // (table_size+7)/8*8
+
+   bit_table.resize(table_size/8, static_cast<uint8_t>(0x00)); 
+   projected_element_num = max_element_num;
+   inserted_element_num = 0; 
+}
+
 ~BloomFilter() {}; 
 
 size_t ObjectSize()
@@ -115,24 +182,124 @@ size_t ObjectSize()
 }
 
 
-inline void PlainInsert(const void* input, size_t LEN)
+inline const uint8_t* Table() const
 {
-   size_t bit_index[hash_num];
+   return mapped_table != nullptr ? mapped_table : bit_table.data(); 
+}
 
-   #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-   for (auto i = 0; i < hash_num; i++){
-      bit_index[i] = FastKeyedHash(vec_salt[i], input, LEN) % table_size;    
-      #pragma omp atomic // atomic operation
-      bit_table[bit_index[i] >> 3] |= bit_mask[bit_index[i] & 0x07]; 
+// a mapped filter is read-only
+inline void AssertWritable() const
+{
+   if(mapped_table != nullptr){
+      std::cerr << "cannot modify a memory-mapped bloom filter" << std::endl;
+      exit(1); // EXIT_FAILURE
+   }
+}
+
+// thread-safe: bits are set with atomic operations, so it can be called inside a parallel loop
+inline void PlainInsert(const void* input, size_t LEN)
+{
+   AssertWritable(); 
+   uint32_t digest[BLOOM_HASH_GROUP]; 
+   for (size_t BEGIN = 0; BEGIN < hash_num; BEGIN += BLOOM_HASH_GROUP){
+      size_t GROUP_LEN = std::min<size_t>(BLOOM_HASH_GROUP, hash_num - BEGIN); 
+      FastKeyedHashMultiSalt(vec_salt.data() + BEGIN, GROUP_LEN, input, LEN, digest); 
+      for (auto i = 0; i < GROUP_LEN; i++){
+         size_t bit_index = digest[i] % table_size;    
+         #pragma omp atomic // atomic operation
+         bit_table[bit_index >> 3] |= bit_mask[bit_index & 0x07]; 
+      }
    }
    #pragma omp atomic
    inserted_element_num++;
 }
 
+/*
+** insert ITEM_NUM keys of ITEM_LEN bytes stored contiguously
+** the keys are processed in rounds: each thread hashes its slice of the round and buckets the bit positions
+** by the table partition they fall in, then each thread sets the bits of its own partition without atomics
+*/
+inline void PlainInsertBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM)
+{
+   AssertWritable(); 
+   size_t THREAD_NUM = NUMBER_OF_THREADS; 
+   size_t TABLE_BYTE_LEN = table_size/8; 
+
+   if(THREAD_NUM == 1){
+      std::vector<uint32_t> bit_index(BLOOM_BATCH_WINDOW*hash_num); 
+      for(size_t BEGIN = 0; BEGIN < ITEM_NUM; BEGIN += BLOOM_BATCH_WINDOW){
+         size_t LEN = std::min(BLOOM_BATCH_WINDOW, ITEM_NUM - BEGIN); 
+         for(auto i = 0; i < LEN; i++){
+            FastKeyedHashMultiSalt(vec_salt.data(), hash_num, input + (BEGIN+i)*ITEM_LEN, ITEM_LEN, bit_index.data() + i*hash_num); 
+         }
+         for(auto i = 0; i < LEN*hash_num; i++){
+            bit_index[i] %= table_size; 
+            __builtin_prefetch(bit_table.data() + (bit_index[i] >> 3), 1); 
+         }
+         for(auto i = 0; i < LEN*hash_num; i++){
+            bit_table[bit_index[i] >> 3] |= bit_mask[bit_index[i] & 0x07]; 
+         }
+      }
+      inserted_element_num += ITEM_NUM; 
+      return; 
+   }
+
+   // bucket[t*THREAD_NUM+p] holds the bit positions computed by thread t that fall in partition p
+   std::vector<std::vector<uint32_t>> bucket(THREAD_NUM*THREAD_NUM); 
+   for(size_t BEGIN = 0; BEGIN < ITEM_NUM; BEGIN += BLOOM_BATCH_ROUND){
+      size_t ROUND_LEN = std::min(BLOOM_BATCH_ROUND, ITEM_NUM - BEGIN); 
+
+      #pragma omp parallel for num_threads(THREAD_NUM)
+      for(auto t = 0; t < THREAD_NUM; t++){
+         size_t SLICE_BEGIN = BEGIN + ROUND_LEN*t/THREAD_NUM; 
+         size_t SLICE_END = BEGIN + ROUND_LEN*(t+1)/THREAD_NUM; 
+         std::vector<uint32_t> digest(hash_num); 
+         for(auto i = SLICE_BEGIN; i < SLICE_END; i++){
+            FastKeyedHashMultiSalt(vec_salt.data(), hash_num, input + i*ITEM_LEN, ITEM_LEN, digest.data()); 
+            for(auto j = 0; j < hash_num; j++){
+               uint32_t bit_index = digest[j] % table_size; 
+               size_t partition = uint64_t(bit_index >> 3)*THREAD_NUM/TABLE_BYTE_LEN; 
+               bucket[t*THREAD_NUM+partition].emplace_back(bit_index); 
+            }
+         }
+      }
+
+      #pragma omp parallel for num_threads(THREAD_NUM)
+      for(auto p = 0; p < THREAD_NUM; p++){
+         for(auto t = 0; t < THREAD_NUM; t++){
+            std::vector<uint32_t> &bit_index = bucket[t*THREAD_NUM+p]; 
+            for(auto i = 0; i < bit_index.size(); i++){
+               if(i + BLOOM_BATCH_WINDOW < bit_index.size()){
+                  __builtin_prefetch(bit_table.data() + (bit_index[i+BLOOM_BATCH_WINDOW] >> 3), 1); 
+               }
+               bit_table[bit_index[i] >> 3] |= bit_mask[bit_index[i] & 0x07]; 
+            }
+            bit_index.clear(); 
+         }
+      }
+   }
+   inserted_element_num += ITEM_NUM; 
+}
+
+inline void InsertBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM)
+{
+   PlainInsertBatch(input, ITEM_LEN, ITEM_NUM);
+}
+
+inline void InsertBatch(const block* input, size_t ITEM_NUM)
+{
+   PlainInsertBatch(reinterpret_cast<const uint8_t*>(input), sizeof(block), ITEM_NUM);
+}
+
+inline void InsertBatch(const EC25519Point* input, size_t ITEM_NUM)
+{
+   PlainInsertBatch(reinterpret_cast<const uint8_t*>(input), 32, ITEM_NUM);
+}
+
 template <typename ElementType> // Note: T must be a C++ POD type.
 inline void Insert(const ElementType& element)
 {
-   ParallelPlainInsert(&element, sizeof(ElementType));
+   PlainInsert(&element, sizeof(ElementType));
 }
 
 // specialize for string
@@ -186,39 +353,135 @@ inline void Insert(const Container<T, Allocator>& container)
    }
 }
 
+// serialize points to a contiguous buffer, so that they go through the batch interfaces
+inline size_t SerializePoints(const std::vector<ECPoint> &vec_A, std::vector<uint8_t> &buffer) const
+{
+   #ifdef ECPOINT_COMPRESSED
+      size_t ITEM_LEN = POINT_COMPRESSED_BYTE_LEN; 
+      point_conversion_form_t form = POINT_CONVERSION_COMPRESSED; 
+   #else
+      size_t ITEM_LEN = POINT_BYTE_LEN; 
+      point_conversion_form_t form = POINT_CONVERSION_UNCOMPRESSED; 
+   #endif
+   buffer.assign(ITEM_LEN*vec_A.size(), 0); 
+   #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+   for(auto i = 0; i < vec_A.size(); i++){
+      EC_POINT_point2oct(group, vec_A[i].point_ptr, form, buffer.data() + i*ITEM_LEN, ITEM_LEN, bn_ctx[omp_get_thread_num()]);
+   }
+   return ITEM_LEN; 
+}
+
 // specialize for vector<ECPoint>
 #ifdef IS_MACOS
 template <> 
 #endif
 inline void Insert(const std::vector<ECPoint> &vec_A)
 {   
-   //sequential implementation
-   #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-   for(auto i = 0; i < vec_A.size(); i++){
-      Insert(vec_A[i]); 
-   }
+   std::vector<uint8_t> buffer; 
+   size_t ITEM_LEN = SerializePoints(vec_A, buffer); 
+   PlainInsertBatch(buffer.data(), ITEM_LEN, vec_A.size()); 
+}
+
+inline void Insert(const std::vector<block> &vec_A)
+{   
+   InsertBatch(vec_A.data(), vec_A.size()); 
 }
 
 
 inline bool PlainContain(const void* input, size_t LEN) const
 {
-   bool CONTAIN = true; // assume input in filter at the beginning
-   std::vector<size_t> bit_index(hash_num);
-   std::vector<size_t> local_bit_index(hash_num); 
+   const uint8_t* table = Table(); 
+   uint32_t digest[BLOOM_HASH_GROUP]; 
+   for(size_t BEGIN = 0; BEGIN < hash_num; BEGIN += BLOOM_HASH_GROUP){
+      size_t GROUP_LEN = std::min<size_t>(BLOOM_HASH_GROUP, hash_num - BEGIN); 
+      FastKeyedHashMultiSalt(vec_salt.data() + BEGIN, GROUP_LEN, input, LEN, digest); 
+      for(auto i = 0; i < GROUP_LEN; i++){
+         size_t bit_index = digest[i] % table_size; 
+         if ((table[bit_index >> 3] & bit_mask[bit_index & 0x07]) == 0) return false;
+      }
+   }
+   return true;
+}
+
+/*
+** query ITEM_NUM keys of ITEM_LEN bytes stored contiguously
+** a table that fits in cache gains nothing from prefetching, so it is queried key by key as PlainContain does
+** otherwise, for a window of keys, the bit positions of the next pass of every key still alive are prefetched, then tested:
+** the first pass tests BLOOM_BATCH_FIRST_PROBE positions, which rejects most missing keys, later passes BLOOM_BATCH_PROBE
+** keys still alive are kept in a compacted list, and their salted hashes are derived BLOOM_HASH_GROUP at a time
+*/
+inline std::vector<uint8_t> PlainContainBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM) const
+{
+   std::vector<uint8_t> vec_indication_bit(ITEM_NUM); 
+   if(table_size/8 <= BLOOM_BATCH_PREFETCH_BYTES){
+      #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+      for(auto i = 0; i < ITEM_NUM; i++){
+         vec_indication_bit[i] = PlainContain(input + i*ITEM_LEN, ITEM_LEN); 
+      }
+      return vec_indication_bit; 
+   }
+
+   size_t WINDOW_NUM = (ITEM_NUM + BLOOM_BATCH_WINDOW - 1)/BLOOM_BATCH_WINDOW; 
+   const uint8_t* table = Table(); 
+
    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-   for(auto i = 0; i < hash_num; i++)
-   {
-      if(CONTAIN == true)
-      {
-         bit_index[i] = FastKeyedHash(vec_salt[i], input, LEN) % table_size; 
-         local_bit_index[i] = bit_index[i] & 0x07;  // bit_index mod 8
-         if ((bit_table[bit_index[i] >> 3] & bit_mask[local_bit_index[i]]) != bit_mask[local_bit_index[i]])
-         { 
-            CONTAIN  = false;
+   for(auto w = 0; w < WINDOW_NUM; w++){
+      size_t BEGIN = w*BLOOM_BATCH_WINDOW; 
+      size_t LEN = std::min(BLOOM_BATCH_WINDOW, ITEM_NUM - BEGIN); 
+      uint32_t digest[BLOOM_BATCH_WINDOW][BLOOM_HASH_GROUP]; 
+      uint32_t bit_index[BLOOM_BATCH_WINDOW][BLOOM_BATCH_PROBE]; 
+      uint8_t alive[BLOOM_BATCH_WINDOW]; // offsets of the keys not rejected yet
+      size_t ALIVE_NUM = LEN; 
+      for(auto i = 0; i < LEN; i++) alive[i] = uint8_t(i); 
+      for(size_t PROBE_BEGIN = 0; PROBE_BEGIN < hash_num && ALIVE_NUM > 0; ){
+         size_t PROBE_LEN = std::min((PROBE_BEGIN == 0) ? BLOOM_BATCH_FIRST_PROBE : BLOOM_BATCH_PROBE, hash_num - PROBE_BEGIN); 
+         size_t GROUP_OFFSET = PROBE_BEGIN % BLOOM_HASH_GROUP; 
+         PROBE_LEN = std::min(PROBE_LEN, BLOOM_HASH_GROUP - GROUP_OFFSET); 
+         for(auto k = 0; k < ALIVE_NUM; k++){
+            size_t i = alive[k]; 
+            if(GROUP_OFFSET == 0){
+               FastKeyedHashMultiSalt(vec_salt.data() + PROBE_BEGIN, std::min<size_t>(BLOOM_HASH_GROUP, hash_num - PROBE_BEGIN), 
+                                      input + (BEGIN+i)*ITEM_LEN, ITEM_LEN, digest[i]); 
+            }
+            for(auto j = 0; j < PROBE_LEN; j++){
+               bit_index[i][j] = digest[i][GROUP_OFFSET+j] % table_size; 
+               __builtin_prefetch(table + (bit_index[i][j] >> 3)); 
+            }
+         }
+         size_t NEW_ALIVE_NUM = 0; 
+         for(auto k = 0; k < ALIVE_NUM; k++){
+            size_t i = alive[k]; 
+            bool hit = true; 
+            for(auto j = 0; j < PROBE_LEN; j++){
+               if((table[bit_index[i][j] >> 3] & bit_mask[bit_index[i][j] & 0x07]) == 0){
+                  hit = false; 
+                  break; 
+               }
+            }
+            alive[NEW_ALIVE_NUM] = uint8_t(i); 
+            NEW_ALIVE_NUM += hit; 
          }
+         ALIVE_NUM = NEW_ALIVE_NUM; 
+         PROBE_BEGIN += PROBE_LEN; 
       }
+      for(auto k = 0; k < ALIVE_NUM; k++) vec_indication_bit[BEGIN + alive[k]] = 1; 
    }
-   return CONTAIN;
+   return vec_indication_bit; 
+}
+
+inline std::vector<uint8_t> ContainBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM) const
+{
+   return PlainContainBatch(input, ITEM_LEN, ITEM_NUM);
+}
+
+inline std::vector<uint8_t> ContainBatch(const block* input, size_t ITEM_NUM) const
+{
+   return PlainContainBatch(reinterpret_cast<const uint8_t*>(input), sizeof(block), ITEM_NUM);
+}
+
+inline std::vector<uint8_t> ContainBatch(const EC25519Point* input, size_t ITEM_NUM) const
+{
+   return PlainContainBatch(reinterpret_cast<const uint8_t*>(input), 32, ITEM_NUM);
 }
 
 template <typename ElementType>
@@ -274,15 +537,14 @@ template <>
 #endif
 inline std::vector<uint8_t> Contain(const std::vector<ECPoint> &vec_A) const
 {
-   size_t LEN = vec_A.size();
-   std::vector<uint8_t> vec_indication_bit(LEN); 
+   std::vector<uint8_t> buffer; 
+   size_t ITEM_LEN = SerializePoints(vec_A, buffer); 
+   return PlainContainBatch(buffer.data(), ITEM_LEN, vec_A.size()); 
+}
 
-   #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-   for(auto i = 0; i < vec_A.size(); i++){
-      if(Contain(vec_A[i]) == true) vec_indication_bit[i] = 1;
-      else vec_indication_bit[i] = 0; 
-   }
-   return vec_indication_bit; 
+inline std::vector<uint8_t> Contain(const std::vector<block> &vec_A) const
+{
+   return ContainBatch(vec_A.data(), vec_A.size()); 
 }
 
 
@@ -305,10 +567,7 @@ template <>
 #endif
 inline void Insert(const std::vector<EC25519Point> &vec_A)
 {   
-   #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-   for(auto i = 0; i < vec_A.size(); i++){
-      Insert(vec_A[i]); 
-   }
+   InsertBatch(vec_A.data(), vec_A.size()); 
 }
 
 // specialize for EC25519Point
@@ -326,21 +585,14 @@ template <>
 #endif
 inline std::vector<uint8_t> Contain(const std::vector<EC25519Point> &vec_A) const
 {
-   size_t LEN = vec_A.size();
-   std::vector<uint8_t> vec_indication_bit(LEN); 
-
-   #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-   for(auto i = 0; i < vec_A.size(); i++){
-      if(Contain(vec_A[i]) == true) vec_indication_bit[i] = 1;
-      else vec_indication_bit[i] = 0; 
-   }
-   return vec_indication_bit; 
+   return ContainBatch(vec_A.data(), vec_A.size()); 
 }
 
 ///////////////////////////////////////////////////////////////////////////
 
 inline void Clear()
 {
+   AssertWritable(); 
    std::fill(bit_table.begin(), bit_table.end(), static_cast<uint8_t>(0x00));
    inserted_element_num = 0;
 }
@@ -360,7 +612,7 @@ inline bool WriteObject(std::string file_name)
    fout << table_size; 
    fout << projected_element_num;
    fout << inserted_element_num;  
-   fout << bit_table; 
+   fout.write(reinterpret_cast<const char*>(Table()), table_size/8); 
 
    fout.close(); 
 
@@ -390,6 +642,8 @@ inline bool ReadObject(std::string file_name)
    // re-produce vec_salt
    vec_salt = GenUniqueSaltVector(hash_num, random_seed); 
    // re-build bit_table
+   mapping.reset(); 
+   mapped_table = nullptr; 
    bit_table.resize(table_size/8, static_cast<uint8_t>(0x00));
    fin >> bit_table;
    // fin.read(reinterpret_cast<char *>(bit_table.data()), table_size/8); 
@@ -421,7 +675,7 @@ inline bool WriteObject(char* buffer)
    memcpy(buffer + offset, &inserted_element_num, sizeof(size_t));
    offset += sizeof(size_t);
       
-   memcpy(buffer + offset, bit_table.data(), table_size/8); 
+   memcpy(buffer + offset, Table(), table_size/8); 
 
    return true; 
 } 
@@ -455,18 +709,298 @@ inline bool ReadObject(char* buffer)
    vec_salt = GenUniqueSaltVector(hash_num, random_seed); 
       
    // re-build bit_table
+   mapping.reset(); 
+   mapped_table = nullptr; 
    bit_table.resize(table_size/8, static_cast<uint8_t>(0x00));      
    memcpy(bit_table.data(), buffer + offset, table_size/8); 
 
    return true; 
 } 
 
+/*
+** write object to a file that MapObject can map: | header | parameters and vec_salt | padding | bit_table |
+** bit_table starts at a page boundary
+*/
+inline bool WriteMappedObject(std::string file_name) const
+{
+   std::vector<uint8_t> parameter(3*sizeof(uint32_t) + 2*sizeof(size_t) + hash_num*sizeof(uint32_t)); 
+   size_t offset = 0; 
+
+   memcpy(parameter.data() + offset, &random_seed, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(parameter.data() + offset, &hash_num, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(parameter.data() + offset, &table_size, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(parameter.data() + offset, &projected_element_num, sizeof(size_t));
+   offset += sizeof(size_t);
+
+   memcpy(parameter.data() + offset, &inserted_element_num, sizeof(size_t));
+   offset += sizeof(size_t);
+
+   memcpy(parameter.data() + offset, vec_salt.data(), hash_num*sizeof(uint32_t)); 
+
+   return MappedFile::Write(file_name, BLOOM_FILTER_MAGIC, parameter, Table(), table_size/8); 
+}
+
+/*
+** map a file written by WriteMappedObject: only the header is read, the bit table is queried in place
+** the mapped filter is read-only, verify_checksum additionally checks the table at the cost of one pass over it
+*/
+inline bool MapObject(std::string file_name, bool verify_checksum = false)
+{
+   std::shared_ptr<MappedFile::Mapping> new_mapping = MappedFile::Open(file_name, BLOOM_FILTER_MAGIC, verify_checksum); 
+   if(new_mapping == nullptr) return false; 
+
+   const uint8_t* parameter = new_mapping->Parameter(); 
+   uint32_t new_hash_num, new_table_size; 
+   memcpy(&new_hash_num, parameter + sizeof(uint32_t), sizeof(uint32_t)); 
+   memcpy(&new_table_size, parameter + 2*sizeof(uint32_t), sizeof(uint32_t)); 
+   if(new_mapping->Header()->parameter_len != 3*sizeof(uint32_t) + 2*sizeof(size_t) + new_hash_num*sizeof(uint32_t)
+      || new_mapping->Header()->table_len != new_table_size/8){
+      std::cerr << file_name << " has inconsistent bloom filter parameters" << std::endl;
+      return false; 
+   }
+
+   size_t offset = 0; 
+
+   memcpy(&random_seed, parameter + offset, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(&hash_num, parameter + offset, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(&table_size, parameter + offset, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(&projected_element_num, parameter + offset, sizeof(size_t));
+   offset += sizeof(size_t);
+
+   memcpy(&inserted_element_num, parameter + offset, sizeof(size_t));
+   offset += sizeof(size_t);
+
+   vec_salt.resize(hash_num); 
+   memcpy(vec_salt.data(), parameter + offset, hash_num*sizeof(uint32_t)); 
+
+   std::vector<uint8_t>().swap(bit_table); 
+   mapping = new_mapping; 
+   mapped_table = mapping->Table(); 
+
+   return true; 
+}
+
+/*
+** compressed form: | parameters | rice_param | chunk_num | byte length of each chunk | set bits of each chunk | chunks |
+** the table is cut into chunks of BLOOM_COMPRESS_CHUNK bits, in each chunk the gaps between consecutive set bits
+** are Rice coded, chunks are coded and decoded independently in parallel and can be decoded as they arrive
+** a standard filter is half full and does not compress, build it with a small hash_num to benefit
+*/
+inline size_t CompressedHeaderSize(size_t chunk_num) const
+{
+   return 5*sizeof(uint32_t) + 2*sizeof(size_t) + 2*chunk_num*sizeof(uint32_t); 
+}
+
+inline bool WriteCompressedObject(std::vector<uint8_t> &buffer) const
+{
+   const uint8_t* table = Table(); 
+   size_t CHUNK_NUM = (size_t(table_size) + BLOOM_COMPRESS_CHUNK - 1)/BLOOM_COMPRESS_CHUNK; 
+
+   size_t ONE_NUM = 0; 
+   #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(+:ONE_NUM)
+   for(auto i = 0; i < table_size/8; i += 8){
+      uint64_t word = 0; 
+      memcpy(&word, table + i, std::min<size_t>(8, table_size/8 - i)); 
+      ONE_NUM += __builtin_popcountll(word); 
+   }
+   // gaps between set bits are about geometric with mean (m - ones)/(ones + 1)
+   uint32_t rice_param = GolombCoding::RiceParameter(double(table_size - ONE_NUM)/(ONE_NUM + 1)); 
+
+   std::vector<std::vector<uint8_t>> vec_chunk(CHUNK_NUM); 
+   std::vector<uint32_t> vec_chunk_one_num(CHUNK_NUM); 
+   #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+   for(auto c = 0; c < CHUNK_NUM; c++){
+      size_t BEGIN = c*BLOOM_COMPRESS_CHUNK/8; 
+      size_t END = std::min<size_t>((c+1)*BLOOM_COMPRESS_CHUNK, table_size)/8; 
+      GolombCoding::BitWriter writer; 
+      int64_t previous = -1; // position of the previous set bit in this chunk
+      uint32_t one_num = 0; 
+      // scan 8 bytes at a time, the last chunk may end with a partial word
+      for(auto i = BEGIN; i < END; i += 8){
+         uint64_t word = 0; 
+         memcpy(&word, table + i, std::min<size_t>(8, END - i)); 
+         for(; word != 0; word &= word - 1){
+            int64_t position = int64_t(i - BEGIN)*8 + __builtin_ctzll(word); 
+            writer.WriteRice(uint64_t(position - previous - 1), rice_param); 
+            previous = position; 
+            one_num++; 
+         }
+      }
+      writer.Flush(); 
+      vec_chunk[c].swap(writer.byte_vector); 
+      vec_chunk_one_num[c] = one_num; 
+   }
+
+   size_t HEADER_LEN = CompressedHeaderSize(CHUNK_NUM); 
+   size_t offset = 0; 
+   buffer.resize(HEADER_LEN); 
+   uint32_t chunk_num = CHUNK_NUM; 
+
+   memcpy(buffer.data() + offset, &random_seed, sizeof(uint32_t));
+   offset += sizeof(uint32_t);     
+
+   memcpy(buffer.data() + offset, &hash_num, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(buffer.data() + offset, &table_size, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(buffer.data() + offset, &projected_element_num, sizeof(size_t));
+   offset += sizeof(size_t);
+
+   memcpy(buffer.data() + offset, &inserted_element_num, sizeof(size_t));
+   offset += sizeof(size_t);
+
+   memcpy(buffer.data() + offset, &rice_param, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(buffer.data() + offset, &chunk_num, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   for(auto c = 0; c < CHUNK_NUM; c++){
+      uint32_t byte_len = vec_chunk[c].size(); 
+      memcpy(buffer.data() + offset, &byte_len, sizeof(uint32_t));
+      offset += sizeof(uint32_t);
+   }
+
+   memcpy(buffer.data() + offset, vec_chunk_one_num.data(), CHUNK_NUM*sizeof(uint32_t)); 
+
+   for(auto c = 0; c < CHUNK_NUM; c++){
+      buffer.insert(buffer.end(), vec_chunk[c].begin(), vec_chunk[c].end()); 
+   }
+   return true; 
+}
+
+/*
+** parse the header of the compressed form, set the parameters and allocate an empty table
+** returns the header length, or 0 if the header is malformed, in which case the filter is left untouched
+*/
+inline size_t ReadCompressedHeader(const uint8_t* buffer, size_t LEN, CompressedBloomHeader &header)
+{
+   if(buffer == nullptr || LEN < CompressedHeaderSize(0)){
+      std::cerr << "compressed bloom filter header is truncated" << std::endl;
+      return 0; 
+   }
+   size_t offset = 0; 
+   uint32_t new_random_seed, new_hash_num, new_table_size, new_rice_param, chunk_num; 
+   size_t new_projected_element_num, new_inserted_element_num; 
+
+   memcpy(&new_random_seed, buffer + offset, sizeof(uint32_t));
+   offset += sizeof(uint32_t);     
+
+   memcpy(&new_hash_num, buffer + offset, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(&new_table_size, buffer + offset, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(&new_projected_element_num, buffer + offset, sizeof(size_t));
+   offset += sizeof(size_t);
+
+   memcpy(&new_inserted_element_num, buffer + offset, sizeof(size_t));
+   offset += sizeof(size_t);
+
+   memcpy(&new_rice_param, buffer + offset, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   memcpy(&chunk_num, buffer + offset, sizeof(uint32_t));
+   offset += sizeof(uint32_t);
+
+   if(new_hash_num == 0 || new_hash_num > BLOOM_MAX_HASH_NUM 
+      || new_table_size % 8 != 0 || new_rice_param > 32
+      || chunk_num != (size_t(new_table_size) + BLOOM_COMPRESS_CHUNK - 1)/BLOOM_COMPRESS_CHUNK
+      || LEN < CompressedHeaderSize(chunk_num)){
+      std::cerr << "compressed bloom filter header is inconsistent" << std::endl;
+      return 0; 
+   }
+
+   header.rice_param = new_rice_param; 
+   header.vec_chunk_byte_len.resize(chunk_num); 
+   memcpy(header.vec_chunk_byte_len.data(), buffer + offset, chunk_num*sizeof(uint32_t)); 
+   offset += chunk_num*sizeof(uint32_t); 
+
+   header.vec_chunk_one_num.resize(chunk_num); 
+   memcpy(header.vec_chunk_one_num.data(), buffer + offset, chunk_num*sizeof(uint32_t)); 
+   offset += chunk_num*sizeof(uint32_t); 
+
+   random_seed = new_random_seed; 
+   hash_num = new_hash_num; 
+   table_size = new_table_size; 
+   projected_element_num = new_projected_element_num; 
+   inserted_element_num = new_inserted_element_num; 
+   vec_salt = GenUniqueSaltVector(hash_num, random_seed); 
+   mapping.reset(); 
+   mapped_table = nullptr; 
+   bit_table.assign(table_size/8, static_cast<uint8_t>(0x00)); 
+
+   return offset; 
+}
+
+/*
+** decode chunks [BEGIN, END) in parallel, data points to the coded bytes of chunk BEGIN
+** chunks cover disjoint bytes of the table, so any set of chunks can be decoded as soon as it is received
+*/
+inline bool ReadCompressedChunks(const CompressedBloomHeader &header, size_t BEGIN, size_t END, const uint8_t* data)
+{
+   std::vector<size_t> vec_offset(END - BEGIN + 1, 0); 
+   for(auto c = BEGIN; c < END; c++){
+      vec_offset[c-BEGIN+1] = vec_offset[c-BEGIN] + header.vec_chunk_byte_len[c]; 
+   }
+
+   bool status = true; 
+   #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(&&:status)
+   for(auto c = BEGIN; c < END; c++){
+      GolombCoding::BitReader reader(data + vec_offset[c-BEGIN], header.vec_chunk_byte_len[c]); 
+      uint8_t* chunk_table = bit_table.data() + c*BLOOM_COMPRESS_CHUNK/8; 
+      size_t CHUNK_BIT_LEN = std::min<size_t>((c+1)*BLOOM_COMPRESS_CHUNK, table_size) - c*BLOOM_COMPRESS_CHUNK; 
+      uint64_t position = 0; // position of the next candidate bit
+      for(auto i = 0; i < header.vec_chunk_one_num[c]; i++){
+         position += reader.ReadRice(header.rice_param); 
+         if(reader.exhausted || position >= CHUNK_BIT_LEN){
+            status = false; 
+            break; 
+         }
+         chunk_table[position >> 3] |= bit_mask[position & 0x07]; 
+         position++; 
+      }
+   }
+   if(status == false){
+      std::cerr << "compressed bloom filter is corrupted" << std::endl;
+   }
+   return status; 
+}
+
+inline bool ReadCompressedObject(const uint8_t* buffer, size_t LEN)
+{
+   CompressedBloomHeader header; 
+   size_t HEADER_LEN = ReadCompressedHeader(buffer, LEN, header); 
+   if(HEADER_LEN == 0) return false; 
+   size_t BODY_LEN = std::accumulate(header.vec_chunk_byte_len.begin(), header.vec_chunk_byte_len.end(), size_t(0)); 
+   if(HEADER_LEN + BODY_LEN != LEN){
+      std::cerr << "compressed bloom filter has inconsistent length" << std::endl;
+      return false; 
+   }
+   return ReadCompressedChunks(header, 0, header.vec_chunk_byte_len.size(), buffer + HEADER_LEN); 
+}
+
 void PrintInfo() const{
    PrintSplitLine('-');
    std::cout << "BloomFilter Status:" << std::endl;
    std::cout << "inserted element num = " << inserted_element_num << std::endl;
-   std::cout << "hashtable size = " << (bit_table.size() >> 10) << " KB\n" << std::endl;
-   std::cout << "bits per element = " << double(bit_table.size()) * 8 / inserted_element_num << std::endl;
+   std::cout << "hashtable size = " << (table_size >> 13) << " KB\n" << std::endl;
+   std::cout << "bits per element = " << double(table_size) / inserted_element_num << std::endl;
    PrintSplitLine('-');
 }
 
@@ -0,0 +1,334 @@
+/*
+** Counting Bloom filter in the split-block layout of BlockedBloomFilter, following "Summary Cache" (Fan et al., ToN 2000)
+** (1) every bit of a 64-byte block is backed by a 4-bit counter, the 512 counters of a block are packed in 256 bytes
+** (2) the bit filter is kept in sync with the counters (a bit is set iff its counter is nonzero),
+**     so that queries touch one cache line as before and the filter can be exported for transmission as it is
+** (3) counters saturate at 15 and are never decremented afterwards, which only costs false positives
+** (4) add serialize/deserialize interfaces
+*/
+
+#ifndef KUNLUN_COUNTING_BLOOM_FILTER_HPP
+#define KUNLUN_COUNTING_BLOOM_FILTER_HPP
+
+#include "blocked_bloom_filter.hpp"
+
+inline const uint8_t COUNTER_MAX = 0x0F;
+// number of elements whose blocks are prefetched ahead of the current update
+inline const size_t COUNTING_BLOOM_BATCH_WINDOW = 16;
+
+// counter c is the (c & 1)-th nibble of byte c/2, counter 32*j+p backs bit p of lane j of the same block
+struct alignas(64) CounterBlock{
+    uint8_t nibble[256];
+};
+
+class CountingBloomFilter{
+public:
+    BlockedBloomFilter filter; // holds the parameters, the bit table and the number of elements
+    std::vector<CounterBlock> counter_table;
+
+    CountingBloomFilter() {};
+
+    CountingBloomFilter(size_t max_element_num, size_t statistical_security_parameter) :
+        filter(max_element_num, statistical_security_parameter)
+    {
+        counter_table.assign(filter.block_num, CounterBlock());
+    }
+
+    ~CountingBloomFilter() {};
+
+    size_t ObjectSize()
+    {
+        return filter.ObjectSize() + size_t(filter.block_num)*sizeof(CounterBlock);
+    }
+
+    template <typename ElementType>
+    inline block Digest(const ElementType& element) const
+    {
+        return filter.Digest(element);
+    }
+
+    // increment the counters of the set bits of mask, and set the bits
+    inline void IncrementBlock(uint32_t block_index, const uint32_t mask[16])
+    {
+        uint32_t *word = filter.block_table[block_index].word;
+        uint8_t *nibble = counter_table[block_index].nibble;
+        for(auto j = 0; j < 16; j++){
+            word[j] |= mask[j];
+            for(uint32_t m = mask[j]; m != 0; m &= m - 1){
+                size_t c = 32*j + __builtin_ctz(m);
+                size_t shift = (c & 1) << 2;
+                if(((nibble[c >> 1] >> shift) & 0x0F) != COUNTER_MAX) nibble[c >> 1] += uint8_t(1) << shift;
+            }
+        }
+    }
+
+    // decrement the counters of the set bits of mask, and clear the bits whose counter drops to 0
+    inline void DecrementBlock(uint32_t block_index, const uint32_t mask[16])
+    {
+        uint32_t *word = filter.block_table[block_index].word;
+        uint8_t *nibble = counter_table[block_index].nibble;
+        for(auto j = 0; j < 16; j++){
+            for(uint32_t m = mask[j]; m != 0; m &= m - 1){
+                size_t p = __builtin_ctz(m);
+                size_t c = 32*j + p;
+                size_t shift = (c & 1) << 2;
+                uint8_t counter = (nibble[c >> 1] >> shift) & 0x0F;
+                if(counter == COUNTER_MAX) continue; // saturated, the true count is unknown
+                nibble[c >> 1] -= uint8_t(1) << shift;
+                if(counter == 1) word[j] &= ~(uint32_t(1) << p);
+            }
+        }
+    }
+
+    // not thread-safe, use Insert(container) instead
+    inline void InsertDigest(const block &digest)
+    {
+        uint32_t mask[16];
+        filter.ComputeMask(digest, mask);
+        IncrementBlock(filter.BlockIndex(digest), mask);
+        filter.inserted_element_num++;
+    }
+
+    /*
+    ** removing an element that was never inserted would decrement the counters of other elements and cause false negatives,
+    ** such an element is rejected unless it is a false positive, so only remove elements known to be in the set
+    */
+    inline bool RemoveDigest(const block &digest)
+    {
+        if(filter.ContainDigest(digest) == false) return false;
+        uint32_t mask[16];
+        filter.ComputeMask(digest, mask);
+        DecrementBlock(filter.BlockIndex(digest), mask);
+        filter.inserted_element_num--;
+        return true;
+    }
+
+    inline bool ContainDigest(const block &digest) const
+    {
+        return filter.ContainDigest(digest);
+    }
+
+    /*
+    ** as BlockedBloomFilter::InsertDigest(vector): the block range is split into THREAD_NUM stripes,
+    ** the positions of the elements are grouped by stripe with a parallel counting sort (stable, so the order inside a stripe is kept),
+    ** then each thread updates the blocks of its own stripe, and returns the number of elements inserted or removed
+    ** an element touches 5 cache lines (the bit block and 4 counter lines), which are prefetched COUNTING_BLOOM_BATCH_WINDOW elements ahead
+    */
+    inline size_t UpdateDigest(const std::vector<block> &vec_digest, bool remove)
+    {
+        size_t THREAD_NUM = std::max<size_t>(1, std::min<size_t>(NUMBER_OF_THREADS, filter.block_num));
+        size_t LEN = vec_digest.size();
+        size_t STRIPE_LEN = (size_t(filter.block_num) + THREAD_NUM - 1)/THREAD_NUM;
+        size_t SLICE_LEN = (LEN + THREAD_NUM - 1)/THREAD_NUM;
+
+        // offset[t*THREAD_NUM + s] = number of elements of slice t that fall in stripe s, then where they go
+        std::vector<uint32_t> vec_block_index(LEN);
+        std::vector<size_t> offset(THREAD_NUM*THREAD_NUM, 0);
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto t = 0; t < THREAD_NUM; t++){
+            for(auto i = t*SLICE_LEN; i < std::min(LEN, (t+1)*SLICE_LEN); i++){
+                vec_block_index[i] = filter.BlockIndex(vec_digest[i]);
+                offset[t*THREAD_NUM + vec_block_index[i]/STRIPE_LEN]++;
+            }
+        }
+        // stripe s occupies [stripe_begin[s], stripe_begin[s+1]) of vec_stripe_index, and inside it slice t comes before slice t+1
+        std::vector<size_t> stripe_begin(THREAD_NUM + 1, 0);
+        size_t sum = 0;
+        for(auto s = 0; s < THREAD_NUM; s++){
+            stripe_begin[s] = sum;
+            for(auto t = 0; t < THREAD_NUM; t++){
+                size_t count = offset[t*THREAD_NUM + s];
+                offset[t*THREAD_NUM + s] = sum;
+                sum += count;
+            }
+        }
+        stripe_begin[THREAD_NUM] = sum;
+
+        std::vector<uint32_t> vec_stripe_index(LEN); // positions of the elements, grouped by stripe
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto t = 0; t < THREAD_NUM; t++){
+            for(auto i = t*SLICE_LEN; i < std::min(LEN, (t+1)*SLICE_LEN); i++){
+                vec_stripe_index[offset[t*THREAD_NUM + vec_block_index[i]/STRIPE_LEN]++] = i;
+            }
+        }
+
+        std::vector<size_t> vec_updated_num(THREAD_NUM, 0);
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto t = 0; t < THREAD_NUM; t++){
+            for(auto k = stripe_begin[t]; k < stripe_begin[t+1]; k++){
+                if(k + COUNTING_BLOOM_BATCH_WINDOW < stripe_begin[t+1]){
+                    uint32_t next_block_index = vec_block_index[vec_stripe_index[k + COUNTING_BLOOM_BATCH_WINDOW]];
+                    __builtin_prefetch(filter.block_table.data() + next_block_index, 1);
+                    const uint8_t *next_nibble = counter_table[next_block_index].nibble;
+                    for(auto l = 0; l < sizeof(CounterBlock); l += 64) __builtin_prefetch(next_nibble + l, 1);
+                }
+                size_t i = vec_stripe_index[k];
+                uint32_t block_index = vec_block_index[i];
+                if(remove && filter.ContainDigest(vec_digest[i]) == false) continue;
+                uint32_t mask[16];
+                filter.ComputeMask(vec_digest[i], mask);
+                if(remove) DecrementBlock(block_index, mask);
+                else IncrementBlock(block_index, mask);
+                vec_updated_num[t]++;
+            }
+        }
+        return std::accumulate(vec_updated_num.begin(), vec_updated_num.end(), size_t(0));
+    }
+
+    inline void InsertDigest(const std::vector<block> &vec_digest)
+    {
+        filter.inserted_element_num += UpdateDigest(vec_digest, false);
+    }
+
+    // returns the number of elements removed
+    inline size_t RemoveDigest(const std::vector<block> &vec_digest)
+    {
+        size_t REMOVED_NUM = UpdateDigest(vec_digest, true);
+        filter.inserted_element_num -= REMOVED_NUM;
+        return REMOVED_NUM;
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline std::vector<block> Digest(const Container<T, Allocator>& container) const
+    {
+        std::vector<block> vec_digest(container.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < container.size(); i++){
+            vec_digest[i] = filter.Digest(container[i]);
+        }
+        return vec_digest;
+    }
+
+    template <typename ElementType>
+    inline void Insert(const ElementType& element)
+    {
+        InsertDigest(filter.Digest(element));
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline void Insert(const Container<T, Allocator>& container)
+    {
+        InsertDigest(Digest(container));
+    }
+
+    template <typename ElementType>
+    inline bool Remove(const ElementType& element)
+    {
+        return RemoveDigest(filter.Digest(element));
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline size_t Remove(const Container<T, Allocator>& container)
+    {
+        return RemoveDigest(Digest(container));
+    }
+
+    template <typename ElementType>
+    inline bool Contain(const ElementType& element) const
+    {
+        return filter.Contain(element);
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline std::vector<uint8_t> Contain(const Container<T, Allocator>& container) const
+    {
+        return filter.Contain(container);
+    }
+
+    // the plain bit filter of the current set, e.g., to be sent to the other party
+    inline const BlockedBloomFilter& ExportFilter() const
+    {
+        return filter;
+    }
+
+    inline void Clear()
+    {
+        filter.Clear();
+        std::fill(counter_table.begin(), counter_table.end(), CounterBlock());
+    }
+
+    // write object to file
+    inline bool WriteObject(std::string file_name)
+    {
+        std::ofstream fout;
+        fout.open(file_name, std::ios::binary);
+        if(!fout){
+            std::cerr << file_name << " open error" << std::endl;
+            return false;
+        }
+        char *buffer = new char[ObjectSize()];
+        WriteObject(buffer);
+        fout.write(buffer, ObjectSize());
+        delete[] buffer;
+        fout.close();
+
+        #ifdef DEBUG
+            std::cout << "'" <<file_name << "' size = " << ObjectSize() << " bytes" << std::endl;
+        #endif
+
+        return true;
+    }
+
+    // read object from file
+    inline bool ReadObject(std::string file_name)
+    {
+        std::ifstream fin;
+        fin.open(file_name, std::ios::binary | std::ios::ate);
+        if(!fin){
+            std::cerr << file_name << " open error" << std::endl;
+            return false;
+        }
+        size_t file_size = fin.tellg();
+        fin.seekg(0);
+        char *buffer = new char[file_size];
+        fin.read(buffer, file_size);
+        bool status = ReadObject(buffer);
+        delete[] buffer;
+        return status;
+    }
+
+    // write object to buffer: the bit filter followed by the counters
+    inline bool WriteObject(char* buffer)
+    {
+        if(buffer == nullptr){
+            std::cerr << "allocate memory for counting bloom filter fails" << std::endl;
+            return false;
+        }
+        filter.WriteObject(buffer);
+        memcpy(buffer + filter.ObjectSize(), counter_table.data(), size_t(filter.block_num)*sizeof(CounterBlock));
+        return true;
+    }
+
+    // read object from buffer
+    inline bool ReadObject(char* buffer)
+    {
+        if(buffer == nullptr){
+            std::cerr << "allocate memory for counting bloom filter fails" << std::endl;
+            return false;
+        }
+        filter.ReadObject(buffer);
+        counter_table.resize(filter.block_num);
+        memcpy(counter_table.data(), buffer + filter.ObjectSize(), size_t(filter.block_num)*sizeof(CounterBlock));
+        return true;
+    }
+
+    void PrintInfo() const{
+        size_t SATURATED_NUM = 0;
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(+:SATURATED_NUM)
+        for(auto i = 0; i < counter_table.size(); i++){
+            for(auto j = 0; j < sizeof(CounterBlock); j++){
+                SATURATED_NUM += ((counter_table[i].nibble[j] & 0x0F) == COUNTER_MAX) + ((counter_table[i].nibble[j] >> 4) == COUNTER_MAX);
+            }
+        }
+        PrintSplitLine('-');
+        std::cout << "CountingBloomFilter Status:" << std::endl;
+        std::cout << "inserted element num = " << filter.inserted_element_num << std::endl;
+        std::cout << "hash num = " << 8*filter.round_num << " (in one 64-byte block)" << std::endl;
+        std::cout << "bit table size = " << ((size_t(filter.block_num)*sizeof(BloomBlock)) >> 10) << " KB" << std::endl;
+        std::cout << "counter table size = " << ((size_t(filter.block_num)*sizeof(CounterBlock)) >> 10) << " KB" << std::endl;
+        std::cout << "saturated counter num = " << SATURATED_NUM << std::endl;
+        PrintSplitLine('-');
+    }
+};
+
+#endif
@@ -2,6 +2,10 @@
 ** Modified from https://github.com/efficient/cuckoofilter
 ** (1) simplify the design
 ** (2) add serialize/deserialize interfaces
+** (3) compare a tag with all slots of a bucket in one SSE compare, and add batch interfaces over contiguous keys
+** (4) multi-threaded batch insert: buckets are guarded by striped spinlocks during the cuckoo walk
+** (5) batch interfaces hash several keys at a time with the multi-lane keyed hash
+** (6) add memory-mapped files: the bucket table of a mapped filter is queried in place from a read-only mapping
 ** Thanks discussions with Minglang Dong
 */
 
@@ -12,10 +16,22 @@
 #include "../utility/murmurhash3.hpp"
 #include "../utility/bit_operation.hpp"
 #include "../crypto/ec_point.hpp"
+#include "../crypto/ec_25519.hpp"
+#include "../utility/mapped_file.hpp"
 
 
 // selection of keyed hash for cuckoo filter
 #define FastHash LiteMurmurHash 
+#define FastHashBatch LiteMurmurHashBatch // must compute the same function as FastHash
+
+// number of keys whose candidate buckets are prefetched ahead of the current lookup/insertion
+inline const size_t CUCKOO_BATCH_WINDOW = 16; 
+// number of keys hashed in parallel per round of batch insert
+inline const size_t CUCKOO_BATCH_ROUND = size_t(1) << 14; 
+// number of spinlocks guarding the buckets in concurrent insert, bucket i is guarded by lock i mod CUCKOO_LOCK_STRIPE_NUM
+inline const size_t CUCKOO_LOCK_STRIPE_NUM = size_t(1) << 16; 
+// magic of the memory-mapped file, see WriteMappedObject
+inline const char CUCKOO_FILTER_MAGIC[8] = "KLCUCKO"; 
 
 enum InsertToBucketStatus {
     SuccessAndNoKick = 0,
@@ -46,12 +62,20 @@ public:
 
     VictimCache victim;
 
+    // set by MapObject: the bucket table is read in place from the mapping and bucket_table stays empty
+    std::shared_ptr<MappedFile::Mapping> mapping; 
+    const uint8_t* mapped_table = nullptr; 
+
     CuckooFilter() {}; 
 
     CuckooFilter(size_t projected_element_num, double desired_false_positive_probability){
         max_kick_count = 500;
         slot_num = 4; 
-        tag_bit_size = 16; 
+        // a query checks 2*slot_num tags, so the false positive probability is about 2*slot_num/2^tag_bit_size
+        double required_tag_bit_size = ceil(log2(2*slot_num/desired_false_positive_probability));
+        if(required_tag_bit_size <= 8) tag_bit_size = 8; 
+        else if(required_tag_bit_size <= 16) tag_bit_size = 16; 
+        else tag_bit_size = 32; 
         bucket_byte_size = slot_num * tag_bit_size / 8;
 
         // bucket_num must be always a power of two
@@ -76,24 +100,66 @@ public:
     size_t ObjectSize()
     {
         // hash_num + random_seed + table_size + table_content
-        return 6 * 8 + bucket_table.size() + 4 * 3;
+        return 6 * 8 + bucket_byte_size * bucket_num + 4 * 3;
+    }
+
+    inline const uint8_t* Table() const
+    {
+        return mapped_table != nullptr ? mapped_table : bucket_table.data(); 
+    }
+
+    // a mapped filter is read-only
+    inline void AssertWritable() const
+    {
+        if(mapped_table != nullptr){
+            std::cerr << "cannot modify a memory-mapped cuckoo filter" << std::endl;
+            exit(1); // EXIT_FAILURE
+        }
     }
 
     // index_1 = LEFT(Hash(x)) mod bucket_num serve as the first choice 
-    inline uint32_t ComputeBucketIndex(uint32_t hash_value) {
+    inline uint32_t ComputeBucketIndex(uint32_t hash_value) const {
         // since bucket_num = 2^n, the following is equivalent to hash_value mod 2^n
         return hash_value & (bucket_num - 1); // fetch left 32 bit
     }
 
-    inline uint32_t ComputeTag(uint32_t hash_value) {
-        uint32_t tag;
+    // the tag comes from an independent hash, so that it does not overlap with the bucket index 
+    inline uint32_t ComputeTag(const void* input, size_t LEN) const {
+        return ComputeTag(FastHash(~fixed_salt32, input, LEN));
+    }
+
+    inline uint32_t ComputeTag(uint32_t hash_value) const {
         // set tag as the leftmost "tag_bit_size" part 
-        tag = hash_value >> (32 - tag_bit_size);
+        uint32_t tag = hash_value >> (32 - tag_bit_size);
         tag += (tag == 0); // ensure tag is not zero
         return tag;
     }
 
-    inline uint32_t ComputeAnotherBucketIndex(const uint32_t bucket_index, const uint32_t tag) {
+    // first bucket indexes and tags of ITEM_NUM keys of ITEM_LEN bytes stored contiguously, the keys go through the hash lane by lane
+    inline void ComputeBucketIndexAndTagBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM, 
+                                              uint32_t* bucket_index, uint32_t* tag) const {
+        FastHashBatch(fixed_salt32, input, ITEM_LEN, ITEM_NUM, bucket_index); 
+        FastHashBatch(~fixed_salt32, input, ITEM_LEN, ITEM_NUM, tag); 
+        for(auto i = 0; i < ITEM_NUM; i++){
+            bucket_index[i] = ComputeBucketIndex(bucket_index[i]); 
+            tag[i] = ComputeTag(tag[i]); 
+        }
+    }
+
+    // ComputeBucketIndexAndTagBatch with the keys split into one slice per thread
+    inline void ParallelComputeBucketIndexAndTagBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM, 
+                                                      uint32_t* bucket_index, uint32_t* tag) const {
+        size_t THREAD_NUM = NUMBER_OF_THREADS; 
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto t = 0; t < THREAD_NUM; t++){
+            size_t SLICE_BEGIN = ITEM_NUM*t/THREAD_NUM; 
+            size_t SLICE_END = ITEM_NUM*(t+1)/THREAD_NUM; 
+            ComputeBucketIndexAndTagBatch(input + SLICE_BEGIN*ITEM_LEN, ITEM_LEN, SLICE_END - SLICE_BEGIN, 
+                                          bucket_index + SLICE_BEGIN, tag + SLICE_BEGIN); 
+        }
+    }
+
+    inline uint32_t ComputeAnotherBucketIndex(const uint32_t bucket_index, const uint32_t tag) const {
         // index_2 = (index_1 XOR tag) mod bucket_num 
         return (bucket_index ^ (tag * 0x5bd1e995)) & (bucket_num - 1);
         //return (bucket_index ^ FastHash(&tag, 4)) & (bucket_num - 1);
@@ -106,17 +172,23 @@ public:
     // simply presume in that case the filter will be very dense
 
     bool PlainInsert(const void* input, size_t LEN){
-        if (victim.used){
-            std::cerr << "there is not enough space" << std::endl;
-            return false;
-        }
-
         uint32_t hash_value = FastHash(fixed_salt32, input, LEN);
         uint32_t current_bucket_index = ComputeBucketIndex(hash_value); 
-        uint32_t current_tag = ComputeTag(hash_value); 
+        uint32_t current_tag = ComputeTag(input, LEN); 
 
         // std::cout << "bucket index = " << std::hex << current_bucket_index << std::endl;
         // std::cout << "tag = " << std::hex << current_tag << std::endl; 
+
+        return InsertTag(current_bucket_index, current_tag); 
+    }
+
+    // insert a tag starting from its first bucket, kicking out existing tags if both buckets are full
+    bool InsertTag(uint32_t current_bucket_index, uint32_t current_tag){
+        AssertWritable(); 
+        if (victim.used){
+            std::cerr << "there is not enough space" << std::endl;
+            return false;
+        }
         
         uint32_t kickout_tag = 0; 
 
@@ -152,28 +224,176 @@ public:
     }
 
     // You can insert any custom-type data you like as below
+    // points are hashed in compressed form, only the POINT_COMPRESSED_BYTE_LEN bytes written by point2oct are used
     inline bool Insert(const ECPoint &A)
     {
-        unsigned char buffer[POINT_BYTE_LEN]; 
-        EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_BYTE_LEN, nullptr);
-        return PlainInsert(buffer, POINT_BYTE_LEN);
+        unsigned char buffer[POINT_COMPRESSED_BYTE_LEN]; 
+        EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, nullptr);
+        return PlainInsert(buffer, POINT_COMPRESSED_BYTE_LEN);
+    }
+
+    // serialize points to a contiguous buffer in parallel, so that they go through the batch interfaces
+    inline void SerializePoints(const std::vector<ECPoint> &vec_A, std::vector<uint8_t> &buffer) const
+    {
+        buffer.resize(vec_A.size()*POINT_COMPRESSED_BYTE_LEN); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < vec_A.size(); i++){
+            EC_POINT_point2oct(group, vec_A[i].point_ptr, POINT_CONVERSION_COMPRESSED, 
+                               buffer.data()+i*POINT_COMPRESSED_BYTE_LEN, POINT_COMPRESSED_BYTE_LEN, bn_ctx[omp_get_thread_num()]);
+        }
     }
 
     inline bool Insert(const std::vector<ECPoint> &vec_A)
     {
-        bool insert_status = true; 
+        std::vector<uint8_t> buffer; 
+        SerializePoints(vec_A, buffer); 
+        return PlainInsertBatch(buffer.data(), POINT_COMPRESSED_BYTE_LEN, vec_A.size()); 
+    }
 
-        size_t num = vec_A.size();
-        unsigned char *buffer = new unsigned char[num*POINT_BYTE_LEN]; 
-        for(auto i = 0; i < num; i++){
-            EC_POINT_point2oct(group, vec_A[i].point_ptr, POINT_CONVERSION_COMPRESSED, 
-                               buffer+i*POINT_BYTE_LEN, POINT_BYTE_LEN, nullptr);
-            if(PlainInsert(buffer+i*POINT_BYTE_LEN, POINT_BYTE_LEN) == false){
-                insert_status = false; break;
-            } 
+    inline bool Insert(const std::vector<block> &vec_A)
+    {
+        return InsertBatch(vec_A.data(), vec_A.size()); 
+    }
+
+    inline bool Insert(const std::vector<EC25519Point> &vec_A)
+    {
+        return InsertBatch(vec_A.data(), vec_A.size()); 
+    }
+
+    /*
+    ** insert ITEM_NUM keys of ITEM_LEN bytes stored contiguously
+    ** bucket indexes and tags of a round are computed in parallel with the multi-lane hash, then tags are inserted one by one 
+    ** (cuckoo kicks are sequential), with the first bucket of the key CUCKOO_BATCH_WINDOW ahead prefetched
+    */
+    inline bool PlainInsertBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM)
+    {
+        if(NUMBER_OF_THREADS > 1) return ConcurrentInsertBatch(input, ITEM_LEN, ITEM_NUM); 
+
+        std::vector<uint32_t> vec_bucket_index(std::min(CUCKOO_BATCH_ROUND, ITEM_NUM)); 
+        std::vector<uint32_t> vec_tag(std::min(CUCKOO_BATCH_ROUND, ITEM_NUM)); 
+        for(size_t BEGIN = 0; BEGIN < ITEM_NUM; BEGIN += CUCKOO_BATCH_ROUND){
+            size_t LEN = std::min(CUCKOO_BATCH_ROUND, ITEM_NUM - BEGIN); 
+            ParallelComputeBucketIndexAndTagBatch(input + BEGIN*ITEM_LEN, ITEM_LEN, LEN, vec_bucket_index.data(), vec_tag.data()); 
+            for(auto i = 0; i < LEN; i++){
+                if(i + CUCKOO_BATCH_WINDOW < LEN){
+                    __builtin_prefetch(bucket_table.data() + vec_bucket_index[i+CUCKOO_BATCH_WINDOW]*bucket_byte_size, 1); 
+                }
+                if(InsertTag(vec_bucket_index[i], vec_tag[i]) == false){
+                    std::cout << "insert the " << BEGIN+i << "-th element fails" << std::endl;
+                    return false; 
+                }
+            }
         }
-        delete[] buffer; 
-        return insert_status; 
+        return true; 
+    }
+
+    /*
+    ** thread-safe cuckoo walk of one tag, mirroring InsertTag: try the first bucket, then kick a random slot 
+    ** of the alternative bucket and continue with the kicked tag; each step holds the lock of one bucket only, 
+    ** so locks are never nested, and a kicked tag is owned by the thread until it is placed
+    ** returns false after max_kick_count kicks, with the tag in hand left in (stash_bucket_index, stash_tag)
+    */
+    inline bool ConcurrentInsertTag(uint32_t current_bucket_index, uint32_t current_tag, std::atomic<uint8_t>* lock, 
+                                    uint64_t &rng_state, uint32_t &stash_bucket_index, uint32_t &stash_tag)
+    {
+        bool licence_to_kickout = false;
+        size_t kick_count = 0;
+        while (kick_count < max_kick_count) {
+            std::atomic<uint8_t> &bucket_lock = lock[current_bucket_index & (CUCKOO_LOCK_STRIPE_NUM - 1)]; 
+            while (bucket_lock.exchange(1, std::memory_order_acquire)) _mm_pause(); 
+
+            size_t slot_index = FindSlotInBucket(current_bucket_index, 0);
+            if (slot_index != slot_num) {
+                WriteTag(current_bucket_index, slot_index, current_tag);
+                bucket_lock.store(0, std::memory_order_release); 
+                return true;
+            }
+            if (licence_to_kickout == true) {
+                // xorshift64: rand() is serialized by a global lock
+                rng_state ^= rng_state << 13; rng_state ^= rng_state >> 7; rng_state ^= rng_state << 17; 
+                slot_index = rng_state % slot_num;
+                uint32_t kickout_tag = ReadTag(current_bucket_index, slot_index);
+                WriteTag(current_bucket_index, slot_index, current_tag);
+                current_tag = kickout_tag; 
+                kick_count++; 
+            }
+            bucket_lock.store(0, std::memory_order_release); 
+
+            licence_to_kickout = true; 
+            current_bucket_index = ComputeAnotherBucketIndex(current_bucket_index, current_tag);
+        }
+        stash_bucket_index = current_bucket_index; 
+        stash_tag = current_tag; 
+        return false; 
+    }
+
+    /*
+    ** multi-threaded version of PlainInsertBatch, every tag ends in one of its two buckets as in the serial build, 
+    ** so the load factor and false positive probability are the same
+    ** walks that exceed max_kick_count go to a shared stash, which is drained serially afterwards: 
+    ** the first tag that still fails becomes the victim, as in the serial build
+    */
+    inline bool ConcurrentInsertBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM)
+    {
+        AssertWritable(); 
+        if (victim.used){
+            std::cerr << "there is not enough space" << std::endl;
+            return false;
+        }
+
+        std::vector<std::atomic<uint8_t>> lock(CUCKOO_LOCK_STRIPE_NUM); 
+        std::vector<std::pair<uint32_t, uint32_t>> stash; // (bucket index, tag) 
+        std::vector<uint32_t> vec_bucket_index(std::min(CUCKOO_BATCH_ROUND, ITEM_NUM)); 
+        std::vector<uint32_t> vec_tag(std::min(CUCKOO_BATCH_ROUND, ITEM_NUM)); 
+        size_t INSERTED_NUM = 0; 
+
+        for(size_t BEGIN = 0; BEGIN < ITEM_NUM; BEGIN += CUCKOO_BATCH_ROUND){
+            size_t LEN = std::min(CUCKOO_BATCH_ROUND, ITEM_NUM - BEGIN); 
+            ParallelComputeBucketIndexAndTagBatch(input + BEGIN*ITEM_LEN, ITEM_LEN, LEN, vec_bucket_index.data(), vec_tag.data()); 
+
+            #pragma omp parallel num_threads(NUMBER_OF_THREADS) reduction(+:INSERTED_NUM)
+            {
+                uint64_t rng_state = 0x9E3779B97F4A7C15ULL * (BEGIN + omp_get_thread_num() + 1); 
+                #pragma omp for
+                for(auto i = 0; i < LEN; i++){
+                    if(i + CUCKOO_BATCH_WINDOW < LEN){
+                        __builtin_prefetch(bucket_table.data() + vec_bucket_index[i+CUCKOO_BATCH_WINDOW]*bucket_byte_size, 1); 
+                    }
+                    uint32_t stash_bucket_index, stash_tag; 
+                    if(ConcurrentInsertTag(vec_bucket_index[i], vec_tag[i], lock.data(), rng_state, stash_bucket_index, stash_tag)){
+                        INSERTED_NUM++; 
+                    }
+                    else{
+                        #pragma omp critical(cuckoo_stash)
+                        stash.emplace_back(stash_bucket_index, stash_tag); 
+                    }
+                }
+            }
+        }
+        inserted_element_num += INSERTED_NUM; 
+
+        for(auto i = 0; i < stash.size(); i++){
+            if(InsertTag(stash[i].first, stash[i].second) == false){
+                std::cout << "insert " << stash.size() - i << " elements fails" << std::endl;
+                return false; 
+            }
+        }
+        return true; 
+    }
+
+    inline bool InsertBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM)
+    {
+        return PlainInsertBatch(input, ITEM_LEN, ITEM_NUM); 
+    }
+
+    inline bool InsertBatch(const block* input, size_t ITEM_NUM)
+    {
+        return PlainInsertBatch(reinterpret_cast<const uint8_t*>(input), sizeof(block), ITEM_NUM); 
+    }
+
+    inline bool InsertBatch(const EC25519Point* input, size_t ITEM_NUM)
+    {
+        return PlainInsertBatch(reinterpret_cast<const uint8_t*>(input), 32, ITEM_NUM); 
     }
 
     template <typename InputIterator>
@@ -190,7 +410,7 @@ public:
     }
 
     template <class T, class Allocator, template <class,class> class Container>
-    inline bool Insert(Container<T, Allocator>& container)
+    inline bool Insert(const Container<T, Allocator>& container)
     {
         bool insert_status = true; 
         for(auto i = 0; i < container.size(); i++){
@@ -204,10 +424,10 @@ public:
     }
 
     // Report if the item is inserted, with false positive rate.
-    bool PlainContain(const void* input, size_t LEN) {
+    bool PlainContain(const void* input, size_t LEN) const {
         uint32_t hash_value = FastHash(fixed_salt32, input, LEN);
         uint32_t index1 = ComputeBucketIndex(hash_value); 
-        uint32_t tag = ComputeTag(hash_value); 
+        uint32_t tag = ComputeTag(input, LEN); 
         uint32_t index2 = ComputeAnotherBucketIndex(index1, tag);
 
         // check if find in buckets
@@ -219,21 +439,82 @@ public:
     }
 
     template <typename ElementType>
-    inline bool Contain(const ElementType& element) 
+    inline bool Contain(const ElementType& element) const
     {
         return PlainContain(&element, sizeof(ElementType));
     }
 
-    inline bool Contain(const std::string& str) 
+    inline bool Contain(const std::string& str) const
     {
         return PlainContain(str.data(), str.size());
     }
 
-    inline bool Contain(const ECPoint& A) 
+    inline bool Contain(const ECPoint& A) const
     {
-        unsigned char buffer[POINT_BYTE_LEN]; 
-        EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_BYTE_LEN, nullptr);
-        return PlainContain(buffer, POINT_BYTE_LEN);
+        unsigned char buffer[POINT_COMPRESSED_BYTE_LEN]; 
+        EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, nullptr);
+        return PlainContain(buffer, POINT_COMPRESSED_BYTE_LEN);
+    }
+
+    /*
+    ** query ITEM_NUM keys of ITEM_LEN bytes stored contiguously
+    ** for each window of CUCKOO_BATCH_WINDOW keys, both candidate buckets of every key are computed and prefetched first, 
+    ** then each key is checked with two SSE compares; windows are spread across threads
+    */
+    inline std::vector<uint8_t> PlainContainBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM) const
+    {
+        std::vector<uint8_t> vec_indication_bit(ITEM_NUM); 
+        size_t WINDOW_NUM = (ITEM_NUM + CUCKOO_BATCH_WINDOW - 1)/CUCKOO_BATCH_WINDOW; 
+
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto w = 0; w < WINDOW_NUM; w++){
+            size_t BEGIN = w*CUCKOO_BATCH_WINDOW; 
+            size_t LEN = std::min(CUCKOO_BATCH_WINDOW, ITEM_NUM - BEGIN); 
+            uint32_t index1[CUCKOO_BATCH_WINDOW], index2[CUCKOO_BATCH_WINDOW], tag[CUCKOO_BATCH_WINDOW]; 
+            ComputeBucketIndexAndTagBatch(input + BEGIN*ITEM_LEN, ITEM_LEN, LEN, index1, tag); 
+            for(auto i = 0; i < LEN; i++){
+                index2[i] = ComputeAnotherBucketIndex(index1[i], tag[i]); 
+                __builtin_prefetch(Table() + index1[i]*bucket_byte_size); 
+                __builtin_prefetch(Table() + index2[i]*bucket_byte_size); 
+            }
+            for(auto i = 0; i < LEN; i++){
+                vec_indication_bit[BEGIN+i] = FindTagInBucket(index1[i], tag[i]) || FindTagInBucket(index2[i], tag[i]) 
+                    || (victim.used && (tag[i] == victim.tag) && (index1[i] == victim.bucket_index || index2[i] == victim.bucket_index)); 
+            }
+        }
+        return vec_indication_bit; 
+    }
+
+    inline std::vector<uint8_t> ContainBatch(const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM) const
+    {
+        return PlainContainBatch(input, ITEM_LEN, ITEM_NUM); 
+    }
+
+    inline std::vector<uint8_t> ContainBatch(const block* input, size_t ITEM_NUM) const
+    {
+        return PlainContainBatch(reinterpret_cast<const uint8_t*>(input), sizeof(block), ITEM_NUM); 
+    }
+
+    inline std::vector<uint8_t> ContainBatch(const EC25519Point* input, size_t ITEM_NUM) const
+    {
+        return PlainContainBatch(reinterpret_cast<const uint8_t*>(input), 32, ITEM_NUM); 
+    }
+
+    inline std::vector<uint8_t> Contain(const std::vector<block> &vec_A) const
+    {
+        return ContainBatch(vec_A.data(), vec_A.size()); 
+    }
+
+    inline std::vector<uint8_t> Contain(const std::vector<EC25519Point> &vec_A) const
+    {
+        return ContainBatch(vec_A.data(), vec_A.size()); 
+    }
+
+    inline std::vector<uint8_t> Contain(const std::vector<ECPoint> &vec_A) const
+    {
+        std::vector<uint8_t> buffer; 
+        SerializePoints(vec_A, buffer); 
+        return PlainContainBatch(buffer.data(), POINT_COMPRESSED_BYTE_LEN, vec_A.size()); 
     }
 
 
@@ -250,10 +531,11 @@ public:
 
     // Delete an key from the filter
     bool PlainDelete(const void* input, size_t LEN) {
+        AssertWritable(); 
         bool delete_status = false; 
         uint32_t hash_value = FastHash(fixed_salt32, input, LEN);
         uint32_t index1 = ComputeBucketIndex(hash_value); 
-        uint32_t tag = ComputeTag(hash_value); 
+        uint32_t tag = ComputeTag(input, LEN); 
         uint32_t index2 = ComputeAnotherBucketIndex(index1, tag);
 
         uint32_t delete_slot_index; 
@@ -291,16 +573,16 @@ public:
 
     inline bool Delete(const ECPoint& A) 
     {
-        unsigned char buffer[POINT_BYTE_LEN]; 
-        EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_BYTE_LEN, nullptr);
-        return PlainDelete(buffer, POINT_BYTE_LEN);
+        unsigned char buffer[POINT_COMPRESSED_BYTE_LEN]; 
+        EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, nullptr);
+        return PlainDelete(buffer, POINT_COMPRESSED_BYTE_LEN);
     }
 
     // read tag from i-th bucket j-th slot
-    inline uint32_t ReadTag(const size_t bucket_index, const size_t slot_index) 
+    inline uint32_t ReadTag(const size_t bucket_index, const size_t slot_index) const
     {
-        const uint8_t* ptr = bucket_table.data() + bucket_index * bucket_byte_size;
-        uint32_t tag;
+        const uint8_t* ptr = Table() + bucket_index * bucket_byte_size;
+        uint32_t tag = 0; // tag_bit_size is 8, 16 or 32, this only keeps the compiler from warning
         /* following code only works for little-endian */
         switch(tag_bit_size){
             case  8: tag = ptr[slot_index]; break;
@@ -323,41 +605,61 @@ public:
     }
 
 
-    inline bool FindTagInBucket(const size_t bucket_index, const uint32_t tag) 
+    /*
+    ** compare the tag with every slot of the bucket in one SSE compare: a bucket of 4 slots is 4, 8 or 16 bytes
+    ** returns the index of the first matching slot, or slot_num if there is none
+    ** caution: unaligned access & assuming little endian
+    */
+    __attribute__((target("sse2")))
+    inline size_t FindSlotInBucket(const size_t bucket_index, const uint32_t tag) const
     {
-        // caution: unaligned access & assuming little endian
-        const uint8_t *ptr = bucket_table.data() + bucket_index * bucket_byte_size;
-        uint64_t v; 
+        const uint8_t *ptr = Table() + bucket_index * bucket_byte_size;
+        if (slot_num != 4) {
+            for (auto slot_index = 0; slot_index < slot_num; slot_index++) {
+                if (ReadTag(bucket_index, slot_index) == tag) return slot_index;
+            }
+            return slot_num;
+        }
+
+        __m128i bucket; 
+        switch(bucket_byte_size){
+            case  4: { int32_t v; memcpy(&v, ptr, 4); bucket = _mm_cvtsi32_si128(v); break; }
+            case  8: bucket = _mm_loadl_epi64((const __m128i*)ptr); break;
+            default: bucket = _mm_loadu_si128((const __m128i*)ptr);
+        }
+        __m128i match; 
         switch(tag_bit_size){
-            case  8: v = *(uint32_t*)ptr; return hasvalue8(v, tag);
-            case 16: v = *(uint64_t*)ptr; return hasvalue16(v, tag);
-            default:
-                for (auto slot_index = 0; slot_index < slot_num; slot_index++) {
-                    if (ReadTag(bucket_index, slot_index) == tag) return true;
-                }
+            case  8: match = _mm_cmpeq_epi8(bucket, _mm_set1_epi8(int8_t(tag))); break;
+            case 16: match = _mm_cmpeq_epi16(bucket, _mm_set1_epi16(int16_t(tag))); break;
+            default: match = _mm_cmpeq_epi32(bucket, _mm_set1_epi32(int32_t(tag)));
         }
-        return false;
+        // one bit per byte, keep the bytes of the bucket only
+        uint32_t match_mask = _mm_movemask_epi8(match) & ((uint32_t(1) << bucket_byte_size) - 1);
+        if (match_mask == 0) return slot_num;
+        return __builtin_ctz(match_mask) / (tag_bit_size / 8);
+    }
+
+    inline bool FindTagInBucket(const size_t bucket_index, const uint32_t tag) const
+    {
+        return FindSlotInBucket(bucket_index, tag) != slot_num;
     }
 
     inline bool DeleteTagFromBucket(const size_t bucket_index, const uint32_t tag, uint32_t &delete_slot_index) {
-        for (auto slot_index = 0; slot_index < slot_num; slot_index++) {
-            if (ReadTag(bucket_index, slot_index) == tag) {
-                WriteTag(bucket_index, slot_index, 0);
-                delete_slot_index = slot_index; 
-                return true;
-            }
-        }
-        return false;
+        size_t slot_index = FindSlotInBucket(bucket_index, tag);
+        if (slot_index == slot_num) return false;
+        WriteTag(bucket_index, slot_index, 0);
+        delete_slot_index = slot_index; 
+        return true;
     }
 
     inline InsertToBucketStatus InsertTagToBucket(const size_t bucket_index, const uint32_t tag,
                                   const bool licence_to_kickout, uint32_t &kickout_tag) {
 
-        for (auto slot_index = 0; slot_index < slot_num; slot_index++) {
-            if (ReadTag(bucket_index, slot_index) == 0) {
-                WriteTag(bucket_index, slot_index, tag);
-                return SuccessAndNoKick;
-            }
+        // an empty slot holds tag 0
+        size_t slot_index = FindSlotInBucket(bucket_index, 0);
+        if (slot_index != slot_num) {
+            WriteTag(bucket_index, slot_index, tag);
+            return SuccessAndNoKick;
         }
         // licence_to_kickout = true indicates the element must be add to this bucket
         // licence_to_kickout = false indicates this is a new element, and can be add to the alternative bucket 
@@ -392,7 +694,7 @@ public:
         fout << victim.tag;
         fout << victim.used;
 
-        fout << bucket_table; 
+        fout.write(reinterpret_cast<const char*>(Table()), bucket_byte_size * bucket_num); 
 
         fout.close(); 
 
@@ -422,8 +724,10 @@ public:
         fin >> victim.tag;
         fin >> victim.used;
 
+        mapping.reset(); 
+        mapped_table = nullptr; 
         bucket_table.resize(bucket_byte_size * bucket_num, static_cast<uint8_t>(0x00));
-        fin >> bucket_table.data(); 
+        fin >> bucket_table; 
       
         return true;
    } 
@@ -444,9 +748,9 @@ public:
 
         memcpy(buffer+48, &victim.bucket_index, 4);
         memcpy(buffer+52, &victim.tag, 4);
-        memcpy(buffer+66, &victim.used, 4);
+        memcpy(buffer+56, &victim.used, 4);
       
-        memcpy(buffer+60, bucket_table.data(), bucket_table.size()); 
+        memcpy(buffer+60, Table(), bucket_byte_size * bucket_num); 
 
         return true; 
    } 
@@ -468,12 +772,75 @@ public:
         memcpy(&victim.tag, buffer+52, 4);
         memcpy(&victim.used, buffer+56, 4);
 
+        mapping.reset(); 
+        mapped_table = nullptr; 
         bucket_table.resize(bucket_byte_size * bucket_num, static_cast<uint8_t>(0x00));
         memcpy(bucket_table.data(), buffer+60, bucket_table.size()); 
 
         return true; 
    } 
 
+   /*
+   ** write object to a file that MapObject can map: | header | parameters and victim | padding | bucket_table |
+   ** bucket_table starts at a page boundary
+   */
+   inline bool WriteMappedObject(std::string file_name) const
+   {
+        std::vector<uint8_t> parameter(60); 
+
+        memcpy(parameter.data(),    &inserted_element_num, 8);
+        memcpy(parameter.data()+8,  &max_kick_count, 8);
+        memcpy(parameter.data()+16, &slot_num, 8);
+        memcpy(parameter.data()+24, &tag_bit_size, 8);
+        memcpy(parameter.data()+32, &bucket_byte_size, 8);
+        memcpy(parameter.data()+40, &bucket_num, 8);
+
+        memcpy(parameter.data()+48, &victim.bucket_index, 4);
+        memcpy(parameter.data()+52, &victim.tag, 4);
+        memcpy(parameter.data()+56, &victim.used, 4);
+
+        return MappedFile::Write(file_name, CUCKOO_FILTER_MAGIC, parameter, Table(), bucket_byte_size * bucket_num); 
+   }
+
+   /*
+   ** map a file written by WriteMappedObject: only the header is read, the bucket table is queried in place
+   ** the mapped filter is read-only, verify_checksum additionally checks the table at the cost of one pass over it
+   */
+   inline bool MapObject(std::string file_name, bool verify_checksum = false)
+   {
+        std::shared_ptr<MappedFile::Mapping> new_mapping = MappedFile::Open(file_name, CUCKOO_FILTER_MAGIC, verify_checksum); 
+        if(new_mapping == nullptr) return false; 
+
+        const uint8_t* parameter = new_mapping->Parameter(); 
+        size_t new_slot_num, new_tag_bit_size, new_bucket_byte_size, new_bucket_num; 
+        memcpy(&new_slot_num, parameter+16, 8);
+        memcpy(&new_tag_bit_size, parameter+24, 8);
+        memcpy(&new_bucket_byte_size, parameter+32, 8);
+        memcpy(&new_bucket_num, parameter+40, 8);
+        if(new_mapping->Header()->parameter_len != 60 || new_bucket_byte_size != new_slot_num * new_tag_bit_size / 8 
+           || new_mapping->Header()->table_len != new_bucket_byte_size * new_bucket_num){
+            std::cerr << file_name << " has inconsistent cuckoo filter parameters" << std::endl;
+            return false; 
+        }
+
+        memcpy(&inserted_element_num, parameter, 8);
+        memcpy(&max_kick_count, parameter+8, 8);
+        slot_num = new_slot_num; 
+        tag_bit_size = new_tag_bit_size; 
+        bucket_byte_size = new_bucket_byte_size; 
+        bucket_num = new_bucket_num; 
+
+        memcpy(&victim.bucket_index, parameter+48, 4);
+        memcpy(&victim.tag, parameter+52, 4);
+        memcpy(&victim.used, parameter+56, 4);
+
+        std::vector<uint8_t>().swap(bucket_table); 
+        mapping = new_mapping; 
+        mapped_table = mapping->Table(); 
+
+        return true; 
+   }
+
 
     /* methods for providing stats  */
     void PrintInfo() {
@@ -482,8 +849,8 @@ public:
         std::cout << "inserted element num = " << inserted_element_num << std::endl;
         std::cout << "load factor = " << 1.0 * inserted_element_num / (bucket_num * slot_num) << std::endl;
         std::cout << "bucket num = " << bucket_num << std::endl;
-        std::cout << "hashtable size = " << (bucket_table.size() >> 10) << " KB" << std::endl;
-        std::cout << "bits per element = " << double(bucket_table.size()) * 8 / inserted_element_num << std::endl;
+        std::cout << "hashtable size = " << ((bucket_byte_size * bucket_num) >> 10) << " KB" << std::endl;
+        std::cout << "bits per element = " << double(bucket_byte_size * bucket_num) * 8 / inserted_element_num << std::endl;
         PrintSplitLine('-');
     }
 
@@ -0,0 +1,421 @@
+/*
+** Golomb-coded sorted set, following "Cache-, Hash- and Space-Efficient Bloom Filters" (Putze et al., JEA 2009) and BIP 158
+** (1) n elements are hashed to [0, n*2^lambda), sorted, and the gaps are Rice coded with parameter lambda,
+**     which costs about lambda + 1.6 bits per element for false positive probability 2^{-lambda}
+** (2) the sorted values are cut into chunks of GCS_CHUNK_LEN, each chunk starts byte-aligned with its first value stored in full,
+**     so that chunks are built and decoded independently in parallel
+** (3) batch queries sort the hashed queries and merge them with the decoded chunks, single queries decode one chunk
+** (4) add serialize/deserialize interfaces
+** it is a static structure: all elements are given at construction, after which only Contain is supported
+*/
+
+#ifndef KUNLUN_GOLOMB_CODED_SET_HPP
+#define KUNLUN_GOLOMB_CODED_SET_HPP
+
+#include "../include/std.inc"
+#include "../utility/murmurhash3.hpp"
+#include "../utility/golomb_coding.hpp"
+#include "../utility/print.hpp"
+#include "../crypto/block.hpp"
+#include "../crypto/ec_point.hpp"
+#include "../crypto/ec_25519.hpp"
+
+// number of sorted values per independently coded chunk: a single query decodes one chunk
+inline const size_t GCS_CHUNK_LEN = 4096;
+
+class GolombCodedSet{
+public:
+    uint32_t rice_param; // lambda
+    uint32_t chunk_num;
+    uint64_t element_num; // distinct hashed values
+    uint64_t range; // projected element num * 2^lambda, hashes are mapped to [0, range)
+
+    std::vector<uint64_t> vec_chunk_base; // first value of each chunk
+    std::vector<uint64_t> vec_chunk_offset; // byte offset of each chunk in code, followed by the total length
+    std::vector<uint8_t> code;
+
+    GolombCodedSet() {};
+
+    GolombCodedSet(size_t projected_element_num, size_t statistical_security_parameter)
+    {
+        rice_param = statistical_security_parameter;
+        if(projected_element_num != 0 && log2(double(projected_element_num)) + rice_param >= 64){
+            std::cerr << "golomb coded set requires log2(n) + lambda < 64" << std::endl;
+            exit(1); // EXIT_FAILURE
+        }
+        range = uint64_t(projected_element_num) << rice_param;
+        element_num = 0;
+        chunk_num = 0;
+        vec_chunk_offset.assign(1, 0);
+    }
+
+    ~GolombCodedSet() {};
+
+    size_t ObjectSize()
+    {
+        // rice_param + chunk_num + element_num + range + (base, offset) of each chunk + total length + code
+        return 2*sizeof(uint32_t) + 2*sizeof(uint64_t) + 2*size_t(chunk_num)*sizeof(uint64_t) + sizeof(uint64_t) + code.size();
+    }
+
+    static inline uint64_t PlainHash(const void* input, size_t LEN)
+    {
+        uint64_t digest[2];
+        MurmurHash3_x64_128(input, static_cast<int>(LEN), fixed_salt32, digest);
+        return digest[0];
+    }
+
+    template <typename ElementType> // Note: T must be a C++ POD type.
+    static inline uint64_t Hash(const ElementType& element)
+    {
+        return PlainHash(&element, sizeof(ElementType));
+    }
+
+    static inline uint64_t Hash(const std::string& str)
+    {
+        return PlainHash(str.data(), str.size());
+    }
+
+    static inline uint64_t Hash(const ECPoint &A)
+    {
+        int thread_num = omp_get_thread_num();
+        #ifdef ECPOINT_COMPRESSED
+            unsigned char buffer[POINT_COMPRESSED_BYTE_LEN];
+            memset(buffer, 0, POINT_COMPRESSED_BYTE_LEN);
+            EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_COMPRESSED, buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[thread_num]);
+            return PlainHash(buffer, POINT_COMPRESSED_BYTE_LEN);
+        #else
+            unsigned char buffer[POINT_BYTE_LEN];
+            memset(buffer, 0, POINT_BYTE_LEN);
+            EC_POINT_point2oct(group, A.point_ptr, POINT_CONVERSION_UNCOMPRESSED, buffer, POINT_BYTE_LEN, bn_ctx[thread_num]);
+            return PlainHash(buffer, POINT_BYTE_LEN);
+        #endif
+    }
+
+    static inline uint64_t Hash(const EC25519Point &A)
+    {
+        return PlainHash(A.px, 32);
+    }
+
+    // map a 64-bit hash to [0, range) by a multiply-shift, which keeps the order of the hashes
+    inline uint64_t MapToRange(uint64_t hash_value) const
+    {
+        return uint64_t(((unsigned __int128)hash_value * range) >> 64);
+    }
+
+    /*
+    ** sort values uniformly distributed in [0, range): each thread scatters its slice into NUMBER_OF_THREADS value ranges,
+    ** then each range is sorted by one thread
+    */
+    template <typename T, typename KeyFunction>
+    inline void PartitionSort(std::vector<T> &vec, KeyFunction key) const
+    {
+        size_t THREAD_NUM = NUMBER_OF_THREADS;
+        auto compare = [&key](const T &a, const T &b){ return key(a) < key(b); };
+        if(THREAD_NUM == 1 || vec.size() < THREAD_NUM*GCS_CHUNK_LEN){
+            std::sort(vec.begin(), vec.end(), compare);
+            return;
+        }
+        auto Partition = [&](const T &a){ return size_t(((unsigned __int128)key(a) * THREAD_NUM) / range); };
+
+        // count[t*THREAD_NUM+p] is the number of values of slice t that fall in range p
+        std::vector<size_t> count(THREAD_NUM*THREAD_NUM, 0);
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto t = 0; t < THREAD_NUM; t++){
+            for(auto i = vec.size()*t/THREAD_NUM; i < vec.size()*(t+1)/THREAD_NUM; i++) count[t*THREAD_NUM + Partition(vec[i])]++;
+        }
+        // position[t*THREAD_NUM+p] is where slice t writes its first value of range p
+        std::vector<size_t> position(THREAD_NUM*THREAD_NUM);
+        std::vector<size_t> partition_begin(THREAD_NUM + 1, 0);
+        size_t offset = 0;
+        for(auto p = 0; p < THREAD_NUM; p++){
+            partition_begin[p] = offset;
+            for(auto t = 0; t < THREAD_NUM; t++){
+                position[t*THREAD_NUM+p] = offset;
+                offset += count[t*THREAD_NUM+p];
+            }
+        }
+        partition_begin[THREAD_NUM] = offset;
+
+        std::vector<T> buffer(vec.size());
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto t = 0; t < THREAD_NUM; t++){
+            for(auto i = vec.size()*t/THREAD_NUM; i < vec.size()*(t+1)/THREAD_NUM; i++){
+                buffer[position[t*THREAD_NUM + Partition(vec[i])]++] = vec[i];
+            }
+        }
+        #pragma omp parallel for num_threads(THREAD_NUM)
+        for(auto p = 0; p < THREAD_NUM; p++){
+            std::sort(buffer.begin() + partition_begin[p], buffer.begin() + partition_begin[p+1], compare);
+        }
+        vec.swap(buffer);
+    }
+
+    // build from 64-bit hashes, duplicated values are kept once
+    bool BuildHash(const std::vector<uint64_t> &vec_hash)
+    {
+        if(range == 0 && vec_hash.size() != 0){
+            std::cerr << "golomb coded set is constructed with no projected element" << std::endl;
+            return false;
+        }
+        std::vector<uint64_t> vec_value(vec_hash.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < vec_hash.size(); i++){
+            vec_value[i] = MapToRange(vec_hash[i]);
+        }
+        PartitionSort(vec_value, [](uint64_t a){ return a; });
+        vec_value.erase(std::unique(vec_value.begin(), vec_value.end()), vec_value.end());
+
+        element_num = vec_value.size();
+        chunk_num = (element_num + GCS_CHUNK_LEN - 1)/GCS_CHUNK_LEN;
+        vec_chunk_base.resize(chunk_num);
+        std::vector<std::vector<uint8_t>> vec_chunk(chunk_num);
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto c = 0; c < chunk_num; c++){
+            size_t BEGIN = c*GCS_CHUNK_LEN;
+            size_t END = std::min<size_t>(BEGIN + GCS_CHUNK_LEN, element_num);
+            vec_chunk_base[c] = vec_value[BEGIN];
+            GolombCoding::BitWriter writer;
+            for(auto i = BEGIN + 1; i < END; i++){
+                writer.WriteRice(vec_value[i] - vec_value[i-1] - 1, rice_param); // distinct values differ by at least 1
+            }
+            writer.Flush();
+            vec_chunk[c].swap(writer.byte_vector);
+        }
+
+        vec_chunk_offset.assign(chunk_num + 1, 0);
+        for(auto c = 0; c < chunk_num; c++) vec_chunk_offset[c+1] = vec_chunk_offset[c] + vec_chunk[c].size();
+        code.resize(vec_chunk_offset[chunk_num]);
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto c = 0; c < chunk_num; c++){
+            memcpy(code.data() + vec_chunk_offset[c], vec_chunk[c].data(), vec_chunk[c].size());
+        }
+        return true;
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline bool Build(const Container<T, Allocator>& container)
+    {
+        std::vector<uint64_t> vec_hash(container.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < container.size(); i++){
+            vec_hash[i] = Hash(container[i]);
+        }
+        return BuildHash(vec_hash);
+    }
+
+    inline size_t ChunkLen(size_t c) const
+    {
+        return std::min<size_t>(GCS_CHUNK_LEN, element_num - c*GCS_CHUNK_LEN);
+    }
+
+    // decode chunk c and call visit on its values in ascending order until visit returns false
+    template <typename VisitFunction>
+    inline void DecodeChunk(size_t c, VisitFunction visit) const
+    {
+        GolombCoding::BitReader reader(code.data() + vec_chunk_offset[c], vec_chunk_offset[c+1] - vec_chunk_offset[c]);
+        uint64_t value = vec_chunk_base[c];
+        if(visit(value) == false) return;
+        for(auto i = 1; i < ChunkLen(c); i++){
+            value += reader.ReadRice(rice_param) + 1;
+            if(visit(value) == false) return;
+        }
+    }
+
+    // all values in ascending order, chunks are decoded in parallel
+    std::vector<uint64_t> Decode() const
+    {
+        std::vector<uint64_t> vec_value(element_num);
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto c = 0; c < chunk_num; c++){
+            size_t i = c*GCS_CHUNK_LEN;
+            DecodeChunk(c, [&](uint64_t value){ vec_value[i++] = value; return true; });
+        }
+        return vec_value;
+    }
+
+    inline bool ContainHash(uint64_t hash_value) const
+    {
+        if(chunk_num == 0) return false;
+        uint64_t target = MapToRange(hash_value);
+        // the last chunk whose first value is at most target
+        size_t c = std::upper_bound(vec_chunk_base.begin(), vec_chunk_base.end(), target) - vec_chunk_base.begin();
+        if(c == 0) return false;
+        bool found = false;
+        DecodeChunk(c - 1, [&](uint64_t value){ found = (value == target); return value < target; });
+        return found;
+    }
+
+    template <typename ElementType>
+    inline bool Contain(const ElementType& element) const
+    {
+        return ContainHash(Hash(element));
+    }
+
+    /*
+    ** batch query: the queries are mapped and sorted with their positions,
+    ** then each chunk is decoded once and merged with the queries that fall between its first value and the next chunk's
+    */
+    inline std::vector<uint8_t> ContainHash(const std::vector<uint64_t> &vec_hash) const
+    {
+        std::vector<uint8_t> vec_indication_bit(vec_hash.size(), 0);
+        if(chunk_num == 0) return vec_indication_bit;
+
+        std::vector<std::pair<uint64_t, uint32_t>> vec_query(vec_hash.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < vec_hash.size(); i++){
+            vec_query[i] = {MapToRange(vec_hash[i]), uint32_t(i)};
+        }
+        PartitionSort(vec_query, [](const std::pair<uint64_t, uint32_t> &a){ return a.first; });
+
+        auto compare = [](const std::pair<uint64_t, uint32_t> &a, uint64_t value){ return a.first < value; };
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto c = 0; c < chunk_num; c++){
+            size_t BEGIN = std::lower_bound(vec_query.begin(), vec_query.end(), vec_chunk_base[c], compare) - vec_query.begin();
+            size_t END = (c + 1 == chunk_num) ? vec_query.size() :
+                         std::lower_bound(vec_query.begin(), vec_query.end(), vec_chunk_base[c+1], compare) - vec_query.begin();
+            if(BEGIN == END) continue;
+            size_t j = BEGIN;
+            DecodeChunk(c, [&](uint64_t value){
+                while(j < END && vec_query[j].first < value) j++;
+                while(j < END && vec_query[j].first == value) vec_indication_bit[vec_query[j++].second] = 1;
+                return j < END;
+            });
+        }
+        return vec_indication_bit;
+    }
+
+    template <class T, class Allocator, template <class,class> class Container>
+    inline std::vector<uint8_t> Contain(const Container<T, Allocator>& container) const
+    {
+        std::vector<uint64_t> vec_hash(container.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < container.size(); i++){
+            vec_hash[i] = Hash(container[i]);
+        }
+        return ContainHash(vec_hash);
+    }
+
+    // write object to file
+    inline bool WriteObject(std::string file_name)
+    {
+        std::ofstream fout;
+        fout.open(file_name, std::ios::binary);
+        if(!fout){
+            std::cerr << file_name << " open error" << std::endl;
+            return false;
+        }
+        char *buffer = new char[ObjectSize()];
+        WriteObject(buffer);
+        fout.write(buffer, ObjectSize());
+        delete[] buffer;
+        fout.close();
+
+        #ifdef DEBUG
+            std::cout << "'" <<file_name << "' size = " << ObjectSize() << " bytes" << std::endl;
+        #endif
+
+        return true;
+    }
+
+    // read object from file
+    inline bool ReadObject(std::string file_name)
+    {
+        std::ifstream fin;
+        fin.open(file_name, std::ios::binary | std::ios::ate);
+        if(!fin){
+            std::cerr << file_name << " open error" << std::endl;
+            return false;
+        }
+        size_t file_size = fin.tellg();
+        fin.seekg(0);
+        char *buffer = new char[file_size];
+        fin.read(buffer, file_size);
+        bool status = ReadObject(buffer, file_size);
+        delete[] buffer;
+        return status;
+    }
+
+    // write object to buffer
+    inline bool WriteObject(char* buffer)
+    {
+        if(buffer == nullptr){
+            std::cerr << "allocate memory for golomb coded set fails" << std::endl;
+            return false;
+        }
+        size_t offset = 0;
+        memcpy(buffer + offset, &rice_param, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &chunk_num, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(buffer + offset, &element_num, sizeof(uint64_t)); offset += sizeof(uint64_t);
+        memcpy(buffer + offset, &range, sizeof(uint64_t)); offset += sizeof(uint64_t);
+        memcpy(buffer + offset, vec_chunk_base.data(), size_t(chunk_num)*sizeof(uint64_t)); offset += size_t(chunk_num)*sizeof(uint64_t);
+        memcpy(buffer + offset, vec_chunk_offset.data(), size_t(chunk_num + 1)*sizeof(uint64_t)); offset += size_t(chunk_num + 1)*sizeof(uint64_t);
+        memcpy(buffer + offset, code.data(), code.size());
+        return true;
+    }
+
+    /*
+    ** read object from a buffer of LEN bytes, which may come from the peer:
+    ** the chunk layout must match element_num, the chunk bases must increase, the offsets start at 0 and do not decrease,
+    ** and the code must end exactly at LEN
+    */
+    inline bool ReadObject(const char* buffer, size_t LEN)
+    {
+        if(buffer == nullptr){
+            std::cerr << "allocate memory for golomb coded set fails" << std::endl;
+            return false;
+        }
+        const size_t FIXED_LEN = 2*sizeof(uint32_t) + 2*sizeof(uint64_t);
+        if(LEN < FIXED_LEN){
+            std::cerr << "golomb coded set header is truncated" << std::endl;
+            return false;
+        }
+        size_t offset = 0;
+        memcpy(&rice_param, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&chunk_num, buffer + offset, sizeof(uint32_t)); offset += sizeof(uint32_t);
+        memcpy(&element_num, buffer + offset, sizeof(uint64_t)); offset += sizeof(uint64_t);
+        memcpy(&range, buffer + offset, sizeof(uint64_t)); offset += sizeof(uint64_t);
+        if(rice_param >= 64 || chunk_num != element_num/GCS_CHUNK_LEN + (element_num % GCS_CHUNK_LEN != 0)){
+            std::cerr << "golomb coded set header is inconsistent" << std::endl;
+            return false;
+        }
+        size_t HEADER_LEN = FIXED_LEN + (2*size_t(chunk_num) + 1)*sizeof(uint64_t);
+        if(LEN < HEADER_LEN){
+            std::cerr << "golomb coded set header is truncated" << std::endl;
+            return false;
+        }
+        vec_chunk_base.resize(chunk_num);
+        memcpy(vec_chunk_base.data(), buffer + offset, size_t(chunk_num)*sizeof(uint64_t)); offset += size_t(chunk_num)*sizeof(uint64_t);
+        vec_chunk_offset.resize(chunk_num + 1);
+        memcpy(vec_chunk_offset.data(), buffer + offset, size_t(chunk_num + 1)*sizeof(uint64_t)); offset += size_t(chunk_num + 1)*sizeof(uint64_t);
+        for(auto c = 0; c < chunk_num; c++){
+            if(vec_chunk_base[c] >= range || (c > 0 && vec_chunk_base[c] <= vec_chunk_base[c-1])){
+                std::cerr << "golomb coded set header is inconsistent" << std::endl;
+                return false;
+            }
+        }
+        if(vec_chunk_offset[0] != 0 || !std::is_sorted(vec_chunk_offset.begin(), vec_chunk_offset.end())){
+            std::cerr << "golomb coded set header is inconsistent" << std::endl;
+            return false;
+        }
+        if(vec_chunk_offset[chunk_num] != LEN - HEADER_LEN){
+            std::cerr << "golomb coded set has inconsistent length" << std::endl;
+            return false;
+        }
+        code.resize(vec_chunk_offset[chunk_num]);
+        memcpy(code.data(), buffer + offset, code.size());
+        return true;
+    }
+
+    void PrintInfo() const{
+        PrintSplitLine('-');
+        std::cout << "GolombCodedSet Status:" << std::endl;
+        std::cout << "inserted element num = " << element_num << std::endl;
+        std::cout << "rice parameter = " << rice_param << std::endl;
+        std::cout << "chunk num = " << chunk_num << std::endl;
+        std::cout << "code size = " << (code.size() >> 10) << " KB" << std::endl;
+        std::cout << "bits per element = " << 8.0*(code.size() + 16*chunk_num)/element_num << std::endl;
+        PrintSplitLine('-');
+    }
+};
+
+#endif
@@ -159,7 +159,8 @@ bool Verify(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND,
 
 }
 
-void Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, 
+// the plaintext is recovered by decryption, dlog_solver is returned by TwistedExponentialElGamal::Initialize(pp.enc_part)
+void Prove(PP &pp, const DLogSolver &dlog_solver, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, 
                    Witness_type2 &witness, std::string &transcript_str, Proof_type2 &proof)
 {
     if (CheckRange(LEFT_BOUND, RIGHT_BOUND, pp.bullet_part.RANGE_LEN)==false)
@@ -168,17 +169,10 @@ void Prove(PP &pp, Instance &instance, BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND,
         exit(EXIT_FAILURE);
     } 
       
-    if(encoding2index_map.empty() == true)
-    {
-        std::cout << "the hashmap is empty" << std::endl; 
-        TwistedExponentialElGamal::Initialize(pp.enc_part);
-    }
-
-
     BigInt r_star = GenRandomBigIntLessThan(order); 
     proof.refresh_ct = TwistedExponentialElGamal::ReEnc(pp.enc_part, instance.pk, witness.sk, instance.ct, r_star); 
 
-    BigInt m = TwistedExponentialElGamal::Dec(pp.enc_part, witness.sk, instance.ct); 
+    BigInt m = TwistedExponentialElGamal::Dec(pp.enc_part, dlog_solver, witness.sk, instance.ct); 
 
     DLOGEquality::PP dlogeq_pp = DLOGEquality::Setup();
     DLOGEquality::Instance dlogeq_instance;
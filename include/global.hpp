@@ -18,9 +18,10 @@ inline std::mt19937 global_built_in_prg(rd());
 /* 
 * default setting: set the maximum thread num as num of physical cores
 * you can switch to **N** thread setting by assign NUMBER_OF_THREADS = N by hand
+* it is not const, so that a benchmark driver can also reassign it at runtime before running a protocol
 */
-// inline const size_t NUMBER_OF_THREADS = NUMBER_OF_PHYSICAL_CORES;  
-inline const size_t NUMBER_OF_THREADS = 1;  
+// inline size_t NUMBER_OF_THREADS = NUMBER_OF_PHYSICAL_CORES;  
+inline size_t NUMBER_OF_THREADS = 1;  
 
 inline const size_t CHECK_BUFFER_SIZE = 1024*8;
 
@@ -1,3 +1,6 @@
+#ifndef KUNLUN_VOLE_OPRF_HPP_
+#define KUNLUN_VOLE_OPRF_HPP_
+
 /* vole_oprf = VOLE + OKVS  */
 
 #include "../../netio/stream_channel.hpp"
@@ -366,3 +369,5 @@ namespace VOLEOPRF
     }
     
 }
+
+#endif
@@ -543,7 +543,105 @@ std::vector<std::vector<uint8_t>> OnesidedReceiveByteVector(NetIO &io, PP &pp,
 
     PrintSplitLine('-'); 
 
-    return vec_result; 
+    return vec_result;
+}
+
+/*
+** one-sided version for fixed-width items stored contiguously:
+** the i-th message lies in vec_m[i*ITEM_LEN, (i+1)*ITEM_LEN), no per-item length header is sent
+** the masked payloads are written straight into a single send buffer
+*/
+void OnesidedSendBytes(NetIO &io, PP &pp, std::vector<uint8_t> &vec_m, size_t ITEM_LEN, size_t EXTEND_LEN)
+{
+    if(vec_m.size() != EXTEND_LEN*ITEM_LEN){
+        std::cerr << "the size of flat message buffer does not match EXTEND_LEN*ITEM_LEN" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    PrintSplitLine('-');
+
+    std::cout << "one-sided OTe: sender side" << std::endl;
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<block> vec_K0(EXTEND_LEN);
+    std::vector<block> vec_K1(EXTEND_LEN);
+
+    RandomSend(io, pp, vec_K0, vec_K1, EXTEND_LEN);
+
+    // begin to transmit the real message
+    std::vector<uint8_t> vec_outer_C(EXTEND_LEN*ITEM_LEN);
+
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < EXTEND_LEN; i++)
+    {
+        OTP::Enc(vec_K1[i], vec_m.data()+i*ITEM_LEN, vec_outer_C.data()+i*ITEM_LEN, ITEM_LEN);
+    }
+    io.SendBytes(vec_outer_C.data(), vec_outer_C.size());
+
+    std::cout << "ALSZ OTE [step 3]: Sender ===> vec_C ===> Receiver" << " ["
+              << (double)EXTEND_LEN*ITEM_LEN/(1024*1024) << " MB]" << std::endl;
+
+    #ifdef DEBUG
+        std::cout << "ALSZ OTE: Sender sends "<< EXTEND_LEN << " number of ciphertexts to receiver" << std::endl;
+        PrintSplitLine('*');
+    #endif
+
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "ALSZ OTE: Sender side takes time "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    PrintSplitLine('-');
+}
+
+// the result is a flat buffer of (hamming weight of vec_selection_bit)*ITEM_LEN bytes, kept in the original order
+std::vector<uint8_t> OnesidedReceiveBytes(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver_selection_bit,
+                                          size_t ITEM_LEN, size_t EXTEND_LEN)
+{
+    PrintSplitLine('-');
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<block> vec_K(EXTEND_LEN);
+
+    RandomReceive(io, pp, vec_K, vec_receiver_selection_bit, EXTEND_LEN);
+
+    std::vector<uint8_t> vec_outer_C(EXTEND_LEN*ITEM_LEN);
+    io.ReceiveBytes(vec_outer_C.data(), vec_outer_C.size());
+
+    // compute the output position of each selected item first, so that decryption can run in parallel
+    std::vector<size_t> vec_offset(EXTEND_LEN);
+    size_t HAMMING_WEIGHT = 0;
+    for(auto i = 0; i < EXTEND_LEN; i++){
+        vec_offset[i] = HAMMING_WEIGHT;
+        HAMMING_WEIGHT += vec_receiver_selection_bit[i];
+    }
+
+    std::vector<uint8_t> vec_result(HAMMING_WEIGHT*ITEM_LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < EXTEND_LEN; i++){
+        // only decrypt when selection bit is 1
+        if(vec_receiver_selection_bit[i] == 1){
+            OTP::Dec(vec_K[i], vec_outer_C.data()+i*ITEM_LEN, vec_result.data()+vec_offset[i]*ITEM_LEN, ITEM_LEN);
+        }
+    }
+
+    #ifdef DEBUG
+        std::cout << "ALSZ OTE: Receiver gets "<< EXTEND_LEN << " number of ciphertexts from Sender" << std::endl;
+        PrintSplitLine('*');
+    #endif
+
+    std::cout << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl;
+
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "ALSZ OTE: Receiver side takes time "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    PrintSplitLine('-');
+
+    return vec_result;
 }
 
 // standard version
@@ -634,5 +732,97 @@ std::vector<std::vector<uint8_t>> ReceiveByteVector(NetIO &io, PP &pp, std::vect
     return vec_result; 
 }
 
+/*
+** standard version for fixed-width items stored contiguously:
+** the i-th pair of messages lies in vec_m0/vec_m1[i*ITEM_LEN, (i+1)*ITEM_LEN)
+*/
+void SendBytes(NetIO &io, PP &pp, std::vector<uint8_t> &vec_m0, std::vector<uint8_t> &vec_m1, 
+               size_t ITEM_LEN, size_t EXTEND_LEN) 
+{
+    if(vec_m0.size() != EXTEND_LEN*ITEM_LEN || vec_m1.size() != EXTEND_LEN*ITEM_LEN){
+        std::cerr << "the size of flat message buffer does not match EXTEND_LEN*ITEM_LEN" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    PrintSplitLine('-'); 
+	
+    std::cout << "OTe: sender side" << std::endl; 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+
+    std::vector<block> vec_K0(EXTEND_LEN);
+    std::vector<block> vec_K1(EXTEND_LEN); 
+
+    RandomSend(io, pp, vec_K0, vec_K1, EXTEND_LEN); 
+
+    // begin to transmit the real message: C0 and C1 share one buffer
+    std::vector<uint8_t> vec_outer_C(2*EXTEND_LEN*ITEM_LEN);
+    uint8_t* outer_C0 = vec_outer_C.data(); 
+    uint8_t* outer_C1 = vec_outer_C.data() + EXTEND_LEN*ITEM_LEN; 
+
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < EXTEND_LEN; i++)
+    {
+        OTP::Enc(vec_K0[i], vec_m0.data()+i*ITEM_LEN, outer_C0+i*ITEM_LEN, ITEM_LEN);
+        OTP::Enc(vec_K1[i], vec_m1.data()+i*ITEM_LEN, outer_C1+i*ITEM_LEN, ITEM_LEN);
+    }
+    io.SendBytes(vec_outer_C.data(), vec_outer_C.size());
+
+    std::cout << "ALSZ OTE [step 3]: Sender ===> (vec_C0, vec_C1) ===> Receiver" << " [" 
+              << (double)EXTEND_LEN*ITEM_LEN*2/(1024*1024) << " MB]" << std::endl;
+
+    #ifdef DEBUG
+        std::cout << "ALSZ OTE: Sender sends "<< EXTEND_LEN << " number of ciphertexts to receiver" << std::endl; 
+        PrintSplitLine('*'); 
+    #endif
+
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "ALSZ OTE: Sender side takes time " 
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    PrintSplitLine('-'); 
+}
+
+// the result is a flat buffer of EXTEND_LEN*ITEM_LEN bytes
+std::vector<uint8_t> ReceiveBytes(NetIO &io, PP &pp, std::vector<uint8_t> &vec_receiver_selection_bit, 
+                                  size_t ITEM_LEN, size_t EXTEND_LEN)
+{
+    PrintSplitLine('-'); 
+    
+    auto start_time = std::chrono::steady_clock::now(); 
+
+    std::vector<block> vec_K(EXTEND_LEN); 
+
+    RandomReceive(io, pp, vec_K, vec_receiver_selection_bit, EXTEND_LEN);
+
+    std::vector<uint8_t> vec_outer_C(2*EXTEND_LEN*ITEM_LEN);
+    io.ReceiveBytes(vec_outer_C.data(), vec_outer_C.size());
+
+    std::vector<uint8_t> vec_result(EXTEND_LEN*ITEM_LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < EXTEND_LEN; i++){        
+        // pick C1 when selection bit is 1, C0 otherwise
+        size_t offset = vec_receiver_selection_bit[i]*EXTEND_LEN*ITEM_LEN + i*ITEM_LEN; 
+        OTP::Dec(vec_K[i], vec_outer_C.data()+offset, vec_result.data()+i*ITEM_LEN, ITEM_LEN);
+    }   
+
+    #ifdef DEBUG
+        std::cout << "ALSZ OTE: Receiver gets "<< EXTEND_LEN << " number of ciphertexts from Sender" << std::endl; 
+        PrintSplitLine('*'); 
+    #endif
+
+    std::cout << "ALSZ OTE [step 4]: Receiver obtains vec_m" << std::endl; 
+
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "ALSZ OTE: Receiver side takes time " 
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    PrintSplitLine('-'); 
+
+    return vec_result; 
+}
+
 }
 #endif
@@ -0,0 +1,177 @@
+#ifndef KUNLUN_X25519_PEQT_HPP_
+#define KUNLUN_X25519_PEQT_HPP_
+
+#include "../../include/std.inc"
+#include "../../crypto/ec_25519.hpp"
+#include "../../crypto/hash.hpp"
+#include "../../crypto/prg.hpp"
+#include "../../netio/stream_channel.hpp"
+
+
+/*
+** implement DDH-based PEQT on curve 25519 (x-only Montgomery ladder)
+**
+** compared with DDHPEQT on P-256:
+** 1. items are hashed to 32-byte u-coordinates in AES batches (Hash::BlocksToBytes), and each point is 32 bytes on the wire
+** 2. x25519 clamps scalars, so the receiver cannot strip its mask with r^{-1};
+**    it instead lifts the sender's F_k(y) to the same exponent and compares H(y)^{kr} against H(x)^{rk}
+** 3. the permutation is applied as a gather rather than a random scatter:
+**    output slot p reads input slot row_inverse[p/COLUMN_NUM]*COLUMN_NUM + column_inverse[p%COLUMN_NUM],
+**    so that each thread writes a contiguous output range, and reads stay inside one input row per output row
+** 4. both parties work in chunks of CHUNK_LEN output slots, so that only one chunk of permuted points is alive at a time
+*/
+
+namespace X25519PEQT{
+
+inline const size_t CHUNK_LEN = size_t(1) << 16;
+
+// points are sent as one contiguous array of 32-byte u-coordinates
+static_assert(sizeof(EC25519Point) == 32, "EC25519Point must be a plain 32-byte array");
+
+inline std::vector<uint64_t> InversePermutation(std::vector<uint64_t> &map)
+{
+    std::vector<uint64_t> inverse_map(map.size());
+    for(auto i = 0; i < map.size(); i++) inverse_map[map[i]] = i;
+    return inverse_map;
+}
+
+// returns permutation_map: the i-th item lands at position permutation_map[i] of the receiver's result
+std::vector<uint64_t> Send(NetIO &io, std::vector<block> &vec_Y, size_t ROW_NUM, size_t COLUMN_NUM)
+{
+    PrintSplitLine('-');
+    auto start_time = std::chrono::steady_clock::now();
+
+    size_t LEN = vec_Y.size();
+    if(LEN != ROW_NUM*COLUMN_NUM){
+        std::cerr << "size does not match" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    std::vector<uint8_t> k(32);
+    PRG::GenRandomBytes(seed, k.data(), 32); // pick a key k
+
+    std::vector<uint64_t> row_map(ROW_NUM);
+    for(auto i = 0; i < ROW_NUM; i++) row_map[i] = i;
+    std::shuffle(row_map.begin(), row_map.end(), global_built_in_prg);
+
+    std::vector<uint64_t> column_map(COLUMN_NUM);
+    for(auto j = 0; j < COLUMN_NUM; j++) column_map[j] = j;
+    std::shuffle(column_map.begin(), column_map.end(), global_built_in_prg);
+
+    std::vector<uint64_t> row_inverse_map = InversePermutation(row_map);
+    std::vector<uint64_t> column_inverse_map = InversePermutation(column_map);
+
+    std::vector<uint64_t> permutation_map(LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < ROW_NUM; i++){
+        for(auto j = 0; j < COLUMN_NUM; j++){
+            permutation_map[i*COLUMN_NUM+j] = row_map[i]*COLUMN_NUM + column_map[j];
+        }
+    }
+
+    std::vector<EC25519Point> vec_mask_X(LEN);
+    io.ReceiveEC25519Points(vec_mask_X.data(), LEN);
+
+    std::vector<block> vec_gathered_Y(CHUNK_LEN);
+    std::vector<uint8_t> vec_Hash_Y(32*CHUNK_LEN);
+    std::vector<EC25519Point> vec_Fk_permuted_Y(CHUNK_LEN);
+    std::vector<EC25519Point> vec_Fk_permuted_mask_X(CHUNK_LEN);
+
+    for(size_t BEGIN = 0; BEGIN < LEN; BEGIN += CHUNK_LEN){
+        size_t CURRENT_LEN = std::min(CHUNK_LEN, LEN - BEGIN);
+
+        // gather both inputs of the current chunk of output slots, then hash and exponentiate in place
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < CURRENT_LEN; i++){
+            size_t p = BEGIN + i;
+            size_t source = row_inverse_map[p/COLUMN_NUM]*COLUMN_NUM + column_inverse_map[p%COLUMN_NUM];
+            vec_gathered_Y[i] = vec_Y[source];
+            x25519_scalar_mulx(vec_Fk_permuted_mask_X[i].px, k.data(), vec_mask_X[source].px); // (H(x)^r)^k
+        }
+
+        Hash::BlocksToBytes(vec_gathered_Y.data(), vec_Hash_Y.data(), CURRENT_LEN);
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < CURRENT_LEN; i++){
+            x25519_scalar_mulx(vec_Fk_permuted_Y[i].px, k.data(), vec_Hash_Y.data()+32*i); // H(y)^k
+        }
+
+        io.SendEC25519Points(vec_Fk_permuted_Y.data(), CURRENT_LEN);
+        io.SendEC25519Points(vec_Fk_permuted_mask_X.data(), CURRENT_LEN);
+    }
+
+    std::cout <<"x25519-based PEQT [step 2]: Sender ===> (Permutation[F_k(y_i)], Permutation[F_k(mask_x_i)]) ===> Receiver";
+    std::cout << " [" << (double)2*32*LEN/(1024*1024) << " MB]" << std::endl;
+
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "x25519-based PEQT: Sender side takes time = "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    PrintSplitLine('-');
+
+    return permutation_map;
+}
+
+std::vector<uint8_t> Receive(NetIO &io, std::vector<block> &vec_X, size_t ROW_NUM, size_t COLUMN_NUM)
+{
+    PrintSplitLine('-');
+
+    size_t LEN = vec_X.size();
+    if(LEN != ROW_NUM*COLUMN_NUM){
+        std::cerr << "size does not match" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    std::vector<uint8_t> r(32);
+    PRG::GenRandomBytes(seed, r.data(), 32); // pick a key r
+
+    std::vector<EC25519Point> vec_mask_X(LEN);
+    {
+        std::vector<uint8_t> vec_Hash_X(32*LEN);
+        Hash::BlocksToBytes(vec_X.data(), vec_Hash_X.data(), LEN);
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < LEN; i++){
+            x25519_scalar_mulx(vec_mask_X[i].px, r.data(), vec_Hash_X.data()+32*i); // H(x)^r
+        }
+    }
+
+    io.SendEC25519Points(vec_mask_X.data(), LEN);
+    std::vector<EC25519Point>().swap(vec_mask_X);
+
+    std::cout <<"x25519-based PEQT [step 1]: Receiver ===> mask_x_i ===> Sender";
+    std::cout << " [" << (double)32*LEN/(1024*1024) << " MB]" << std::endl;
+
+    std::vector<EC25519Point> vec_Fk_permuted_Y(CHUNK_LEN);
+    std::vector<EC25519Point> vec_Fk_permuted_mask_X(CHUNK_LEN);
+    std::vector<uint8_t> vec_result(LEN);
+
+    for(size_t BEGIN = 0; BEGIN < LEN; BEGIN += CHUNK_LEN){
+        size_t CURRENT_LEN = std::min(CHUNK_LEN, LEN - BEGIN);
+        io.ReceiveEC25519Points(vec_Fk_permuted_Y.data(), CURRENT_LEN);
+        io.ReceiveEC25519Points(vec_Fk_permuted_mask_X.data(), CURRENT_LEN);
+
+        // compare (H(y)^k)^r with (H(x)^r)^k
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < CURRENT_LEN; i++){
+            EC25519Point Fkr_Y;
+            x25519_scalar_mulx(Fkr_Y.px, r.data(), vec_Fk_permuted_Y[i].px);
+            vec_result[BEGIN+i] = Fkr_Y.CompareTo(vec_Fk_permuted_mask_X[i]);
+        }
+    }
+
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "x25519-based PEQT: Receiver side takes time = "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    PrintSplitLine('-');
+
+    return vec_result;
+}
+
+}
+#endif
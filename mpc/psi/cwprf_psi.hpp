@@ -6,8 +6,10 @@
 #include "../../crypto/prg.hpp"
 #include "../../crypto/block.hpp"
 #include "../../netio/stream_channel.hpp"
+#include "../../netio/pipeline.hpp"
 #include "../../filter/bloom_filter.hpp"
 #include "../../utility/serialization.hpp"
+#include "../../utility/flat_intersection.hpp"
 
 
 /*
@@ -43,6 +45,8 @@ struct PP
     size_t LOG_RECEIVER_ITEM_NUM; 
     size_t RECEIVER_ITEM_NUM; 
     size_t TRUNCATE_LEN; // the truncate length of PRF value
+    std::string intersection_engine; // hashset, sortmerge
+    size_t CHUNK_ITEM_NUM; // 0 means batch mode, otherwise process and transmit CHUNK_ITEM_NUM items at a time
 };
 
 // seriazlize
@@ -55,6 +59,8 @@ std::ofstream &operator<<(std::ofstream &fout, const PP &pp)
     fout << pp.LOG_RECEIVER_ITEM_NUM;
     fout << pp.RECEIVER_ITEM_NUM; 
     fout << pp.TRUNCATE_LEN; 
+    fout << pp.intersection_engine; 
+    fout << pp.CHUNK_ITEM_NUM; 
     return fout; 
 }
 
@@ -68,6 +74,8 @@ std::ifstream &operator>>(std::ifstream &fin, PP &pp)
     fin >> pp.LOG_RECEIVER_ITEM_NUM;
     fin >> pp.RECEIVER_ITEM_NUM; 
     fin >> pp.TRUNCATE_LEN; 
+    fin >> pp.intersection_engine; 
+    fin >> pp.CHUNK_ITEM_NUM; 
 
     return fin; 
 }
@@ -75,7 +83,9 @@ std::ifstream &operator>>(std::ifstream &fin, PP &pp)
 PP Setup(size_t computational_security_parameter, 
          size_t statistical_security_parameter, 
          size_t LOG_SENDER_ITEM_NUM, 
-         size_t LOG_RECEIVER_ITEM_NUM)
+         size_t LOG_RECEIVER_ITEM_NUM, 
+         std::string intersection_engine = "sortmerge", 
+         size_t CHUNK_ITEM_NUM = 0)
 {
     PP pp; 
     pp.statistical_security_parameter = statistical_security_parameter;
@@ -89,6 +99,21 @@ PP Setup(size_t computational_security_parameter,
     ** page 10 for this parameter choice
     */
     pp.TRUNCATE_LEN = (pp.statistical_security_parameter+pp.LOG_SENDER_ITEM_NUM+pp.LOG_RECEIVER_ITEM_NUM+7)/8; 
+
+    /*
+    ** hashset: insert truncated values as std::string into std::unordered_set
+    ** sortmerge: keep truncated values as fixed-width integers, then do radix partition + sort-merge
+    */
+    if(intersection_engine != "hashset" && intersection_engine != "sortmerge"){
+        std::cerr << "unknown intersection engine: " << intersection_engine << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+    if(intersection_engine == "sortmerge" && pp.TRUNCATE_LEN > sizeof(FlatIntersection::uint128_t)){
+        std::cerr << "TRUNCATE_LEN exceeds 16 bytes, switch to hashset engine" << std::endl;
+        intersection_engine = "hashset"; 
+    }
+    pp.intersection_engine = intersection_engine; 
+    pp.CHUNK_ITEM_NUM = CHUNK_ITEM_NUM; 
     
     return pp; 
 }
@@ -117,6 +142,191 @@ void FetchPP(PP &pp, std::string pp_filename)
     fin.close(); 
 }
 
+// return the indices of query values that appear in set values, both are truncated PRF values stored in flat buffers 
+std::vector<size_t> IntersectTruncatedValues(PP &pp, const uint8_t* set_data, size_t SET_NUM, size_t SET_STRIDE, 
+                                             const uint8_t* query_data, size_t QUERY_NUM)
+{
+    std::vector<size_t> vec_index; 
+    if(pp.intersection_engine == "hashset"){
+        std::unordered_set<std::string> S;
+        for(auto i = 0; i < SET_NUM; i++){
+            S.insert(std::string(set_data + i*SET_STRIDE, set_data + i*SET_STRIDE + pp.TRUNCATE_LEN)); 
+        }
+        for(auto i = 0; i < QUERY_NUM; i++){
+            std::string str(query_data + i*pp.TRUNCATE_LEN, query_data + (i+1)*pp.TRUNCATE_LEN); 
+            if(S.find(str) != S.end()) vec_index.emplace_back(i); 
+        }
+    }
+    else if(pp.TRUNCATE_LEN <= sizeof(uint64_t)){
+        std::vector<uint64_t> vec_set = FlatIntersection::PackKeys<uint64_t>(
+            set_data, SET_NUM, SET_STRIDE, pp.TRUNCATE_LEN); 
+        std::vector<uint64_t> vec_query = FlatIntersection::PackKeys<uint64_t>(
+            query_data, QUERY_NUM, pp.TRUNCATE_LEN, pp.TRUNCATE_LEN); 
+        vec_index = FlatIntersection::SortMergeIntersect(vec_set, vec_query); 
+    }
+    else{
+        std::vector<FlatIntersection::uint128_t> vec_set = FlatIntersection::PackKeys<FlatIntersection::uint128_t>(
+            set_data, SET_NUM, SET_STRIDE, pp.TRUNCATE_LEN); 
+        std::vector<FlatIntersection::uint128_t> vec_query = FlatIntersection::PackKeys<FlatIntersection::uint128_t>(
+            query_data, QUERY_NUM, pp.TRUNCATE_LEN, pp.TRUNCATE_LEN); 
+        vec_index = FlatIntersection::SortMergeIntersect(vec_set, vec_query); 
+    }
+    return vec_index; 
+}
+
+/*
+** streaming mode: the same protocol, but every stage is processed and transmitted chunk by chunk
+** the computation of the next chunk overlaps the transmission of the current chunk (see netio/pipeline.hpp)
+** only two chunks of EC points are alive on either side; the receiver additionally keeps the truncated values
+** step 1: Sender ===> F_k1(y_i) ===> Receiver, the receiver immediately turns each chunk to Truncate(F_k2k1(y_i))
+** step 2&3: Receiver ===> F_k2(x_i) ===> Sender, after getting chunk j+1, the sender returns Truncate(F_k1k2(x_i)) of chunk j
+*/
+void StreamSend(NetIO &io, PP &pp, std::vector<block> &vec_Y)
+{
+    PrintSplitLine('-'); 
+    auto start_time = std::chrono::steady_clock::now(); 
+
+    uint8_t k1[32];
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); // initialize PRG
+    GenRandomBytes(seed, k1, 32);  // pick a key k1
+
+    size_t CHUNK_LEN = pp.CHUNK_ITEM_NUM; 
+    std::vector<EC25519Point> vec_buffer[2] = {std::vector<EC25519Point>(CHUNK_LEN), std::vector<EC25519Point>(CHUNK_LEN)}; 
+
+    // step 1: compute F_k1(y_i) of chunk j+1 while sending chunk j
+    size_t CHUNK_NUM = Pipeline::ChunkNum(pp.SENDER_ITEM_NUM, CHUNK_LEN); 
+    auto ComputeFk1Y = [&](size_t j, size_t k){
+        size_t BEGIN = j*CHUNK_LEN; 
+        size_t LEN = Pipeline::ChunkLen(pp.SENDER_ITEM_NUM, CHUNK_LEN, j); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < LEN; i++){
+            EC25519Point Hash_Y; 
+            Hash::BlockToBytes(vec_Y[BEGIN+i], Hash_Y.px, 32); 
+            x25519_scalar_mulx(vec_buffer[k][i].px, k1, Hash_Y.px); 
+        }
+    }; 
+    auto SendFk1Y = [&](size_t j, size_t k){
+        io.SendEC25519Points(vec_buffer[k].data(), Pipeline::ChunkLen(pp.SENDER_ITEM_NUM, CHUNK_LEN, j)); 
+    }; 
+    Pipeline::Send(CHUNK_NUM, ComputeFk1Y, SendFk1Y); 
+
+    std::cout <<"cwPRF-based PSI [step 1]: Sender ===> F_k1(y_i) ===> Receiver";
+    std::cout << " [" << 32*pp.SENDER_ITEM_NUM/(1024*1024) << " MB]" << std::endl;
+
+    // step 2&3: receive F_k2(x_i) of chunk j+1, meanwhile compute Truncate(F_k1k2(x_i)) of chunk j
+    CHUNK_NUM = Pipeline::ChunkNum(pp.RECEIVER_ITEM_NUM, CHUNK_LEN); 
+    std::vector<uint8_t> vec_truncate_buffer[2] = {std::vector<uint8_t>(CHUNK_LEN*pp.TRUNCATE_LEN), 
+                                                   std::vector<uint8_t>(CHUNK_LEN*pp.TRUNCATE_LEN)}; 
+    auto ComputeTruncateFk1k2X = [&](size_t j, size_t k){
+        size_t LEN = Pipeline::ChunkLen(pp.RECEIVER_ITEM_NUM, CHUNK_LEN, j); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < LEN; i++){
+            EC25519Point Fk1k2_X; 
+            x25519_scalar_mulx(Fk1k2_X.px, k1, vec_buffer[k][i].px); // (H(x_i)^k2)^k1
+            memcpy(vec_truncate_buffer[k].data() + i*pp.TRUNCATE_LEN, Fk1k2_X.px, pp.TRUNCATE_LEN); 
+        }
+    }; 
+
+    std::thread worker; 
+    for(auto j = 0; j < CHUNK_NUM; j++){
+        io.ReceiveEC25519Points(vec_buffer[j%2].data(), Pipeline::ChunkLen(pp.RECEIVER_ITEM_NUM, CHUNK_LEN, j)); 
+        if(j > 0){
+            worker.join(); 
+            io.SendBytes(vec_truncate_buffer[(j-1)%2].data(), Pipeline::ChunkLen(pp.RECEIVER_ITEM_NUM, CHUNK_LEN, j-1)*pp.TRUNCATE_LEN); 
+        }
+        worker = std::thread(ComputeTruncateFk1k2X, j, j%2); 
+    }
+    if(CHUNK_NUM > 0){
+        worker.join(); 
+        io.SendBytes(vec_truncate_buffer[(CHUNK_NUM-1)%2].data(), 
+                     Pipeline::ChunkLen(pp.RECEIVER_ITEM_NUM, CHUNK_LEN, CHUNK_NUM-1)*pp.TRUNCATE_LEN); 
+    }
+
+    std::cout <<"cwPRF-based PSI [step 3]: Sender ===> Truncate(F_k1k2(x_i)) ===> Receiver";
+    std::cout << " [" << pp.TRUNCATE_LEN*pp.RECEIVER_ITEM_NUM/(1024*1024) << " MB]" << std::endl;
+
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "cwPRF-based PSI (streaming): Sender side takes time = " 
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    
+    PrintSplitLine('-'); 
+}
+
+std::vector<block> StreamReceive(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+{
+    PrintSplitLine('-'); 
+    auto start_time = std::chrono::steady_clock::now(); 
+
+    uint8_t k2[32];
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); // initialize PRG
+    GenRandomBytes(seed, k2, 32);  // pick a key k2
+
+    size_t CHUNK_LEN = pp.CHUNK_ITEM_NUM; 
+    std::vector<EC25519Point> vec_buffer[2] = {std::vector<EC25519Point>(CHUNK_LEN), std::vector<EC25519Point>(CHUNK_LEN)}; 
+
+    // step 1: receive F_k1(y_i) of chunk j+1, meanwhile compute Truncate(F_k2k1(y_i)) of chunk j
+    std::vector<uint8_t> vec_TRUNCATE_Fk2k1_Y(pp.SENDER_ITEM_NUM*pp.TRUNCATE_LEN); 
+    size_t CHUNK_NUM = Pipeline::ChunkNum(pp.SENDER_ITEM_NUM, CHUNK_LEN); 
+    auto ReceiveFk1Y = [&](size_t j, size_t k){
+        io.ReceiveEC25519Points(vec_buffer[k].data(), Pipeline::ChunkLen(pp.SENDER_ITEM_NUM, CHUNK_LEN, j)); 
+    }; 
+    auto ComputeTruncateFk2k1Y = [&](size_t j, size_t k){
+        size_t BEGIN = j*CHUNK_LEN; 
+        size_t LEN = Pipeline::ChunkLen(pp.SENDER_ITEM_NUM, CHUNK_LEN, j); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < LEN; i++){
+            EC25519Point Fk2k1_Y; 
+            x25519_scalar_mulx(Fk2k1_Y.px, k2, vec_buffer[k][i].px); // (H(y_i)^k1)^k2
+            memcpy(vec_TRUNCATE_Fk2k1_Y.data() + (BEGIN+i)*pp.TRUNCATE_LEN, Fk2k1_Y.px, pp.TRUNCATE_LEN); 
+        }
+    }; 
+    Pipeline::Receive(CHUNK_NUM, ReceiveFk1Y, ComputeTruncateFk2k1Y); 
+
+    // step 2&3: compute F_k2(x_i) of chunk j+1 while sending chunk j, then collect Truncate(F_k1k2(x_i)) of chunk j-1
+    std::vector<uint8_t> vec_TRUNCATE_Fk1k2_X(pp.RECEIVER_ITEM_NUM*pp.TRUNCATE_LEN); 
+    CHUNK_NUM = Pipeline::ChunkNum(pp.RECEIVER_ITEM_NUM, CHUNK_LEN); 
+    auto ComputeFk2X = [&](size_t j, size_t k){
+        size_t BEGIN = j*CHUNK_LEN; 
+        size_t LEN = Pipeline::ChunkLen(pp.RECEIVER_ITEM_NUM, CHUNK_LEN, j); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < LEN; i++){
+            EC25519Point Hash_X; 
+            Hash::BlockToBytes(vec_X[BEGIN+i], Hash_X.px, 32); 
+            x25519_scalar_mulx(vec_buffer[k][i].px, k2, Hash_X.px); 
+        }
+    }; 
+    auto ReceiveTruncateFk1k2X = [&](size_t j){
+        io.ReceiveBytes(vec_TRUNCATE_Fk1k2_X.data() + j*CHUNK_LEN*pp.TRUNCATE_LEN, 
+                        Pipeline::ChunkLen(pp.RECEIVER_ITEM_NUM, CHUNK_LEN, j)*pp.TRUNCATE_LEN); 
+    }; 
+    auto SendFk2X = [&](size_t j, size_t k){
+        io.SendEC25519Points(vec_buffer[k].data(), Pipeline::ChunkLen(pp.RECEIVER_ITEM_NUM, CHUNK_LEN, j)); 
+        if(j > 0) ReceiveTruncateFk1k2X(j-1); 
+    }; 
+    Pipeline::Send(CHUNK_NUM, ComputeFk2X, SendFk2X); 
+    if(CHUNK_NUM > 0) ReceiveTruncateFk1k2X(CHUNK_NUM-1); 
+
+    std::cout <<"cwPRF-based PSI [step 2]: Receiver ===> F_k2(x_i) ===> Sender"; 
+    std::cout << " [" << 32*pp.RECEIVER_ITEM_NUM/(1024*1024) << " MB]" << std::endl;
+
+    std::vector<size_t> vec_index = IntersectTruncatedValues(pp, vec_TRUNCATE_Fk2k1_Y.data(), pp.SENDER_ITEM_NUM, pp.TRUNCATE_LEN, 
+                                                             vec_TRUNCATE_Fk1k2_X.data(), pp.RECEIVER_ITEM_NUM); 
+    std::vector<block> vec_intersection; 
+    for(auto i = 0; i < vec_index.size(); i++){
+        vec_intersection.emplace_back(vec_X[vec_index[i]]); 
+    }
+
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "cwPRF-based PSI (streaming): Receiver side takes time = " 
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    PrintSplitLine('-'); 
+    
+    return vec_intersection; 
+}
+
 void Send(NetIO &io, PP &pp, std::vector<block> &vec_Y)
 {
     if(vec_Y.size() != pp.SENDER_ITEM_NUM){
@@ -124,6 +334,8 @@ void Send(NetIO &io, PP &pp, std::vector<block> &vec_Y)
         exit(1);  // EXIT_FAILURE  
     }
 
+    if(pp.CHUNK_ITEM_NUM != 0) return StreamSend(io, pp, vec_Y); 
+
     PrintSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -154,13 +366,24 @@ void Send(NetIO &io, PP &pp, std::vector<block> &vec_Y)
         x25519_scalar_mulx(vec_Fk1k2_X[i].px, k1, vec_Fk2_X[i].px); // (H(x_i)^k2)^k1
     }
 
-    std::vector<std::string> vec_TRUNCATE_Fk1k2_X(pp.RECEIVER_ITEM_NUM);
-    for(auto i = 0; i < pp.RECEIVER_ITEM_NUM; i++){ 
-        vec_TRUNCATE_Fk1k2_X[i] = 
-            std::string(&vec_Fk1k2_X[i].px[0], &vec_Fk1k2_X[i].px[0]+pp.TRUNCATE_LEN); 
+    if(pp.intersection_engine == "hashset"){
+        std::vector<std::string> vec_TRUNCATE_Fk1k2_X(pp.RECEIVER_ITEM_NUM);
+        for(auto i = 0; i < pp.RECEIVER_ITEM_NUM; i++){ 
+            vec_TRUNCATE_Fk1k2_X[i] = 
+                std::string(&vec_Fk1k2_X[i].px[0], &vec_Fk1k2_X[i].px[0]+pp.TRUNCATE_LEN); 
+        }
+        io.SendStringVector(vec_TRUNCATE_Fk1k2_X, pp.TRUNCATE_LEN); 
+    }
+    else{
+        // same wire format as SendStringVector, but skip the per-item string allocation
+        std::vector<uint8_t> vec_TRUNCATE_Fk1k2_X(pp.TRUNCATE_LEN*pp.RECEIVER_ITEM_NUM);
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < pp.RECEIVER_ITEM_NUM; i++){ 
+            memcpy(vec_TRUNCATE_Fk1k2_X.data()+i*pp.TRUNCATE_LEN, vec_Fk1k2_X[i].px, pp.TRUNCATE_LEN); 
+        }
+        io.SendInteger(pp.RECEIVER_ITEM_NUM); 
+        io.SendBytes(vec_TRUNCATE_Fk1k2_X.data(), vec_TRUNCATE_Fk1k2_X.size()); 
     }
-
-    io.SendStringVector(vec_TRUNCATE_Fk1k2_X, pp.TRUNCATE_LEN); 
     std::cout <<"cwPRF-based PSI [step 3]: Sender ===> Truncate(F_k1k2(x_i)) ===> Receiver";
     std::cout << " [" << pp.TRUNCATE_LEN*pp.RECEIVER_ITEM_NUM/(1024*1024) << " MB]" << std::endl;
 
@@ -178,6 +401,8 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_X)
         std::cerr << "input size of vec_X does not match public parameters" << std::endl;
         exit(1);  // EXIT_FAILURE  
     }
+
+    if(pp.CHUNK_ITEM_NUM != 0) return StreamReceive(io, pp, vec_X); 
     
     PrintSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
@@ -211,17 +436,36 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_X)
         x25519_scalar_mulx(vec_Fk2k1_Y[i].px, k2, vec_Fk1_Y[i].px); // (H(x_i)^k2)^k1
     }
 
-    std::vector<std::string> vec_TRUNCATE_Fk1k2_X; 
-    io.ReceiveStringVector(vec_TRUNCATE_Fk1k2_X, pp.TRUNCATE_LEN); 
-    std::unordered_set<std::string> S;
-    for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++){
-        S.insert(std::string(&vec_Fk2k1_Y[i].px[0], &vec_Fk2k1_Y[i].px[0]+pp.TRUNCATE_LEN)); 
+    std::vector<block> vec_intersection; 
+    if(pp.intersection_engine == "hashset"){
+        std::vector<std::string> vec_TRUNCATE_Fk1k2_X; 
+        io.ReceiveStringVector(vec_TRUNCATE_Fk1k2_X, pp.TRUNCATE_LEN); 
+        std::unordered_set<std::string> S;
+        for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++){
+            S.insert(std::string(&vec_Fk2k1_Y[i].px[0], &vec_Fk2k1_Y[i].px[0]+pp.TRUNCATE_LEN)); 
+        }
+
+        for(auto i = 0; i < pp.RECEIVER_ITEM_NUM; i++){
+            if(S.find(vec_TRUNCATE_Fk1k2_X[i]) != S.end()){
+                vec_intersection.emplace_back(vec_X[i]); 
+            }
+        }
     }
+    else{
+        size_t NUM; 
+        io.ReceiveInteger(NUM);
+        // NUM comes from the peer, and the returned indices address vec_X
+        if(NUM != pp.RECEIVER_ITEM_NUM){
+            std::cerr << "number of received truncated values does not match public parameters" << std::endl;
+            exit(1);  // EXIT_FAILURE
+        }
+        std::vector<uint8_t> vec_TRUNCATE_Fk1k2_X(pp.TRUNCATE_LEN*NUM); 
+        io.ReceiveBytes(vec_TRUNCATE_Fk1k2_X.data(), vec_TRUNCATE_Fk1k2_X.size()); 
 
-    std::vector<block> vec_intersection; 
-    for(auto i = 0; i < pp.RECEIVER_ITEM_NUM; i++){
-        if(S.find(vec_TRUNCATE_Fk1k2_X[i]) != S.end()){
-            vec_intersection.emplace_back(vec_X[i]); 
+        std::vector<size_t> vec_index = IntersectTruncatedValues(pp, vec_Fk2k1_Y[0].px, pp.SENDER_ITEM_NUM, sizeof(EC25519Point), 
+                                                                 vec_TRUNCATE_Fk1k2_X.data(), NUM); 
+        for(auto i = 0; i < vec_index.size(); i++){
+            vec_intersection.emplace_back(vec_X[vec_index[i]]); 
         }
     }
     
@@ -0,0 +1,277 @@
+#ifndef KUNLUN_LABELED_PSI_HPP_
+#define KUNLUN_LABELED_PSI_HPP_
+
+#include "../oprf/vole_oprf.hpp"
+
+/*
+** labeled PSI (PSI with payload) built on VOLE-based OPRF and Baxos OKVS
+** sender holds (y_i, label_i) with fixed-length labels, receiver holds x_j
+** receiver learns label_i for every x_j = y_i, and nothing else beyond the intersection
+**
+** 1. receiver acts as OPRF client on X and obtains F(x_j), sender acts as OPRF server and evaluates F(y_i)
+** 2. each OPRF value seeds a mask stream: block 0 masks the OKVS value, blocks 1, 2, ... mask the label
+** 3. sender picks a random permutation pi, puts label_i xor mask_i at position pi(i) of the label table,
+**    and encodes y_i -> (0^96 || pi(i)) xor okvs_mask_i into a Baxos OKVS
+** 4. receiver decodes the OKVS at x_j, unmasks it with F(x_j), accepts iff the 96-bit zero tag matches,
+**    then unmasks the label at the decoded position
+**
+** Baxos only carries 128-bit values, so the label itself lives in the permuted table and the OKVS carries
+** a masked pointer: one OKVS solve regardless of LABEL_LEN, and the position leaks nothing since pi is random
+** a false match happens with probability RECEIVER_ITEM_NUM/2^96 <= 2^{-statistical_security_parameter}
+*/
+
+namespace LabeledPSI{
+
+using Serialization::operator<<;
+using Serialization::operator>>;
+
+inline const size_t TAG_LEN = 12; // byte length of the zero tag in each OKVS value
+
+struct PP
+{
+    VOLEOPRF::PP oprf_part; // OPRF on receiver's items
+
+    size_t okvs_bin_size;    // the bin size in multi-threaded OKVS
+    Baxos<gf_128> okvs;      // OKVS on sender's items
+    size_t okvs_output_size; // the size of the OKVS encoding
+
+    size_t statistical_security_parameter;
+    size_t LABEL_LEN; // byte length of each label
+    size_t LOG_SENDER_ITEM_NUM;
+    size_t LOG_RECEIVER_ITEM_NUM;
+    size_t SENDER_ITEM_NUM;
+    size_t RECEIVER_ITEM_NUM;
+
+    size_t thread_num;
+};
+
+// serialize
+std::ofstream &operator<<(std::ofstream &fout, const PP &pp)
+{
+    fout << pp.oprf_part;
+    fout << pp.okvs_bin_size;
+    fout << pp.okvs;
+    fout << pp.okvs_output_size;
+    fout << pp.statistical_security_parameter;
+    fout << pp.LABEL_LEN;
+    fout << pp.LOG_SENDER_ITEM_NUM;
+    fout << pp.LOG_RECEIVER_ITEM_NUM;
+    fout << pp.SENDER_ITEM_NUM;
+    fout << pp.RECEIVER_ITEM_NUM;
+    fout << pp.thread_num;
+    return fout;
+}
+
+// load pp from file
+std::ifstream &operator>>(std::ifstream &fin, PP &pp)
+{
+    fin >> pp.oprf_part;
+    fin >> pp.okvs_bin_size;
+    fin >> pp.okvs;
+    fin >> pp.okvs_output_size;
+    fin >> pp.statistical_security_parameter;
+    fin >> pp.LABEL_LEN;
+    fin >> pp.LOG_SENDER_ITEM_NUM;
+    fin >> pp.LOG_RECEIVER_ITEM_NUM;
+    fin >> pp.SENDER_ITEM_NUM;
+    fin >> pp.RECEIVER_ITEM_NUM;
+    fin >> pp.thread_num;
+    return fin;
+}
+
+PP Setup(size_t statistical_security_parameter, size_t LOG_SENDER_ITEM_NUM, size_t LOG_RECEIVER_ITEM_NUM, size_t LABEL_LEN)
+{
+    if(statistical_security_parameter + LOG_RECEIVER_ITEM_NUM > 8*TAG_LEN){
+        std::cerr << "the zero tag is too short for the given parameters" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+    if(LOG_SENDER_ITEM_NUM > 32){
+        std::cerr << "the number of sender's items exceeds 2^32" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+    if(LABEL_LEN == 0){
+        std::cerr << "label length must be positive" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    PP pp;
+    pp.statistical_security_parameter = statistical_security_parameter;
+    pp.LABEL_LEN = LABEL_LEN;
+    pp.LOG_SENDER_ITEM_NUM = LOG_SENDER_ITEM_NUM;
+    pp.LOG_RECEIVER_ITEM_NUM = LOG_RECEIVER_ITEM_NUM;
+    pp.SENDER_ITEM_NUM = size_t(pow(2, pp.LOG_SENDER_ITEM_NUM));
+    pp.RECEIVER_ITEM_NUM = size_t(pow(2, pp.LOG_RECEIVER_ITEM_NUM));
+
+    pp.oprf_part = VOLEOPRF::Setup(LOG_RECEIVER_ITEM_NUM, statistical_security_parameter);
+
+    pp.okvs_bin_size = 1ull << 15;
+    pp.okvs = Baxos<gf_128>(pp.SENDER_ITEM_NUM, pp.okvs_bin_size, 3, statistical_security_parameter);
+    pp.okvs_output_size = pp.okvs.bin_num * pp.okvs.total_size;
+
+    pp.thread_num = NUMBER_OF_THREADS;
+
+    return pp;
+}
+
+void SavePP(PP &pp, std::string pp_filename)
+{
+    std::ofstream fout;
+    fout.open(pp_filename, std::ios::binary);
+    if(!fout){
+        std::cerr << pp_filename << " open error" << std::endl;
+        exit(1);
+    }
+    fout << pp;
+    fout.close();
+}
+
+void FetchPP(PP &pp, std::string pp_filename)
+{
+    std::ifstream fin;
+    fin.open(pp_filename, std::ios::binary);
+    if(!fin){
+        std::cerr << pp_filename << " open error" << std::endl;
+        exit(1);
+    }
+    fin >> pp;
+    fin.close();
+}
+
+// block 0 of the mask stream seeded by the OPRF value
+inline block OKVSMask(const block &prf_value)
+{
+    PRG::Seed seed = PRG::SetSeed(&prf_value, 0);
+    return PRG::GenRandomBlocks(seed, 1)[0];
+}
+
+// blocks 1, 2, ... of the mask stream seeded by the OPRF value, truncated to LABEL_LEN bytes
+inline void LabelMask(const block &prf_value, uint8_t* mask, size_t LABEL_LEN)
+{
+    PRG::Seed seed = PRG::SetSeed(&prf_value, 0);
+    seed.counter = 1;
+    PRG::GenRandomBytes(seed, mask, LABEL_LEN);
+}
+
+/*
+** vec_label is a flat buffer of SENDER_ITEM_NUM*LABEL_LEN bytes: the label of vec_Y[i] starts at i*LABEL_LEN
+*/
+void Send(NetIO &io, PP &pp, std::vector<block> &vec_Y, std::vector<uint8_t> &vec_label)
+{
+    if(vec_Y.size() != pp.SENDER_ITEM_NUM || vec_label.size() != pp.SENDER_ITEM_NUM*pp.LABEL_LEN){
+        std::cerr << "|Y| or |label| does not match public parameter" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    PrintSplitLine('-');
+    auto start_time = std::chrono::steady_clock::now();
+
+    // step 1: act as OPRF server and evaluate F(y_i)
+    std::vector<uint8_t> oprf_key = VOLEOPRF::Server(io, pp.oprf_part);
+    std::vector<block> vec_Fk_Y = V8ToBlock(VOLEOPRF::Evaluate(pp.oprf_part, oprf_key, vec_Y, pp.SENDER_ITEM_NUM));
+
+    // step 2: mask the pointers and the labels
+    std::vector<uint32_t> vec_position(pp.SENDER_ITEM_NUM);
+    for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++) vec_position[i] = i;
+    std::shuffle(vec_position.begin(), vec_position.end(), global_built_in_prg);
+
+    std::vector<block> vec_okvs_value(pp.SENDER_ITEM_NUM);
+    std::vector<uint8_t> vec_label_table(pp.SENDER_ITEM_NUM*pp.LABEL_LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++){
+        vec_okvs_value[i] = OKVSMask(vec_Fk_Y[i]) ^ Block::MakeBlock(0LL, vec_position[i]);
+        uint8_t* ct = vec_label_table.data() + vec_position[i]*pp.LABEL_LEN;
+        LabelMask(vec_Fk_Y[i], ct, pp.LABEL_LEN);
+        const uint8_t* label = vec_label.data() + i*pp.LABEL_LEN;
+        for(auto k = 0; k < pp.LABEL_LEN; k++) ct[k] ^= label[k];
+    }
+
+    // step 3: encode y_i -> masked pointer under a fresh OKVS seed
+    PRG::Seed seed = PRG::SetSeed();
+    block seed_r = PRG::GenRandomBlocks(seed, 1)[0];
+    pp.okvs.seed = PRG::SetSeed(&seed_r, 0);
+    std::vector<block> vec_P(pp.okvs_output_size);
+    pp.okvs.solve(vec_Y, vec_okvs_value, vec_P, nullptr, pp.thread_num);
+
+    io.SendBlock(seed_r);
+    io.SendBlocks(vec_P.data(), vec_P.size());
+    io.SendBytes(vec_label_table.data(), vec_label_table.size());
+
+    std::cout << "labeled PSI: Sender ===> (OKVS, label table) ===> Receiver ["
+              << (double)(16*vec_P.size() + vec_label_table.size())/(1024*1024) << " MB]" << std::endl;
+
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "labeled PSI: Sender side takes time = "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    PrintSplitLine('-');
+}
+
+/*
+** return the indices (in ascending order) of the items in vec_X that lie in the intersection
+** vec_label is filled with their labels in the same order, LABEL_LEN bytes each
+*/
+std::vector<size_t> Receive(NetIO &io, PP &pp, std::vector<block> &vec_X, std::vector<uint8_t> &vec_label)
+{
+    if(vec_X.size() != pp.RECEIVER_ITEM_NUM){
+        std::cerr << "|X| does not match public parameter" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    PrintSplitLine('-');
+    auto start_time = std::chrono::steady_clock::now();
+
+    // step 1: act as OPRF client and obtain F(x_j)
+    std::vector<block> vec_Fk_X = V8ToBlock(VOLEOPRF::Client(io, pp.oprf_part, vec_X, pp.RECEIVER_ITEM_NUM));
+
+    // step 2: receive the OKVS and the label table
+    block seed_r;
+    io.ReceiveBlock(seed_r);
+    pp.okvs.seed = PRG::SetSeed(&seed_r, 0);
+    std::vector<block> vec_P(pp.okvs_output_size);
+    io.ReceiveBlocks(vec_P.data(), vec_P.size());
+    std::vector<uint8_t> vec_label_table(pp.SENDER_ITEM_NUM*pp.LABEL_LEN);
+    io.ReceiveBytes(vec_label_table.data(), vec_label_table.size());
+
+    // step 3: decode at x_j and check the zero tag
+    std::vector<block> vec_decode(pp.RECEIVER_ITEM_NUM);
+    pp.okvs.decode(vec_X, vec_decode, vec_P, pp.thread_num);
+
+    std::vector<int64_t> vec_position(pp.RECEIVER_ITEM_NUM, -1);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto j = 0; j < pp.RECEIVER_ITEM_NUM; j++){
+        block pointer = vec_decode[j] ^ OKVSMask(vec_Fk_X[j]);
+        uint64_t word[2];
+        memcpy(word, &pointer, sizeof(block));
+        if(word[1] == 0 && (word[0] >> 32) == 0 && word[0] < pp.SENDER_ITEM_NUM) vec_position[j] = word[0];
+    }
+
+    std::vector<size_t> vec_index;
+    for(auto j = 0; j < pp.RECEIVER_ITEM_NUM; j++){
+        if(vec_position[j] >= 0) vec_index.emplace_back(j);
+    }
+
+    // step 4: unmask the labels of the intersection
+    vec_label.resize(vec_index.size()*pp.LABEL_LEN);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto t = 0; t < vec_index.size(); t++){
+        size_t j = vec_index[t];
+        uint8_t* label = vec_label.data() + t*pp.LABEL_LEN;
+        LabelMask(vec_Fk_X[j], label, pp.LABEL_LEN);
+        const uint8_t* ct = vec_label_table.data() + vec_position[j]*pp.LABEL_LEN;
+        for(auto k = 0; k < pp.LABEL_LEN; k++) label[k] ^= ct[k];
+    }
+
+    std::cout << "labeled PSI: intersection size = " << vec_index.size() << std::endl;
+
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "labeled PSI: Receiver side takes time = "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    PrintSplitLine('-');
+
+    return vec_index;
+}
+
+}
+
+#endif
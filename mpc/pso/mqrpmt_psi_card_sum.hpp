@@ -115,6 +115,83 @@ void FetchPP(PP &pp, std::string pp_filename)
     fin.close(); 
 }
 
+// sum bounds of at most 64 bits are handled natively over Z_{2^k} with uint64_t, wider ones fall back to BigInt
+inline bool UseNativeRing(const PP &pp)
+{
+    return pp.LOG_SUM_BOUND <= 64; 
+}
+
+inline uint64_t RingMask(size_t LOG_SUM_BOUND)
+{
+    return (LOG_SUM_BOUND >= 64) ? ~uint64_t(0) : (uint64_t(1) << LOG_SUM_BOUND) - 1; 
+}
+
+// Z_{2^k} fast path: values and masks are plain uint64_t, each share occupies LOG_SUM_BOUND/8 bytes on the wire
+std::tuple<size_t, uint64_t> Send(NetIO &io, PP &pp, std::vector<block> &vec_X, std::vector<uint64_t> &vec_v) 
+{
+    if(vec_X.size() != pp.SENDER_ITEM_NUM || vec_v.size() != pp.SENDER_ITEM_NUM){
+        std::cerr << "|X| does not match public parameter" << std::endl; 
+        exit(1); // EXIT_FAILURE 
+    }
+    if(UseNativeRing(pp) == false){
+        std::cerr << "LOG_SUM_BOUND exceeds 64: use the BigInt interface" << std::endl; 
+        exit(1); // EXIT_FAILURE 
+    }
+
+    size_t SHARE_LEN = pp.LOG_SUM_BOUND/8; 
+    uint64_t RING_MASK = RingMask(pp.LOG_SUM_BOUND); 
+
+    // draw all masks with a single PRG call
+    std::vector<uint64_t> vec_r(pp.SENDER_ITEM_NUM); 
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0); 
+    PRG::GenRandomBytes(seed, reinterpret_cast<uint8_t*>(vec_r.data()), pp.SENDER_ITEM_NUM*sizeof(uint64_t)); 
+
+    uint64_t mask = 0;
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(+:mask)
+    for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++){
+        vec_r[i] &= RING_MASK; 
+        mask += vec_r[i];   
+    }
+
+    auto start_time = std::chrono::steady_clock::now(); 
+        
+    PrintSplitLine('-');
+    std::cout << "[mqRPMT-based PSI-card-sum] Phase 1: execute mqRPMT >>>" << std::endl;
+    
+    cwPRFmqRPMT::Client(io, pp.mqrpmt_part, vec_X);
+
+    // m0 = r_i, m1 = r_i + v_i mod 2^k, serialized as the low SHARE_LEN bytes (little endian)
+    std::vector<uint8_t> vec_m0(pp.SENDER_ITEM_NUM*SHARE_LEN); 
+    std::vector<uint8_t> vec_m1(pp.SENDER_ITEM_NUM*SHARE_LEN); 
+    
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++){
+        uint64_t masked_v = (vec_r[i] + vec_v[i]) & RING_MASK; 
+        memcpy(vec_m0.data()+i*SHARE_LEN, &vec_r[i], SHARE_LEN); 
+        memcpy(vec_m1.data()+i*SHARE_LEN, &masked_v, SHARE_LEN); 
+    }
+
+    std::cout << "[mqRPMT-based PSI-card-sum] Phase 2: execute OTe >>>" << std::endl;
+    ALSZOTE::SendBytes(io, pp.ote_part, vec_m0, vec_m1, SHARE_LEN, pp.SENDER_ITEM_NUM); 
+
+    size_t CARDINALITY; 
+    io.ReceiveInteger(CARDINALITY);
+    uint64_t SUM = 0; 
+    io.ReceiveBytes(&SUM, SHARE_LEN);  
+    std::cout << "[mqRPMT-based PSI-card-sum] Phase 3: Sender obtains (CARDINALITY, masked_SUM) from Receiver" << std::endl;
+    
+    SUM = (SUM - mask) & RING_MASK; 
+
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "[mqRPMT-based PSI-card-sum]: Sender side takes time = " 
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    PrintSplitLine('-');
+
+    return {CARDINALITY, SUM}; 
+}
+
 
 std::tuple<size_t, BigInt> Send(NetIO &io, PP &pp, std::vector<block> &vec_X, std::vector<BigInt> &vec_v) 
 {
@@ -122,9 +199,19 @@ std::tuple<size_t, BigInt> Send(NetIO &io, PP &pp, std::vector<block> &vec_X, st
         std::cerr << "|X| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE 
     }
+
+    if(UseNativeRing(pp)){
+        std::vector<uint64_t> vec_native_v(pp.SENDER_ITEM_NUM); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++){
+            vec_native_v[i] = vec_v[i].ToUint64(); 
+        }
+        auto [CARDINALITY, SUM] = Send(io, pp, vec_X, vec_native_v); 
+        return {CARDINALITY, BigInt(SUM)}; 
+    }
     
-    BigInt VALUE_BOUND = BigInt(pow(2, pp.LOG_VALUE_BOUND)); 
-    BigInt SUM_BOUND = BigInt(pow(2, pp.LOG_SUM_BOUND)); 
+    BigInt VALUE_BOUND = bn_1.Lshift(pp.LOG_VALUE_BOUND); 
+    BigInt SUM_BOUND = bn_1.Lshift(pp.LOG_SUM_BOUND); 
     std::vector<BigInt> vec_r = GenRandomBigIntVectorLessThan(pp.SENDER_ITEM_NUM, SUM_BOUND);
     
     BigInt mask = bn_0;
@@ -165,7 +252,7 @@ std::tuple<size_t, BigInt> Send(NetIO &io, PP &pp, std::vector<block> &vec_X, st
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSI-card-sum]: Receiver side takes time = " 
+    std::cout << "[mqRPMT-based PSI-card-sum]: Sender side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 
     PrintSplitLine('-');
@@ -186,6 +273,38 @@ size_t Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y)
     std::vector<uint8_t> vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Y);
 
     std::cout << "[mqRPMT-based PSI-card-sum] Phase 2: execute OTe >>>" << std::endl;
+    if(UseNativeRing(pp)){
+        size_t SHARE_LEN = pp.LOG_SUM_BOUND/8; 
+        std::vector<uint8_t> vec_share = ALSZOTE::ReceiveBytes(io, pp.ote_part, 
+            vec_indication_bit, SHARE_LEN, vec_indication_bit.size());
+
+        size_t CARDINALITY = 0; 
+        uint64_t masked_SUM = 0; 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(+:CARDINALITY,masked_SUM)
+        for(auto i = 0; i < vec_indication_bit.size(); i++){
+            uint64_t share = 0; 
+            memcpy(&share, vec_share.data()+i*SHARE_LEN, SHARE_LEN); 
+            masked_SUM += share; 
+            CARDINALITY += vec_indication_bit[i]; 
+        }
+        masked_SUM &= RingMask(pp.LOG_SUM_BOUND); 
+
+        io.SendInteger(CARDINALITY);
+        io.SendBytes(&masked_SUM, SHARE_LEN);  
+        std::cout << "[mqRPMT-based PSI-card-sum] Phase 3: Receiver  ===> (CARDINALITY, masked_SUM) ===> Sender";
+        std::cout << " [" << double(sizeof(CARDINALITY) + SHARE_LEN)/(1024*1024) << " MB]" << std::endl;
+
+        auto end_time = std::chrono::steady_clock::now(); 
+        auto running_time = end_time - start_time;
+        std::cout << "[mqRPMT-based PSI-card-sum]: Receiver side takes time = " 
+                  << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+            
+        PrintSplitLine('-');
+
+        return CARDINALITY;
+    }
+
+    // BigInt fallback for LOG_SUM_BOUND > 64
     std::vector<std::vector<uint8_t>> vec_result = ALSZOTE::ReceiveByteVector(io, pp.ote_part, 
         vec_indication_bit, vec_indication_bit.size());
 
@@ -197,7 +316,7 @@ size_t Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y)
     }
 
     BigInt masked_SUM = bn_0; 
-    BigInt SUM_BOUND = BigInt(pow(2, pp.LOG_SUM_BOUND)); 
+    BigInt SUM_BOUND = bn_1.Lshift(pp.LOG_SUM_BOUND); 
     for(auto i = 0; i < vec_v.size(); i++){
         vec_v[i].FromByteVector(vec_result[i]); 
         masked_SUM += vec_v[i];  
@@ -212,7 +331,7 @@ size_t Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y)
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
-    std::cout << "[mqRPMT-based PSI-card-sum]: Sender side takes time = " 
+    std::cout << "[mqRPMT-based PSI-card-sum]: Receiver side takes time = " 
               << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
         
     PrintSplitLine('-');
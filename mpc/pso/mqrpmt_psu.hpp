@@ -142,7 +142,7 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y)
         vec_indication_bit[i] ^= 0x01; 
     } 
 
-    std::cout << "Phase 2: execute one-sided OTe >>>" << std::endl;
+    std::cout << "[mqRPMT-based PSU] Phase 2: execute one-sided OTe >>>" << std::endl;
     // get the intersection X \cup Y via one-sided OT from receiver
     std::vector<block> vec_X_diff = ALSZOTE::OnesidedReceive(io, pp.ote_part, 
                                                              vec_indication_bit, vec_indication_bit.size()); 
@@ -161,10 +161,13 @@ std::vector<block> Receive(NetIO &io, PP &pp, std::vector<block> &vec_Y)
     return vec_union;
 }
 
-// support arbirary item (encode as uint8_t array)
-void Send(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_X, size_t ITEM_LEN) 
+/*
+** support arbitrary item with fixed byte length ITEM_LEN
+** items are stored contiguously: the i-th item lies in vec_X[i*ITEM_LEN, (i+1)*ITEM_LEN)
+*/
+void Send(NetIO &io, PP &pp, std::vector<uint8_t> &vec_X, size_t ITEM_LEN) 
 {
-    if(vec_X.size() != pp.SENDER_ITEM_NUM){
+    if(vec_X.size() != pp.SENDER_ITEM_NUM*ITEM_LEN){
         std::cerr << "|X| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
@@ -175,14 +178,14 @@ void Send(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_X, size_t IT
 
     std::vector<block> vec_Block_X(pp.SENDER_ITEM_NUM); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < vec_X.size(); i++){
-        vec_Block_X[i] = Hash::BytesToBlock(vec_X[i]); 
+    for(auto i = 0; i < pp.SENDER_ITEM_NUM; i++){
+        vec_Block_X[i] = Hash::BytesToBlock(vec_X.data()+i*ITEM_LEN, ITEM_LEN); 
     }
     cwPRFmqRPMT::Client(io, pp.mqrpmt_part, vec_Block_X);
         
     std::cout << "[mqRPMT-based PSU] Phase 2: execute one-sided OTe >>>" << std::endl;
     // get the intersection X \cup Y via one-sided OT from receiver
-    ALSZOTE::OnesidedSendByteVector(io, pp.ote_part, vec_X, vec_X.size()); 
+    ALSZOTE::OnesidedSendBytes(io, pp.ote_part, vec_X, ITEM_LEN, pp.SENDER_ITEM_NUM); 
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -192,9 +195,10 @@ void Send(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_X, size_t IT
     PrintSplitLine('-');
 }
 
-std::vector<std::vector<uint8_t>> Receive(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_Y, size_t ITEM_LEN) 
+// the union is returned in the same flat layout: Y first, then X\Y 
+std::vector<uint8_t> Receive(NetIO &io, PP &pp, std::vector<uint8_t> &vec_Y, size_t ITEM_LEN) 
 {
-    if(vec_Y.size() != pp.RECEIVER_ITEM_NUM){
+    if(vec_Y.size() != pp.RECEIVER_ITEM_NUM*ITEM_LEN){
         std::cerr << "|Y| does not match public parameter" << std::endl; 
         exit(1); // EXIT_FAILURE  
     }
@@ -205,8 +209,8 @@ std::vector<std::vector<uint8_t>> Receive(NetIO &io, PP &pp, std::vector<std::ve
      
     std::vector<block> vec_Block_Y(pp.RECEIVER_ITEM_NUM); 
     #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < vec_Y.size(); i++){
-        vec_Block_Y[i] = Hash::BytesToBlock(vec_Y[i]); 
+    for(auto i = 0; i < pp.RECEIVER_ITEM_NUM; i++){
+        vec_Block_Y[i] = Hash::BytesToBlock(vec_Y.data()+i*ITEM_LEN, ITEM_LEN); 
     }
     std::vector<uint8_t> vec_indication_bit = cwPRFmqRPMT::Server(io, pp.mqrpmt_part, vec_Block_Y);
        
@@ -218,12 +222,12 @@ std::vector<std::vector<uint8_t>> Receive(NetIO &io, PP &pp, std::vector<std::ve
 
     std::cout << "[mqRPMT-based PSU] Phase 2: execute one-sided OTe >>>" << std::endl;
     // get the intersection X \cup Y via one-sided OT from receiver
-    std::vector<std::vector<uint8_t>> vec_X_diff; 
-    vec_X_diff = ALSZOTE::OnesidedReceiveByteVector(io, pp.ote_part, vec_indication_bit, vec_indication_bit.size()); 
-    std::vector<std::vector<uint8_t>> vec_union = vec_Y; 
-    for(auto i = 0; i < vec_X_diff.size(); i++){
-        vec_union.emplace_back(vec_X_diff[i]);
-    }
+    std::vector<uint8_t> vec_X_diff = ALSZOTE::OnesidedReceiveBytes(io, pp.ote_part, vec_indication_bit, 
+                                                                    ITEM_LEN, vec_indication_bit.size()); 
+    std::vector<uint8_t> vec_union; 
+    vec_union.reserve(vec_Y.size() + vec_X_diff.size()); 
+    vec_union.insert(vec_union.end(), vec_Y.begin(), vec_Y.end()); 
+    vec_union.insert(vec_union.end(), vec_X_diff.begin(), vec_X_diff.end()); 
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -235,5 +239,54 @@ std::vector<std::vector<uint8_t>> Receive(NetIO &io, PP &pp, std::vector<std::ve
     return vec_union;
 }
 
+// support arbirary item (encode as uint8_t array): packed into the flat layout above, all items must have length ITEM_LEN
+std::vector<uint8_t> PackItems(std::vector<std::vector<uint8_t>> &vec_item, size_t ITEM_LEN)
+{
+    for(auto i = 0; i < vec_item.size(); i++){
+        if(vec_item[i].size() != ITEM_LEN){
+            std::cerr << "item length does not match ITEM_LEN" << std::endl; 
+            exit(1); // EXIT_FAILURE  
+        }
+    }
+    std::vector<uint8_t> vec_flat_item(vec_item.size()*ITEM_LEN); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < vec_item.size(); i++){
+        memcpy(vec_flat_item.data()+i*ITEM_LEN, vec_item[i].data(), ITEM_LEN); 
+    }
+    return vec_flat_item; 
+}
+
+std::vector<std::vector<uint8_t>> UnpackItems(std::vector<uint8_t> &vec_flat_item, size_t ITEM_LEN)
+{
+    size_t ITEM_NUM = vec_flat_item.size()/ITEM_LEN; 
+    std::vector<std::vector<uint8_t>> vec_item(ITEM_NUM); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < ITEM_NUM; i++){
+        vec_item[i].assign(vec_flat_item.begin()+i*ITEM_LEN, vec_flat_item.begin()+(i+1)*ITEM_LEN); 
+    }
+    return vec_item; 
+}
+
+void Send(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_X, size_t ITEM_LEN) 
+{
+    if(vec_X.size() != pp.SENDER_ITEM_NUM){
+        std::cerr << "|X| does not match public parameter" << std::endl; 
+        exit(1); // EXIT_FAILURE  
+    }
+    std::vector<uint8_t> vec_flat_X = PackItems(vec_X, ITEM_LEN); 
+    Send(io, pp, vec_flat_X, ITEM_LEN); 
+}
+
+std::vector<std::vector<uint8_t>> Receive(NetIO &io, PP &pp, std::vector<std::vector<uint8_t>> &vec_Y, size_t ITEM_LEN) 
+{
+    if(vec_Y.size() != pp.RECEIVER_ITEM_NUM){
+        std::cerr << "|Y| does not match public parameter" << std::endl; 
+        exit(1); // EXIT_FAILURE  
+    }
+    std::vector<uint8_t> vec_flat_Y = PackItems(vec_Y, ITEM_LEN); 
+    std::vector<uint8_t> vec_flat_union = Receive(io, pp, vec_flat_Y, ITEM_LEN); 
+    return UnpackItems(vec_flat_union, ITEM_LEN); 
+}
+
 }
 #endif
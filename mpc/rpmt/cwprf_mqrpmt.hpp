@@ -6,17 +6,29 @@
 #include "../../crypto/prg.hpp"
 #include "../../crypto/block.hpp"
 #include "../../netio/stream_channel.hpp"
+#include "../../netio/pipeline.hpp"
 #include "../../filter/bloom_filter.hpp"
+#include "../../filter/cuckoo_filter.hpp"
+#include "../../filter/binary_fuse_filter.hpp"
+#include "../../filter/blocked_bloom_filter.hpp"
+#include "../../filter/golomb_coded_set.hpp"
 #include "../../utility/serialization.hpp"
 
 /*
 ** implement multi-query RPMT based on weak commutative PRF
-** cuckoo filter is not gurantteed to be safe here, cause the filter may reveal the order of X
+** in step 2 the client ships F_k2k1(y_i) to the server in the form selected by pp.filter_type at runtime
+** bloom: BloomFilter with lambda hash functions, about 1.44*lambda bits per item
+** cuckoo: CuckooFilter with at most 32-bit tags, false positive probability is capped at about 2^{-29}, so it requires lambda <= 29
+**         cuckoo filter is not gurantteed to be safe here, cause the filter may reveal the order of X, so items are shuffled before insertion
+** binaryfuse: BinaryFuseFilter with ceil(lambda/8)-byte fingerprints, about 9*ceil(lambda/8) bits per item
+** blockedbloom: BlockedBloomFilter, one cache line per query, about 165 bits per item for lambda = 40
+** shuffle: the permuted F_k2k1(y_i) themselves, the server builds a hash set
+** compressedbloom: BloomFilter with ceil(lambda/5) hash functions sent Golomb-Rice coded, about 51 bits per item for lambda = 40,
+**                  the server decodes chunks in parallel as they arrive, at the cost of about 32*ceil(lambda/5) bits per item in memory (about 252 for lambda = 40)
+** gcs: GolombCodedSet, about lambda + 1.6 bits per item, the server answers a batch of queries (a chunk in streaming mode) by a sort-and-merge,
+**      the hashes are mapped to [0, n*2^lambda) in 64 bits, so it requires LOG_SERVER_LEN + lambda < 64
 */
 
-
-#define BLOOMFILTER 
-
 namespace cwPRFmqRPMT{
     
 using Serialization::operator<<; 
@@ -29,6 +41,8 @@ struct PP
     size_t SERVER_LEN; 
     size_t LOG_CLIENT_LEN; 
     size_t CLIENT_LEN; 
+    size_t CHUNK_LEN; // 0 means batch mode, otherwise process and transmit CHUNK_LEN items at a time
+    std::string filter_type; // bloom, cuckoo, binaryfuse, blockedbloom, shuffle, compressedbloom, gcs
 };
 
 // serialize
@@ -39,6 +53,8 @@ std::ofstream &operator<<(std::ofstream &fout, const PP &pp)
     fout << pp.SERVER_LEN; 
     fout << pp.LOG_CLIENT_LEN;
     fout << pp.CLIENT_LEN; 
+    fout << pp.CHUNK_LEN; 
+    fout << pp.filter_type; 
 
     return fout; 
 }
@@ -51,18 +67,53 @@ std::ifstream &operator>>(std::ifstream &fin, PP &pp)
     fin >> pp.SERVER_LEN;
     fin >> pp.LOG_CLIENT_LEN;
     fin >> pp.CLIENT_LEN;
+    fin >> pp.CHUNK_LEN; 
+    fin >> pp.filter_type; 
 
     return fin; 
 }
 
-PP Setup(size_t statistical_security_parameter, size_t LOG_SERVER_LEN, size_t LOG_CLIENT_LEN)
+enum FilterKind {BLOOM, CUCKOO, BINARYFUSE, BLOCKEDBLOOM, SHUFFLE, COMPRESSEDBLOOM, GCS}; 
+
+FilterKind ParseFilterType(const std::string &filter_type)
+{
+    if(filter_type == "bloom") return BLOOM; 
+    if(filter_type == "cuckoo") return CUCKOO; 
+    if(filter_type == "binaryfuse") return BINARYFUSE; 
+    if(filter_type == "blockedbloom") return BLOCKEDBLOOM; 
+    if(filter_type == "shuffle") return SHUFFLE; 
+    if(filter_type == "compressedbloom") return COMPRESSEDBLOOM; 
+    if(filter_type == "gcs") return GCS; 
+    std::cerr << "unknown filter type: " << filter_type << std::endl;
+    exit(1); // EXIT_FAILURE
+}
+
+PP Setup(size_t statistical_security_parameter, size_t LOG_SERVER_LEN, size_t LOG_CLIENT_LEN, size_t CHUNK_LEN = 0, 
+         std::string filter_type = "bloom")
 {
     PP pp; 
+    if(ParseFilterType(filter_type) == CUCKOO && statistical_security_parameter > 29){
+        std::cerr << "cuckoo filter only achieves false positive probability about 2^{-29}, requires lambda <= 29" << std::endl; 
+        exit(1); // EXIT_FAILURE
+    }
+    if(ParseFilterType(filter_type) == GCS && LOG_SERVER_LEN + statistical_security_parameter >= 64){
+        std::cerr << "golomb coded set requires LOG_SERVER_LEN + lambda < 64" << std::endl; 
+        exit(1); // EXIT_FAILURE
+    }
+    pp.filter_type = filter_type; 
     pp.statistical_security_parameter = statistical_security_parameter; 
     pp.LOG_SERVER_LEN = LOG_SERVER_LEN; 
     pp.SERVER_LEN = size_t(pow(2, pp.LOG_SERVER_LEN)); 
     pp.LOG_CLIENT_LEN = LOG_CLIENT_LEN; 
     pp.CLIENT_LEN = size_t(pow(2, pp.LOG_CLIENT_LEN)); 
+
+    #ifndef ENABLE_X25519_ACCELERATION
+    if(CHUNK_LEN != 0){
+        std::cerr << "streaming mode requires x25519 acceleration, switch to batch mode" << std::endl; 
+        CHUNK_LEN = 0; 
+    }
+    #endif
+    pp.CHUNK_LEN = CHUNK_LEN; 
     return pp; 
 }
 
@@ -90,6 +141,229 @@ void FetchPP(PP &pp, std::string pp_filename)
     fin.close(); 
 }
 
+// send a serializable filter together with its size
+template <typename FilterType>
+void SendFilterObject(NetIO &io, FilterType &filter, std::string filter_name)
+{
+    size_t filter_size = filter.ObjectSize(); 
+    io.SendInteger(filter_size);
+    char *buffer = new char[filter_size]; 
+    filter.WriteObject(buffer);
+    io.SendBytes(buffer, filter_size); 
+    delete[] buffer; 
+    std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> " << filter_name << "(F_k2k1(y_i)) ===> Server";
+    std::cout << " [" << (double)filter_size/(1024*1024) << " MB]" << std::endl;
+}
+
+template <typename FilterType>
+void ReceiveFilterObject(NetIO &io, FilterType &filter)
+{
+    size_t filter_size; 
+    io.ReceiveInteger(filter_size);
+    char *buffer = new char[filter_size]; 
+    io.ReceiveBytes(buffer, filter_size);
+    filter.ReadObject(buffer);  
+    delete[] buffer; 
+}
+
+// the golomb coded set is checked against the received length before it is decoded
+void ReceiveFilterObject(NetIO &io, GolombCodedSet &filter)
+{
+    size_t filter_size; 
+    io.ReceiveInteger(filter_size);
+    char *buffer = new char[filter_size]; 
+    io.ReceiveBytes(buffer, filter_size);
+    bool status = filter.ReadObject(buffer, filter_size);  
+    delete[] buffer; 
+    if(status == false){
+        std::cerr << "receive golomb coded set fails" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+}
+
+// sparse bloom filter for the compressed form, fewer hash functions trade memory for bandwidth
+inline BloomFilter CompressibleBloomFilter(size_t max_element_num, size_t statistical_security_parameter)
+{
+    return BloomFilter(max_element_num, statistical_security_parameter, (statistical_security_parameter + 4)/5); 
+}
+
+// send the header of the compressed bloom filter first, then its chunks
+void SendCompressedFilterObject(NetIO &io, BloomFilter &filter)
+{
+    std::vector<uint8_t> buffer; 
+    filter.WriteCompressedObject(buffer); 
+    size_t CHUNK_NUM = (size_t(filter.table_size) + BLOOM_COMPRESS_CHUNK - 1)/BLOOM_COMPRESS_CHUNK; 
+    size_t HEADER_LEN = filter.CompressedHeaderSize(CHUNK_NUM); 
+    io.SendInteger(HEADER_LEN);
+    io.SendBytes(buffer.data(), HEADER_LEN); 
+    io.SendBytes(buffer.data() + HEADER_LEN, buffer.size() - HEADER_LEN); 
+    std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> CompressedBloomFilter(F_k2k1(y_i)) ===> Server";
+    std::cout << " [" << (double)buffer.size()/(1024*1024) << " MB, " 
+              << (double)filter.ObjectSize()/(1024*1024) << " MB uncompressed]" << std::endl;
+}
+
+// receive NUMBER_OF_THREADS chunks at a time, and decode them in parallel before receiving the next ones
+void ReceiveCompressedFilterObject(NetIO &io, BloomFilter &filter)
+{
+    size_t HEADER_LEN; 
+    io.ReceiveInteger(HEADER_LEN);
+    std::vector<uint8_t> buffer(HEADER_LEN); 
+    io.ReceiveBytes(buffer.data(), HEADER_LEN); 
+    CompressedBloomHeader header; 
+    if(filter.ReadCompressedHeader(buffer.data(), HEADER_LEN, header) != HEADER_LEN){
+        std::cerr << "receive compressed bloom filter fails" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+    size_t CHUNK_NUM = header.vec_chunk_byte_len.size(); 
+    for(size_t BEGIN = 0; BEGIN < CHUNK_NUM; BEGIN += NUMBER_OF_THREADS){
+        size_t END = std::min(BEGIN + NUMBER_OF_THREADS, CHUNK_NUM); 
+        size_t LEN = std::accumulate(header.vec_chunk_byte_len.begin() + BEGIN, header.vec_chunk_byte_len.begin() + END, size_t(0)); 
+        buffer.resize(LEN); 
+        io.ReceiveBytes(buffer.data(), LEN); 
+        if(filter.ReadCompressedChunks(header, BEGIN, END, buffer.data()) == false){
+            std::cerr << "receive compressed bloom filter fails" << std::endl;
+            exit(1); // EXIT_FAILURE
+        }
+    }
+}
+
+inline void SendPoints(NetIO &io, std::vector<ECPoint> &vec_A)
+{
+    io.SendECPoints(vec_A.data(), vec_A.size()); 
+    #ifdef ECPOINT_COMPRESSED
+        std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN*vec_A.size()/(1024*1024) << " MB]" << std::endl;
+    #else
+        std::cout << " [" << (double)POINT_BYTE_LEN*vec_A.size()/(1024*1024) << " MB]" << std::endl;
+    #endif
+}
+
+inline void ReceivePoints(NetIO &io, std::vector<ECPoint> &vec_A)
+{
+    io.ReceiveECPoints(vec_A.data(), vec_A.size()); 
+}
+
+inline void SendPoints(NetIO &io, std::vector<EC25519Point> &vec_A)
+{
+    io.SendEC25519Points(vec_A.data(), vec_A.size()); 
+    std::cout << " [" << (double)32*vec_A.size()/(1024*1024) << " MB]" << std::endl;
+}
+
+inline void ReceivePoints(NetIO &io, std::vector<EC25519Point> &vec_A)
+{
+    io.ReceiveEC25519Points(vec_A.data(), vec_A.size()); 
+}
+
+// client side of step 2: encode F_k2k1(y_i) according to pp.filter_type and send it
+template <typename PointType>
+void SendFilter(NetIO &io, PP &pp, std::vector<PointType> &vec_Fk2k1_Y)
+{
+    switch(ParseFilterType(pp.filter_type)){
+        case BLOOM: {
+            BloomFilter filter(vec_Fk2k1_Y.size(), pp.statistical_security_parameter);
+            filter.Insert(vec_Fk2k1_Y);
+            SendFilterObject(io, filter, "BloomFilter"); 
+            break; 
+        }
+        case CUCKOO: {
+            std::shuffle(vec_Fk2k1_Y.begin(), vec_Fk2k1_Y.end(), global_built_in_prg);
+            CuckooFilter filter(vec_Fk2k1_Y.size(), pow(2, -double(pp.statistical_security_parameter)));
+            filter.Insert(vec_Fk2k1_Y);
+            SendFilterObject(io, filter, "CuckooFilter"); 
+            break; 
+        }
+        case BINARYFUSE: {
+            BinaryFuseFilter filter(vec_Fk2k1_Y.size(), pp.statistical_security_parameter);
+            filter.Build(vec_Fk2k1_Y);
+            SendFilterObject(io, filter, "BinaryFuseFilter"); 
+            break; 
+        }
+        case BLOCKEDBLOOM: {
+            BlockedBloomFilter filter(vec_Fk2k1_Y.size(), pp.statistical_security_parameter);
+            filter.Insert(vec_Fk2k1_Y);
+            SendFilterObject(io, filter, "BlockedBloomFilter"); 
+            break; 
+        }
+        case SHUFFLE: {
+            std::shuffle(vec_Fk2k1_Y.begin(), vec_Fk2k1_Y.end(), global_built_in_prg);
+            std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> Permutation(F_k2k1(y_i)) ===> Server"; 
+            SendPoints(io, vec_Fk2k1_Y); 
+            break; 
+        }
+        case COMPRESSEDBLOOM: {
+            BloomFilter filter = CompressibleBloomFilter(vec_Fk2k1_Y.size(), pp.statistical_security_parameter);
+            filter.Insert(vec_Fk2k1_Y);
+            SendCompressedFilterObject(io, filter); 
+            break; 
+        }
+        case GCS: {
+            GolombCodedSet filter(vec_Fk2k1_Y.size(), pp.statistical_security_parameter);
+            filter.Build(vec_Fk2k1_Y);
+            SendFilterObject(io, filter, "GolombCodedSet"); 
+            break; 
+        }
+    }
+}
+
+// server side of step 2: hold whatever the client sends and answer membership queries
+template <typename PointType, typename PointHash>
+class ReceivedFilter{
+public:
+    FilterKind kind; 
+    BloomFilter bloom; 
+    CuckooFilter cuckoo; 
+    BinaryFuseFilter binaryfuse; 
+    BlockedBloomFilter blockedbloom; 
+    GolombCodedSet gcs; 
+    std::unordered_set<PointType, PointHash> S; 
+
+    void Receive(NetIO &io, PP &pp)
+    {
+        kind = ParseFilterType(pp.filter_type); 
+        switch(kind){
+            case BLOOM: ReceiveFilterObject(io, bloom); break; 
+            case CUCKOO: ReceiveFilterObject(io, cuckoo); break; 
+            case BINARYFUSE: ReceiveFilterObject(io, binaryfuse); break; 
+            case BLOCKEDBLOOM: ReceiveFilterObject(io, blockedbloom); break; 
+            case COMPRESSEDBLOOM: ReceiveCompressedFilterObject(io, bloom); break; 
+            case GCS: ReceiveFilterObject(io, gcs); break; 
+            case SHUFFLE: {
+                std::vector<PointType> vec_Fk2k1_Y(pp.SERVER_LEN);
+                ReceivePoints(io, vec_Fk2k1_Y);
+                S.reserve(pp.SERVER_LEN); 
+                S.insert(vec_Fk2k1_Y.begin(), vec_Fk2k1_Y.end()); 
+                break; 
+            }
+        }
+    }
+
+    inline bool Contain(const PointType &A)
+    {
+        switch(kind){
+            case BLOOM: case COMPRESSEDBLOOM: return bloom.Contain(A); 
+            case CUCKOO: return cuckoo.Contain(A); 
+            case BINARYFUSE: return binaryfuse.Contain(A); 
+            case BLOCKEDBLOOM: return blockedbloom.Contain(A); 
+            case GCS: return gcs.Contain(A); 
+            default: return S.find(A) != S.end(); 
+        }
+    }
+
+    std::vector<uint8_t> Contain(const std::vector<PointType> &vec_A)
+    {
+        // batch queries with prefetching
+        if(kind == BLOOM || kind == COMPRESSEDBLOOM) return bloom.Contain(vec_A); 
+        if(kind == CUCKOO) return cuckoo.Contain(vec_A); 
+        if(kind == BINARYFUSE) return binaryfuse.Contain(vec_A); 
+        if(kind == GCS) return gcs.Contain(vec_A); // sort-and-merge over the whole batch
+        std::vector<uint8_t> vec_indication_bit(vec_A.size());
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < vec_A.size(); i++){
+            vec_indication_bit[i] = Contain(vec_A[i]); 
+        }
+        return vec_indication_bit; 
+    }
+};
+
 #ifndef ENABLE_X25519_ACCELERATION
 std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
 {
@@ -130,31 +404,9 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
     // compute the indication bit vector
     std::vector<uint8_t> vec_indication_bit(pp.CLIENT_LEN);
 
-    #ifdef BLOOMFILTER
-        BloomFilter filter; 
-        // get the size of filter 
-        size_t filter_size = filter.ObjectSize();
-        io.ReceiveInteger(filter_size);
-        // get the content of filter
-        char *buffer = new char[filter_size]; 
-        io.ReceiveBytes(buffer, filter_size);
-        // reconstruct bloom filter  
-        filter.ReadObject(buffer);  
-        delete[] buffer; 
-        vec_indication_bit = filter.Contain(vec_Fk1k2_X); 
-    #else
-        std::vector<ECPoint> vec_Fk2k1_Y(pp.SERVER_LEN);
-        io.ReceiveECPoints(vec_Fk2k1_Y.data(), pp.SERVER_LEN);
-        std::unordered_set<ECPoint, ECPointHash> S;
-        for(auto i = 0; i < pp.SERVER_LEN; i++){
-            S.insert(vec_Fk2k1_Y[i]); 
-        }
-        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-        for(auto i = 0; i < pp.CLIENT_LEN; i++){
-            if(S.find(vec_Fk1k2_X[i]) == S.end()) vec_indication_bit[i] = 0;  
-            else vec_indication_bit[i] = 1;
-        }
-    #endif
+    ReceivedFilter<ECPoint, ECPointHash> filter; 
+    filter.Receive(io, pp); 
+    vec_indication_bit = filter.Contain(vec_Fk1k2_X); 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -204,29 +456,8 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
         vec_Fk2k1_Y[i] = vec_Fk1_Y[i] * k2; 
     }
 
-    // generate and send bloom filter
-    #ifdef BLOOMFILTER
-        BloomFilter filter(vec_Fk2k1_Y.size(), pp.statistical_security_parameter);
-        filter.Insert(vec_Fk2k1_Y);
-        size_t filter_size = filter.ObjectSize(); 
-        io.SendInteger(filter_size);
-        char *buffer = new char[filter_size]; 
-        filter.WriteObject(buffer);
-        io.SendBytes(buffer, filter_size); 
-        std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> BloomFilter(F_k2k1(y_i)) ===> Server";
-        std::cout << " [" << (double)filter_size/(1024*1024) << " MB]" << std::endl;
-        delete[] buffer; 
-    #else
-        // permutation
-        std::shuffle(vec_Fk2k1_Y.begin(), vec_Fk2k1_Y.end(), global_built_in_prg);
-        io.SendECPoints(vec_Fk2k1_Y.data(), pp.SERVER_LEN); 
-        std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> Permutation(F_k2k1(y_i)) ===> Server"; 
-        #ifdef ECPOINT_COMPRESSED
-            std::cout << " [" << (double)POINT_COMPRESSED_BYTE_LEN * pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
-        #else
-            std::cout << " [" << (double)POINT_BYTE_LEN*pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
-        #endif
-    #endif
+    // generate and send the filter
+    SendFilter(io, pp, vec_Fk2k1_Y); 
     
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -239,6 +470,183 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
 
 #else
 
+/*
+** streaming mode: the same protocol, but every stage is processed and transmitted chunk by chunk
+** the computation of the next chunk overlaps the transmission of the current chunk (see netio/pipeline.hpp)
+** step 1: Server ===> F_k1(y_i) ===> Client, the client immediately inserts F_k2k1(y_i) of each chunk into the filter
+** step 2: Client ===> Filter(F_k2k1(y_i)) ===> Server
+** step 3: Client ===> F_k2(x_i) ===> Server, the server immediately queries F_k1k2(x_i) of each chunk
+** only two chunks of EC points are alive on either side besides the filter
+** the filter is sent before F_k2(x_i), the output is identical to the batch mode
+*/
+std::vector<uint8_t> StreamServer(NetIO &io, PP &pp, std::vector<block> &vec_Y)
+{
+    PrintSplitLine('-'); 
+    auto start_time = std::chrono::steady_clock::now(); 
+
+    std::vector<uint8_t> k1(32);
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); // initialize PRG
+    GenRandomBytes(seed, k1.data(), 32);  // pick a key k1
+
+    size_t CHUNK_LEN = pp.CHUNK_LEN; 
+    std::vector<EC25519Point> vec_buffer[2] = {std::vector<EC25519Point>(CHUNK_LEN), std::vector<EC25519Point>(CHUNK_LEN)}; 
+
+    // step 1: compute F_k1(y_i) of chunk j+1 while sending chunk j
+    auto ComputeFk1Y = [&](size_t j, size_t k){
+        size_t BEGIN = j*CHUNK_LEN; 
+        size_t LEN = Pipeline::ChunkLen(pp.SERVER_LEN, CHUNK_LEN, j); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < LEN; i++){
+            EC25519Point Hash_Y; 
+            Hash::BlockToBytes(vec_Y[BEGIN+i], Hash_Y.px, 32); 
+            vec_buffer[k][i] = Hash_Y * k1; 
+        }
+    }; 
+    auto SendFk1Y = [&](size_t j, size_t k){
+        io.SendEC25519Points(vec_buffer[k].data(), Pipeline::ChunkLen(pp.SERVER_LEN, CHUNK_LEN, j)); 
+    }; 
+    Pipeline::Send(Pipeline::ChunkNum(pp.SERVER_LEN, CHUNK_LEN), ComputeFk1Y, SendFk1Y); 
+
+    std::cout <<"cwPRF-based mqRPMT [step 1]: Server ===> F_k1(y_i) ===> Client";
+    std::cout << " [" << 32*pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
+
+    // step 2: receive the filter
+    ReceivedFilter<EC25519Point, EC25519PointHash> filter; 
+    filter.Receive(io, pp); 
+
+    // step 3: receive F_k2(x_i) of chunk j+1, meanwhile query F_k1k2(x_i) of chunk j
+    std::vector<uint8_t> vec_indication_bit(pp.CLIENT_LEN);
+    auto ReceiveFk2X = [&](size_t j, size_t k){
+        io.ReceiveEC25519Points(vec_buffer[k].data(), Pipeline::ChunkLen(pp.CLIENT_LEN, CHUNK_LEN, j)); 
+    }; 
+    auto QueryFk1k2X = [&](size_t j, size_t k){
+        size_t BEGIN = j*CHUNK_LEN; 
+        size_t LEN = Pipeline::ChunkLen(pp.CLIENT_LEN, CHUNK_LEN, j); 
+        std::vector<EC25519Point> vec_Fk1k2_X(LEN); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < LEN; i++){
+            vec_Fk1k2_X[i] = vec_buffer[k][i] * k1; // (H(x_i)^k2)^k1
+        }
+        // query the chunk as one batch, so that every filter takes its batch path (sort-and-merge for gcs)
+        std::vector<uint8_t> vec_chunk_indication_bit = filter.Contain(vec_Fk1k2_X); 
+        std::copy(vec_chunk_indication_bit.begin(), vec_chunk_indication_bit.end(), vec_indication_bit.begin() + BEGIN); 
+    }; 
+    Pipeline::Receive(Pipeline::ChunkNum(pp.CLIENT_LEN, CHUNK_LEN), ReceiveFk2X, QueryFk1k2X); 
+
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "cwPRF-mqRPMT (streaming): Server side takes time = " 
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    
+    PrintSplitLine('-'); 
+
+    return vec_indication_bit; 
+}
+
+void StreamClient(NetIO &io, PP &pp, std::vector<block> &vec_X) 
+{
+    PrintSplitLine('-'); 
+    auto start_time = std::chrono::steady_clock::now(); 
+
+    std::vector<uint8_t> k2(32);
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); // initialize PRG
+    GenRandomBytes(seed, k2.data(), 32);  // pick a key k2
+
+    size_t CHUNK_LEN = pp.CHUNK_LEN; 
+    std::vector<EC25519Point> vec_buffer[2] = {std::vector<EC25519Point>(CHUNK_LEN), std::vector<EC25519Point>(CHUNK_LEN)}; 
+
+    /* 
+    ** step 1: receive F_k1(y_i) of chunk j+1, meanwhile insert F_k2k1(y_i) of chunk j into the filter
+    ** bloom filter is built incrementally chunk by chunk, binary fuse filter is static so only 16-byte digests are kept, 
+    ** blocked bloom filter keeps the digests as well, so that blocks are written by one thread each at the end, 
+    ** golomb coded set is static as well and keeps 8-byte hashes, 
+    ** cuckoo filter and shuffle keep the points since they must be permuted first
+    */
+    FilterKind kind = ParseFilterType(pp.filter_type); 
+    BloomFilter filter; 
+    if(kind == BLOOM) filter = BloomFilter(pp.SERVER_LEN, pp.statistical_security_parameter);
+    if(kind == COMPRESSEDBLOOM) filter = CompressibleBloomFilter(pp.SERVER_LEN, pp.statistical_security_parameter);
+    BlockedBloomFilter blocked_filter; 
+    if(kind == BLOCKEDBLOOM) blocked_filter = BlockedBloomFilter(pp.SERVER_LEN, pp.statistical_security_parameter);
+    std::vector<block> vec_digest; 
+    if(kind == BINARYFUSE || kind == BLOCKEDBLOOM) vec_digest.resize(pp.SERVER_LEN); 
+    std::vector<uint64_t> vec_hash; 
+    if(kind == GCS) vec_hash.resize(pp.SERVER_LEN); 
+    std::vector<EC25519Point> vec_Fk2k1_Y;
+    if(kind == CUCKOO || kind == SHUFFLE) vec_Fk2k1_Y.resize(pp.SERVER_LEN);
+    auto ReceiveFk1Y = [&](size_t j, size_t k){
+        io.ReceiveEC25519Points(vec_buffer[k].data(), Pipeline::ChunkLen(pp.SERVER_LEN, CHUNK_LEN, j)); 
+    }; 
+    auto InsertFk2k1Y = [&](size_t j, size_t k){
+        size_t BEGIN = j*CHUNK_LEN; 
+        size_t LEN = Pipeline::ChunkLen(pp.SERVER_LEN, CHUNK_LEN, j); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < LEN; i++){
+            EC25519Point Fk2k1_Y = vec_buffer[k][i] * k2; // (H(y_i)^k1)^k2
+            switch(kind){
+                case BLOOM: case COMPRESSEDBLOOM: vec_buffer[k][i] = Fk2k1_Y; break; 
+                case BINARYFUSE: vec_digest[BEGIN+i] = BinaryFuseFilter::Digest(Fk2k1_Y); break; 
+                case BLOCKEDBLOOM: vec_digest[BEGIN+i] = blocked_filter.Digest(Fk2k1_Y); break; 
+                case GCS: vec_hash[BEGIN+i] = GolombCodedSet::Hash(Fk2k1_Y); break; 
+                default: vec_Fk2k1_Y[BEGIN+i] = Fk2k1_Y; 
+            }
+        }
+        if(kind == BLOOM || kind == COMPRESSEDBLOOM) filter.InsertBatch(vec_buffer[k].data(), LEN); 
+    }; 
+    Pipeline::Receive(Pipeline::ChunkNum(pp.SERVER_LEN, CHUNK_LEN), ReceiveFk1Y, InsertFk2k1Y); 
+
+    // step 2: send the filter
+    if(kind == BLOOM) SendFilterObject(io, filter, "BloomFilter"); 
+    if(kind == COMPRESSEDBLOOM) SendCompressedFilterObject(io, filter); 
+    if(kind == BINARYFUSE){
+        BinaryFuseFilter fuse_filter(pp.SERVER_LEN, pp.statistical_security_parameter);
+        fuse_filter.BuildDigest(vec_digest);
+        SendFilterObject(io, fuse_filter, "BinaryFuseFilter"); 
+        std::vector<block>().swap(vec_digest); 
+    }
+    if(kind == BLOCKEDBLOOM){
+        blocked_filter.InsertDigest(vec_digest);
+        SendFilterObject(io, blocked_filter, "BlockedBloomFilter"); 
+        std::vector<block>().swap(vec_digest); 
+    }
+    if(kind == GCS){
+        GolombCodedSet gcs(pp.SERVER_LEN, pp.statistical_security_parameter);
+        gcs.BuildHash(vec_hash);
+        SendFilterObject(io, gcs, "GolombCodedSet"); 
+        std::vector<uint64_t>().swap(vec_hash); 
+    }
+    if(kind == CUCKOO || kind == SHUFFLE){
+        SendFilter(io, pp, vec_Fk2k1_Y); 
+        std::vector<EC25519Point>().swap(vec_Fk2k1_Y); 
+    }
+
+    // step 3: compute F_k2(x_i) of chunk j+1 while sending chunk j
+    auto ComputeFk2X = [&](size_t j, size_t k){
+        size_t BEGIN = j*CHUNK_LEN; 
+        size_t LEN = Pipeline::ChunkLen(pp.CLIENT_LEN, CHUNK_LEN, j); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < LEN; i++){
+            EC25519Point Hash_X; 
+            Hash::BlockToBytes(vec_X[BEGIN+i], Hash_X.px, 32); 
+            vec_buffer[k][i] = Hash_X * k2; 
+        }
+    }; 
+    auto SendFk2X = [&](size_t j, size_t k){
+        io.SendEC25519Points(vec_buffer[k].data(), Pipeline::ChunkLen(pp.CLIENT_LEN, CHUNK_LEN, j)); 
+    }; 
+    Pipeline::Send(Pipeline::ChunkNum(pp.CLIENT_LEN, CHUNK_LEN), ComputeFk2X, SendFk2X); 
+
+    std::cout <<"cwPRF-based mqRPMT [step 3]: Client ===> F_k2(x_i) ===> Server"; 
+    std::cout << " [" << 32*pp.CLIENT_LEN/(1024*1024) << " MB]" << std::endl;
+
+    auto end_time = std::chrono::steady_clock::now(); 
+    auto running_time = end_time - start_time;
+    std::cout << "cwPRF-mqRPMT (streaming): Client side takes time = " 
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+        
+    PrintSplitLine('-'); 
+}
+
 std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
 {
     if(pp.SERVER_LEN != vec_Y.size()){
@@ -246,6 +654,8 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
         exit(1);  
     }
 
+    if(pp.CHUNK_LEN != 0) return StreamServer(io, pp, vec_Y); 
+
     PrintSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
 
@@ -280,31 +690,9 @@ std::vector<uint8_t> Server(NetIO &io, PP &pp, std::vector<block> &vec_Y)
     // compute the indication bit vector
     std::vector<uint8_t> vec_indication_bit(pp.CLIENT_LEN);
 
-    #ifdef BLOOMFILTER
-        BloomFilter filter; 
-        // get the size of filter 
-        size_t filter_size = filter.ObjectSize();
-        io.ReceiveInteger(filter_size);
-        // get the content of filter
-        char *buffer = new char[filter_size]; 
-        io.ReceiveBytes(buffer, filter_size);
-        // reconstruct bloom filter  
-        filter.ReadObject(buffer);  
-        delete[] buffer; 
-        vec_indication_bit = filter.Contain(vec_Fk1k2_X); 
-    #else
-        std::vector<EC25519Point> vec_Fk2k1_Y(pp.SERVER_LEN);
-        io.ReceiveEC25519Points(vec_Fk2k1_Y.data(), pp.SERVER_LEN);
-        std::unordered_set<EC25519Point, EC25519PointHash> S;
-        for(auto i = 0; i < pp.SERVER_LEN; i++){
-            S.insert(vec_Fk2k1_Y[i]); 
-        }
-        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-        for(auto i = 0; i < pp.CLIENT_LEN; i++){
-            if(S.find(vec_Fk1k2_X[i]) == S.end()) vec_indication_bit[i] = 0;  
-            else vec_indication_bit[i] = 1;
-        }
-    #endif
+    ReceivedFilter<EC25519Point, EC25519PointHash> filter; 
+    filter.Receive(io, pp); 
+    vec_indication_bit = filter.Contain(vec_Fk1k2_X); 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -322,6 +710,8 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
         std::cerr << "input size of vec_X does not match public parameters" << std::endl;
         exit(1);  
     }
+
+    if(pp.CHUNK_LEN != 0) return StreamClient(io, pp, vec_X); 
     
     PrintSplitLine('-'); 
     auto start_time = std::chrono::steady_clock::now(); 
@@ -357,24 +747,8 @@ void Client(NetIO &io, PP &pp, std::vector<block> &vec_X)
     }
 
 
-    #ifdef BLOOMFILTER
-        BloomFilter filter(vec_Fk2k1_Y.size(), pp.statistical_security_parameter);
-        filter.Insert(vec_Fk2k1_Y);
-        size_t filter_size = filter.ObjectSize(); 
-        io.SendInteger(filter_size);
-        char *buffer = new char[filter_size]; 
-        filter.WriteObject(buffer);
-        io.SendBytes(buffer, filter_size); 
-        std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> BloomFilter(F_k2k1(y_i)) ===> Server";
-        std::cout << " [" << (double)filter_size/(1024*1024) << " MB]" << std::endl;
-        delete[] buffer; 
-    #else
-    // permutation
-        std::shuffle(vec_Fk2k1_Y.begin(), vec_Fk2k1_Y.end(), global_built_in_prg);
-        io.SendEC25519Points(vec_Fk2k1_Y.data(), pp.SERVER_LEN); 
-        std::cout <<"cwPRF-based mqRPMT [step 2]: Client ===> Permutation(F_k2k1(y_i)) ===> Server"; 
-        std::cout << " [" << (double)32 * pp.SERVER_LEN/(1024*1024) << " MB]" << std::endl;
-    #endif
+    // generate and send the filter
+    SendFilter(io, pp, vec_Fk2k1_Y); 
 
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -54,6 +54,19 @@ namespace VOLE {
 	** so t_max = 248; 
 	*/
 	
+	//(0) VOLE_A/VOLE_B create npot.pp and alszote.pp on first use
+	// call PreparePP once before running several VOLE instances concurrently, so that no thread fetches a half-written file
+	void PreparePP(){
+		if(!FileExist("npot.pp")){
+			NPOT::PP npot_pp = NPOT::Setup(); 
+			NPOT::SavePP(npot_pp, "npot.pp"); 
+		}
+		if(!FileExist("alszote.pp")){
+			ALSZOTE::PP ote_pp = ALSZOTE::Setup(128); 
+			ALSZOTE::SavePP(ote_pp, "alszote.pp"); 
+		}
+	}
+
 	//(1) VOLE = baseVOLE + tmpVOLE
 	//(1.1) return vec_A and vec_C
 	std::vector<block> VOLE_A(NetIO &A_io, uint64_t N_item, std::vector<block>& vec_C, uint64_t t){
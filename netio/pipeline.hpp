@@ -0,0 +1,60 @@
+/****************************************************************************
+this hpp implements double-buffered chunk pipelines on top of NetIO
+*****************************************************************************
+* @author     This file is part of Kunlun, developed by Yu Chen
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_NETIO_PIPELINE_HPP_
+#define KUNLUN_NETIO_PIPELINE_HPP_
+
+#include "../include/std.inc"
+
+/*
+** NetIO binds the socket to a single FILE stream, so concurrent send/receive on one channel is unsafe
+** therefore all network I/O stays on the calling thread, and a worker thread overlaps the computation:
+** Send: the worker produces chunk j+1 into buffer (j+1)%2 while the caller transmits chunk j from buffer j%2
+** Receive: the caller receives chunk j+1 into buffer (j+1)%2 while the worker consumes chunk j from buffer j%2
+** callbacks take (chunk_index, buffer_index)
+*/
+
+namespace Pipeline{
+
+// the number of chunks and the length of the j-th chunk
+inline size_t ChunkNum(size_t ITEM_NUM, size_t CHUNK_LEN)
+{
+    return (ITEM_NUM + CHUNK_LEN - 1)/CHUNK_LEN;
+}
+
+inline size_t ChunkLen(size_t ITEM_NUM, size_t CHUNK_LEN, size_t j)
+{
+    return std::min(CHUNK_LEN, ITEM_NUM - j*CHUNK_LEN);
+}
+
+template <typename ProduceFunction, typename TransmitFunction>
+void Send(size_t CHUNK_NUM, ProduceFunction produce, TransmitFunction transmit)
+{
+    if(CHUNK_NUM == 0) return;
+    produce(0, 0);
+    for(auto j = 0; j < CHUNK_NUM; j++){
+        std::thread worker;
+        if(j+1 < CHUNK_NUM) worker = std::thread(produce, j+1, (j+1)%2);
+        transmit(j, j%2);
+        if(worker.joinable()) worker.join();
+    }
+}
+
+template <typename ReceiveFunction, typename ConsumeFunction>
+void Receive(size_t CHUNK_NUM, ReceiveFunction receive, ConsumeFunction consume)
+{
+    if(CHUNK_NUM == 0) return;
+    receive(0, 0);
+    for(auto j = 0; j < CHUNK_NUM; j++){
+        std::thread worker(consume, j, j%2);
+        if(j+1 < CHUNK_NUM) receive(j+1, (j+1)%2);
+        worker.join();
+    }
+}
+
+}
+
+#endif
@@ -31,6 +31,8 @@ public:
 	std::string address;
 	int port;
 	ulong total = 0;
+	ulong sent = 0; // bytes sent by this end, total = sent + received
+	ulong received = 0;
 	NetIO(std::string party, std::string address, int port); 
 
 	void SetNodelay();
@@ -230,12 +232,14 @@ void NetIO::SendBytes(const void* data, size_t LEN)
 {
 	SendDataInternal(data, LEN); 
 	total += LEN;
+	sent += LEN;
 }
 
 void NetIO::ReceiveBytes(void* data, size_t LEN) 
 {
 	ReceiveDataInternal(data, LEN);
 	total += LEN;
+	received += LEN;
 }
 
 void NetIO::SendBlocks(const block* data, size_t LEN) 
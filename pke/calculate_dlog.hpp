@@ -18,6 +18,7 @@ this hpp implements DLOG algorithm
 #include "../crypto/hash.hpp"
 #include "../utility/murmurhash3.hpp"
 #include "../utility/print.hpp"
+#include "../utility/flat_hash_table.hpp"
 
 // #include "absl/container/flat_hash_map"
 
@@ -26,17 +27,11 @@ inline const size_t BUILD_TASK_NUM  = pow(2, 6);  // number of parallel task for
 inline const size_t SEARCH_TASK_NUM = pow(2, 6);  // number of parallel task for search  
 
 inline const size_t HASH_KEY_LEN = 8; // the key length for hashtable
+inline const size_t BATCH_TARGET_NUM = 16; // number of targets per batch of the batch DLogSolver::Solve, whose walks share one inversion per step
 
+// magic of the table file, see DLogSolver::BuildSaveTable
+inline const char DLOG_TABLE_MAGIC[8] = "KLDLOG"; 
 
-ECPoint giantstep; 
-std::vector<ECPoint> vec_searchanchor;
-
-/*
-** key-value hash table: key is uint64_t encoding, value is its corresponding DLOG w.r.t. g
-** more intuitive solution is using <ECPoint, size_t> hashmap, but its storage cost is high 
-*/
-std::unordered_map<size_t, size_t> encoding2index_map; 
-//absl::flat_hash_map<size_t, size_t> encoding2index_map;
 
 /*
 * the default TRADEOFF_NUM=0
@@ -47,30 +42,12 @@ void CheckDlogParameters(size_t RANGE_LEN, size_t TRADEOFF_NUM)
         std::cerr << "TRADEOFF_NUM is too aggressive" << std::endl;
         exit(EXIT_FAILURE);   
     }
+    if (RANGE_LEN/2 + TRADEOFF_NUM > 32){
+        std::cerr << "babystep index exceeds 32 bits" << std::endl;
+        exit(EXIT_FAILURE);   
+    }
 }
 
-std::string GetTableFileName(ECPoint &g, size_t RANGE_LEN, size_t TRADEOFF_NUM)
-{
-    std::string str_base = std::to_string(2);
-    std::string str_exp0 = std::to_string(RANGE_LEN);    // range size
-    std::string str_exp1 = std::to_string(RANGE_LEN/2+TRADEOFF_NUM);  // babystep key table size
-    std::string str_exp2 = std::to_string(RANGE_LEN/2-TRADEOFF_NUM-(size_t)log2(SEARCH_TASK_NUM));  // (log) giant step amplification factor: default value=0 
-    // use 8-byte uint64_t hash value as an identifier of EC Point 
-    std::string str_suffix = ToHexString(Hash::ECPointToString(g));
-    str_suffix = str_suffix.substr(0,16);
-
-    std::string table_filename  = str_suffix +"[" + 
-                                  str_base+"^"+str_exp0 + "," + 
-                                  str_base+"^"+str_exp1 + "," + 
-                                  str_base+"^"+str_exp2 + "].table"; 
-    return table_filename; 
-}
-
-/* 
-* parallel implementation: parallel table building and parallel search
-*/
-
-
 /* sliced babystep build */
 void BuildSlicedKeyTable(ECPoint g, ECPoint startpoint, size_t startindex, size_t SLICED_BABYSTEP_NUM, unsigned char* buffer)
 {    
@@ -83,253 +60,462 @@ void BuildSlicedKeyTable(ECPoint g, ECPoint startpoint, size_t startindex, size_
     } 
 }
 
-/* 
-** generate precompute table, it consists of two parts
-
-** part 1 - babystep hashkey: encoding values of [g^0, g^1, ..., g^{BABYSTEP_NUM}]
-** standard method is using babystep point as key for point2index hashmap, result in big key size
-** to shorten key size, use hash to map babystep point to unique key
-
-** part 2 - giantstep aux info: (1) giantstep = - g^{BABYSTEP_NUM}; (2) [giantstep^{i*factor}]: i=[SEARCH_TASK_NUM]
+// aux info: | RANGE_LEN | TRADEOFF_NUM | SEARCH_TASK_NUM | giantstep | searchanchors | with compressed points
+inline size_t DlogAuxSize()
+{
+    return 3*sizeof(uint64_t) + (SEARCH_TASK_NUM+1) * POINT_COMPRESSED_BYTE_LEN; 
+}
 
+/*
+** hash a batch of points to the same keys as ECPoint::ToUint64()
+** ToUint64 converts the point to affine coordinates at the cost of one field inversion, which dominates a giant step
+** here the Jacobian Z of all points are inverted together by Montgomery's simultaneous inversion:
+** one inversion per batch and 8 modular multiplications per point, all in Montgomery form
 */
+class BatchPointHasher{
+public:
+    BN_MONT_CTX *mont_ctx;
+    std::vector<BIGNUM*> vec_X, vec_Y, vec_Z, vec_prefix;
+    BIGNUM *inverse, *z_inverse, *z_inverse2, *z_inverse3, *x, *y;
+    std::vector<unsigned char> buffer;
+    size_t infinity_key; // ToUint64() of the point at infinity: the hash of an all-zero buffer
+
+    BatchPointHasher()
+    {
+        int thread_num = omp_get_thread_num();
+        mont_ctx = BN_MONT_CTX_new();
+        CRYPTO_CHECK(1 == BN_MONT_CTX_set(mont_ctx, curve_params_p, bn_ctx[thread_num]));
+        inverse = BN_new(); z_inverse = BN_new(); z_inverse2 = BN_new(); z_inverse3 = BN_new();
+        x = BN_new(); y = BN_new();
+        buffer.assign(POINT_COMPRESSED_BYTE_LEN, 0);
+        infinity_key = MurmurHash64A(buffer.data(), POINT_COMPRESSED_BYTE_LEN, fixed_salt64);
+    }
 
-void BuildSaveTable(ECPoint &g, size_t RANGE_LEN, size_t TRADEOFF_NUM, std::string table_filename)
-{
-    
-    std::cout << "begin to build and save " << table_filename << " >>> " << std::endl;
-    auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    size_t BABYSTEP_NUM = pow(2, RANGE_LEN/2 + TRADEOFF_NUM); // babystep num = single giantstep size
+    BatchPointHasher(const BatchPointHasher&) = delete;
+    BatchPointHasher& operator=(const BatchPointHasher&) = delete;
 
-    /*
-    * to show full power of omp, this value is not real CPU core number
-    * but an emprical value, should less than and dividable by BABYSTEP_NUM 
-    */
+    ~BatchPointHasher()
+    {
+        BN_MONT_CTX_free(mont_ctx);
+        for(auto i = 0; i < vec_X.size(); i++){
+            BN_free(vec_X[i]); BN_free(vec_Y[i]); BN_free(vec_Z[i]); BN_free(vec_prefix[i]);
+        }
+        BN_free(inverse); BN_free(z_inverse); BN_free(z_inverse2); BN_free(z_inverse3);
+        BN_free(x); BN_free(y);
+    }
+
+    // vec_key[i] = vec_A[i].ToUint64() for i in [0, LEN)
+    void Hash(const std::vector<ECPoint> &vec_A, size_t LEN, std::vector<size_t> &vec_key)
+    {
+        if(LEN == 0) return;
+        int thread_num = omp_get_thread_num();
+        BN_CTX *ctx = bn_ctx[thread_num];
+        while(vec_X.size() < LEN){
+            vec_X.emplace_back(BN_new()); vec_Y.emplace_back(BN_new());
+            vec_Z.emplace_back(BN_new()); vec_prefix.emplace_back(BN_new());
+        }
 
-    size_t SLICED_BABYSTEP_NUM = BABYSTEP_NUM/BUILD_TASK_NUM; 
+        // prefix[i] = Z[0]*...*Z[i] in Montgomery form, Z = 0 (the point at infinity) is replaced by 1
+        for(auto i = 0; i < LEN; i++){
+            CRYPTO_CHECK(1 == EC_POINT_get_Jprojective_coordinates_GFp(group, vec_A[i].point_ptr,
+                                                                      vec_X[i], vec_Y[i], vec_Z[i], ctx));
+            if(BN_is_zero(vec_Z[i])) BN_one(vec_Z[i]);
+            BN_to_montgomery(vec_Z[i], vec_Z[i], mont_ctx, ctx);
+            if(i == 0) BN_copy(vec_prefix[0], vec_Z[0]);
+            else BN_mod_mul_montgomery(vec_prefix[i], vec_prefix[i-1], vec_Z[i], mont_ctx, ctx);
+        }
 
-    std::vector<ECPoint> startpoint(BUILD_TASK_NUM); 
-    std::vector<size_t> startindex(BUILD_TASK_NUM); 
+        // the only inversion: inverse = (Z[0]*...*Z[LEN-1])^{-1} in Montgomery form
+        BN_from_montgomery(inverse, vec_prefix[LEN-1], mont_ctx, ctx);
+        CRYPTO_CHECK(nullptr != BN_mod_inverse(inverse, inverse, curve_params_p, ctx));
+        BN_to_montgomery(inverse, inverse, mont_ctx, ctx);
 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for (auto i = 0; i < BUILD_TASK_NUM; i++){
-        startindex[i] = i * SLICED_BABYSTEP_NUM;  // generate start index
-        startpoint[i] = g * startindex[i];     // compute start point
+        for(auto i = LEN; i-- > 0; ){
+            if(i > 0){
+                BN_mod_mul_montgomery(z_inverse, inverse, vec_prefix[i-1], mont_ctx, ctx);
+                BN_mod_mul_montgomery(inverse, inverse, vec_Z[i], mont_ctx, ctx);
+            }
+            else BN_copy(z_inverse, inverse);
+            if(EC_POINT_is_at_infinity(group, vec_A[i].point_ptr)){
+                vec_key[i] = infinity_key;
+                continue;
+            }
+            // X, Y are not in Montgomery form, so the products are plain: x = X/Z^2, y = Y/Z^3
+            BN_mod_mul_montgomery(z_inverse2, z_inverse, z_inverse, mont_ctx, ctx);
+            BN_mod_mul_montgomery(z_inverse3, z_inverse2, z_inverse, mont_ctx, ctx);
+            BN_mod_mul_montgomery(x, vec_X[i], z_inverse2, mont_ctx, ctx);
+            BN_mod_mul_montgomery(y, vec_Y[i], z_inverse3, mont_ctx, ctx);
+            // compressed encoding as EC_POINT_point2oct: 0x02 | parity of y, then x
+            buffer[0] = 0x02 | BN_is_odd(y);
+            BN_bn2binpad(x, buffer.data() + 1, POINT_COMPRESSED_BYTE_LEN - 1);
+            vec_key[i] = MurmurHash64A(buffer.data(), POINT_COMPRESSED_BYTE_LEN, fixed_salt64);
+        }
     }
-    
-    // allocate memory
-    unsigned char *buffer = new unsigned char[BABYSTEP_NUM * HASH_KEY_LEN]();
-    if(buffer == nullptr)
-    {
-        std::cerr << "fail to create buffer for babystep key table" << std::endl; 
-        exit(EXIT_FAILURE); 
-    } 
+};
 
-    // part 1: parallel build babystep key 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < BUILD_TASK_NUM; i++){ 
-        BuildSlicedKeyTable(g, startpoint[i], startindex[i], SLICED_BABYSTEP_NUM, buffer);
-    }  
+/*
+** a DLOG solver w.r.t. one generator g and one range: it owns the babystep table and the giantstep aux info
+** solvers for different generators or ranges coexist, e.g. one per ElGamal instance
+** the queries are const and only read the table, so they can be issued concurrently, e.g. from a parallel loop or several threads
+*/
+class DLogSolver{
+public:
+    ECPoint g; 
+    size_t RANGE_LEN = 0; 
+    size_t TRADEOFF_NUM = 0; 
+
+    ECPoint giantstep; // giantstep = -g^BABYSTEP_NUM
+    std::vector<ECPoint> vec_searchanchor; // the start offsets of the sliced search ranges
 
-    // part 2: build giantstep aux info 
-    size_t GIANTSTEP_NUM = pow(2, RANGE_LEN/2 - TRADEOFF_NUM); 
-    
     /*
-    ** each search task will search in #SLICED_GIANTSTEP_NUM GIANTSTEP
-    ** the maximum SEACRH_TASK_NUM = GIANTSTEP_NUM
+    ** key-value hash table: key is uint64_t encoding, value is its corresponding DLOG w.r.t. g
+    ** more intuitive solution is using <ECPoint, size_t> hashmap, but its storage cost is high 
+    ** std::unordered_map<size_t, size_t> allocates one node per entry, the flat table keeps 8-byte keys and 4-byte indices in one flat buffer
     */
-    size_t SLICED_GIANTSTEP_NUM = GIANTSTEP_NUM/SEARCH_TASK_NUM; 
-
-    // compute and save giantstep and anchor points for slicedrange
-    giantstep.ReInitialize(); 
-    giantstep = g * BigInt(BABYSTEP_NUM); 
-    giantstep = giantstep.Invert();   // set giantstep = -g^BABYSTEP_NUM
-    
-    ECPoint giantgiantstep = giantstep * BigInt(SLICED_GIANTSTEP_NUM);
-
-    vec_searchanchor.resize(SEARCH_TASK_NUM); 
-    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
-    for (auto i = 0; i < SEARCH_TASK_NUM; i++){
-        vec_searchanchor[i] = giantgiantstep * (BigInt(i));         
+    FlatHashTable encoding2index_map; 
+
+    DLogSolver() {};
+
+    DLogSolver(const ECPoint &g, size_t RANGE_LEN, size_t TRADEOFF_NUM)
+    {
+        CheckDlogParameters(RANGE_LEN, TRADEOFF_NUM); 
+        this->g = g; 
+        this->RANGE_LEN = RANGE_LEN; 
+        this->TRADEOFF_NUM = TRADEOFF_NUM; 
     }
 
-    std::ofstream fout; 
-    fout.open(table_filename, std::ios::binary); 
-    if(!fout)
+    inline size_t BabyStepNum() const
     {
-        std::cerr << table_filename << " open error" << std::endl;
-        exit(1); 
+        return size_t(1) << (RANGE_LEN/2 + TRADEOFF_NUM); // babystep_num = giantstep_size
     }
 
-    // save babystep key to table
-    fout.write(reinterpret_cast<char *>(buffer), BABYSTEP_NUM * HASH_KEY_LEN); 
-    delete[] buffer;
+    inline size_t GiantStepNum() const
+    {
+        return size_t(1) << (RANGE_LEN/2 - TRADEOFF_NUM); 
+    }
 
-    // save giantstep aux info to table
-    fout << giantstep; 
-    for (auto i = 0; i < SEARCH_TASK_NUM; i++){
-        fout << vec_searchanchor[i];         
+    // the table is loaded
+    inline bool Ready() const
+    {
+        return encoding2index_map.Empty() == false; 
     }
 
-    fout.close(); 
-        
-    auto end_time = std::chrono::steady_clock::now(); // end to count the time
-    auto running_time = end_time - start_time;
-    std::cout << "build and save precompute table takes time = " 
-        << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
-}
+    // whether the solver computes DLOG w.r.t. g in the range [0, 2^RANGE_LEN)
+    inline bool Match(const ECPoint &g, size_t RANGE_LEN) const
+    {
+        return this->RANGE_LEN == RANGE_LEN && this->g == g; 
+    }
 
-/* 
-** load table 
-** 1. build hashmap in RAM
-** 2. load aux info to global objects
-*/ 
-void LoadTable(std::string table_filename, size_t RANGE_LEN, size_t TRADEOFF_NUM)
-{   
-    std::cout << "begin to load " << table_filename << " >>>" << std::endl; 
-    auto start_time = std::chrono::steady_clock::now(); // start to count the time
-    size_t BABYSTEP_NUM = pow(2, RANGE_LEN/2 + TRADEOFF_NUM); 
-
-    // read and check table file
-    std::ifstream fin; 
-    fin.open(table_filename, std::ios::binary); 
-    if(!fin)
+    std::string GetTableFileName() const
     {
-        std::cout << table_filename << " read error" << std::endl;
-        exit(EXIT_FAILURE); 
+        std::string str_base = std::to_string(2);
+        std::string str_exp0 = std::to_string(RANGE_LEN);    // range size
+        std::string str_exp1 = std::to_string(RANGE_LEN/2+TRADEOFF_NUM);  // babystep key table size
+        std::string str_exp2 = std::to_string(RANGE_LEN/2-TRADEOFF_NUM-(size_t)log2(SEARCH_TASK_NUM));  // (log) giant step amplification factor: default value=0 
+        // use 8-byte uint64_t hash value as an identifier of EC Point 
+        std::string str_suffix = ToHexString(Hash::ECPointToString(g));
+        str_suffix = str_suffix.substr(0,16);
+
+        std::string table_filename  = str_suffix +"[" + 
+                                      str_base+"^"+str_exp0 + "," + 
+                                      str_base+"^"+str_exp1 + "," + 
+                                      str_base+"^"+str_exp2 + "].mtable"; // the mapped layout, not readable as the old .table files
+        return table_filename; 
     }
-    fin.seekg(0, fin.end);
 
-    size_t FILE_BYTE_LEN = fin.tellg(); // get the size of hash table file 
-    size_t BABYSTEP_KEY_SIZE = BABYSTEP_NUM * HASH_KEY_LEN; 
+    /* 
+    ** generate precompute table, it consists of two parts
+
+    ** part 1 - babystep hashkey: encoding values of [g^0, g^1, ..., g^{BABYSTEP_NUM}]
+    ** standard method is using babystep point as key for point2index hashmap, result in big key size
+    ** to shorten key size, use hash to map babystep point to unique key
 
-    #ifdef ECPOINT_COMPRESSED
-        size_t GIANTSTEP_AUX_SIZE = (SEARCH_TASK_NUM+1) * POINT_COMPRESSED_BYTE_LEN; 
-    #else
-        size_t GIANTSTEP_AUX_SIZE = (SEARCH_TASK_NUM+1) * POINT_BYTE_LEN;
-    #endif
+    ** part 2 - giantstep aux info: (1) giantstep = - g^{BABYSTEP_NUM}; (2) [giantstep^{i*factor}]: i=[SEARCH_TASK_NUM]
 
-    if (FILE_BYTE_LEN != (BABYSTEP_KEY_SIZE+GIANTSTEP_AUX_SIZE))
+    ** the file holds the final lookup structure: | header | table parameters | aux info | padding | flat hash table |
+    ** see FlatHashTable::WriteMappedObject, so that LoadTable maps it instead of rebuilding the hashmap
+    ** the solver itself is left untouched, call LoadTable to use the table
+    */
+    void BuildSaveTable(std::string table_filename) const
     {
-        std::cout << "table size does not match" << std::endl; 
-        exit(EXIT_FAILURE); 
-    }
+        std::cout << "begin to build and save " << table_filename << " >>> " << std::endl;
+        auto start_time = std::chrono::steady_clock::now(); // start to count the time
+        size_t BABYSTEP_NUM = BabyStepNum(); 
 
-    std::cout << table_filename << " size = " << (double)FILE_BYTE_LEN/pow(2,20) << " MB" << std::endl;
+        /*
+        * to show full power of omp, this value is not real CPU core number
+        * but an emprical value, should less than and dividable by BABYSTEP_NUM 
+        */
 
-    fin.seekg(0);                  // reset the file pointer to the beginning of file
+        size_t SLICED_BABYSTEP_NUM = BABYSTEP_NUM/BUILD_TASK_NUM; 
 
-    // construct hashmap from babystep key 
-    unsigned char* buffer = new unsigned char[BABYSTEP_NUM * HASH_KEY_LEN]();  
-    if(buffer == nullptr)
-    {
-        std::cerr << "fail to create buffer for babystep table" << std::endl; 
-        exit(EXIT_FAILURE); 
+        std::vector<ECPoint> startpoint(BUILD_TASK_NUM); 
+        std::vector<size_t> startindex(BUILD_TASK_NUM); 
+
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for (auto i = 0; i < BUILD_TASK_NUM; i++){
+            startindex[i] = i * SLICED_BABYSTEP_NUM;  // generate start index
+            startpoint[i] = g * startindex[i];     // compute start point
+        }
+        
+        // allocate memory
+        unsigned char *buffer = new unsigned char[BABYSTEP_NUM * HASH_KEY_LEN]();
+        if(buffer == nullptr)
+        {
+            std::cerr << "fail to create buffer for babystep key table" << std::endl; 
+            exit(EXIT_FAILURE); 
+        } 
+
+        // part 1: parallel build babystep key 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < BUILD_TASK_NUM; i++){ 
+            BuildSlicedKeyTable(g, startpoint[i], startindex[i], SLICED_BABYSTEP_NUM, buffer);
+        }  
+
+        // build the lookup structure once here, instead of at every load
+        FlatHashTable babystep_table(BABYSTEP_NUM); 
+        babystep_table.InsertBatch(buffer, BABYSTEP_NUM); 
+        delete[] buffer;
+
+        // part 2: build giantstep aux info 
+        
+        /*
+        ** each search task will search in #SLICED_GIANTSTEP_NUM GIANTSTEP
+        ** the maximum SEACRH_TASK_NUM = GIANTSTEP_NUM
+        */
+        size_t SLICED_GIANTSTEP_NUM = GiantStepNum()/SEARCH_TASK_NUM; 
+
+        // compute and save giantstep and anchor points for slicedrange
+        ECPoint new_giantstep = g * BigInt(BABYSTEP_NUM); 
+        new_giantstep = new_giantstep.Invert();   // set giantstep = -g^BABYSTEP_NUM
+        
+        ECPoint giantgiantstep = new_giantstep * BigInt(SLICED_GIANTSTEP_NUM);
+
+        std::vector<ECPoint> new_searchanchor(SEARCH_TASK_NUM); 
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for (auto i = 0; i < SEARCH_TASK_NUM; i++){
+            new_searchanchor[i] = giantgiantstep * (BigInt(i));         
+        }
+
+        std::vector<uint8_t> aux(DlogAuxSize()); 
+        uint64_t field[3] = {RANGE_LEN, TRADEOFF_NUM, SEARCH_TASK_NUM}; 
+        memcpy(aux.data(), field, 3*sizeof(uint64_t)); 
+        unsigned char *point_buffer = aux.data() + 3*sizeof(uint64_t); 
+        EC_POINT_point2oct(group, new_giantstep.point_ptr, POINT_CONVERSION_COMPRESSED, 
+                           point_buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[omp_get_thread_num()]);
+        for (auto i = 0; i < SEARCH_TASK_NUM; i++){
+            EC_POINT_point2oct(group, new_searchanchor[i].point_ptr, POINT_CONVERSION_COMPRESSED, 
+                               point_buffer + (i+1)*POINT_COMPRESSED_BYTE_LEN, POINT_COMPRESSED_BYTE_LEN, bn_ctx[omp_get_thread_num()]);
+        }
+
+        if(babystep_table.WriteMappedObject(table_filename, DLOG_TABLE_MAGIC, aux) == false)
+        {
+            std::cerr << table_filename << " write error" << std::endl;
+            exit(EXIT_FAILURE); 
+        }
+            
+        auto end_time = std::chrono::steady_clock::now(); // end to count the time
+        auto running_time = end_time - start_time;
+        std::cout << "build and save precompute table takes time = " 
+            << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
     }
-    fin.read(reinterpret_cast<char*>(buffer), BABYSTEP_KEY_SIZE); // read file from disk to RAM
 
-    #pragma omp parallel
-    #pragma omp sections
-    {
-        #pragma omp section
+    /* 
+    ** load table 
+    ** 1. map the hashmap read-only: nothing is rebuilt, pages are faulted in by the first queries
+    **    and shared through the page cache by all processes and solvers that load the same table
+    ** 2. load aux info to the solver
+    */ 
+    void LoadTable(std::string table_filename, bool verify_checksum = false)
+    {   
+        std::cout << "begin to load " << table_filename << " >>>" << std::endl; 
+        auto start_time = std::chrono::steady_clock::now(); // start to count the time
+
+        std::vector<uint8_t> aux; 
+        if(encoding2index_map.MapObject(table_filename, DLOG_TABLE_MAGIC, aux, verify_checksum) == false)
         {
-            size_t hashkey; 
-            encoding2index_map.reserve(BABYSTEP_NUM); 
-            /* point_to_index_map[ECn_to_String(babystep)] = i */
-            for(auto i = 0; i < BABYSTEP_NUM; i++)
-            {
-                std::memcpy(&hashkey, buffer + i * HASH_KEY_LEN, HASH_KEY_LEN);
-                encoding2index_map[hashkey] = i; 
-            }
-            delete[] buffer; 
+            std::cerr << table_filename << " read error" << std::endl;
+            exit(EXIT_FAILURE); 
         }
 
-        #pragma omp section
+        // read and check table parameters
+        uint64_t field[3] = {0, 0, 0}; 
+        if(aux.size() == DlogAuxSize()) memcpy(field, aux.data(), 3*sizeof(uint64_t)); 
+        if (field[0] != RANGE_LEN || field[1] != TRADEOFF_NUM || field[2] != SEARCH_TASK_NUM 
+            || encoding2index_map.Size() != BabyStepNum())
         {
-            giantstep.ReInitialize();
-            fin >> giantstep; 
+            std::cerr << "table parameters do not match" << std::endl; 
+            exit(EXIT_FAILURE); 
+        }
 
-            vec_searchanchor.resize(SEARCH_TASK_NUM); 
-            for(auto i = 0; i < SEARCH_TASK_NUM; i++){
-                fin >> vec_searchanchor[i]; 
-            }
-            fin.close(); 
+        std::cout << table_filename << " size = " << (double)encoding2index_map.mapping->file_len/pow(2,20) << " MB" << std::endl;
+
+        const unsigned char *point_buffer = aux.data() + 3*sizeof(uint64_t); 
+        giantstep.ReInitialize();
+        EC_POINT_oct2point(group, giantstep.point_ptr, point_buffer, POINT_COMPRESSED_BYTE_LEN, bn_ctx[omp_get_thread_num()]);
+
+        vec_searchanchor.resize(SEARCH_TASK_NUM); 
+        for(auto i = 0; i < SEARCH_TASK_NUM; i++){
+            EC_POINT_oct2point(group, vec_searchanchor[i].point_ptr, point_buffer + (i+1)*POINT_COMPRESSED_BYTE_LEN, 
+                               POINT_COMPRESSED_BYTE_LEN, bn_ctx[omp_get_thread_num()]);
         }
-    }
-    
-    auto end_time = std::chrono::steady_clock::now(); // end to count the time
-    auto running_time = end_time - start_time;
-    std::cout << "load table (build hashmap + aux info) takes time = " 
-    << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
-} 
+        
+        auto end_time = std::chrono::steady_clock::now(); // end to count the time
+        auto running_time = end_time - start_time;
+        std::cout << "load table (map hashmap + aux info) takes time = " 
+        << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    } 
 
+    // build the table if it is not on disk yet, then load it
+    void Initialize(bool verify_checksum = false)
+    {
+        std::string table_filename = GetTableFileName(); 
+        /* generate and save table */
+        if(FileExist(table_filename) == false){
+            std::cout << table_filename << " does not exist" << std::endl;
+            BuildSaveTable(table_filename);
+        }
+        
+        // load the table from file 
+        std::cout << table_filename << " already exists" << std::endl;
+        LoadTable(table_filename, verify_checksum); 
+    }
 
-/* parallelizable search task */
-bool SearchSlicedRange(size_t SEARCH_TASK_INDEX, ECPoint target, size_t &SLICED_GIANTSTEP_NUM, 
-                       size_t &babystep_index, size_t &giantstep_index, bool &FIND)
-{    
-    // obtain relative target in sliced range
-    target = target + vec_searchanchor[SEARCH_TASK_INDEX]; 
-    size_t hashkey; 
-    // giantgiant-step 
-    for(giantstep_index = 0; giantstep_index < SLICED_GIANTSTEP_NUM; giantstep_index++)
+    inline void AssertReady() const
     {
-        // giantstep search in each loop
-        if(FIND == true) break; 
-        // map the point to keyvalue
-        hashkey = target.ToUint64(); 
-
-        // baby-step search in the hash map
-        if (encoding2index_map.find(hashkey) == encoding2index_map.end())
-        { 
-            target = target + giantstep; 
+        if(Ready() == false)
+        {
+            std::cerr << "the DLOG table is not loaded" << std::endl; 
+            exit(EXIT_FAILURE);
         }
-        else{
-            babystep_index = encoding2index_map[hashkey]; 
-            return true;
+    }
+
+    /* parallelizable search task */
+    bool SearchSlicedRange(size_t SEARCH_TASK_INDEX, ECPoint target, size_t SLICED_GIANTSTEP_NUM, 
+                           size_t &babystep_index, size_t &giantstep_index, const bool &FIND) const
+    {    
+        // obtain relative target in sliced range
+        target = target + vec_searchanchor[SEARCH_TASK_INDEX]; 
+        size_t hashkey; 
+        uint32_t index; 
+        // giantgiant-step 
+        for(giantstep_index = 0; giantstep_index < SLICED_GIANTSTEP_NUM; giantstep_index++)
+        {
+            // giantstep search in each loop
+            if(FIND == true) break; 
+            // map the point to keyvalue
+            hashkey = target.ToUint64(); 
+
+            // baby-step search in the hash map
+            if (encoding2index_map.Find(hashkey, index) == false)
+            { 
+                target = target + giantstep; 
+            }
+            else{
+                babystep_index = index; 
+                return true;
+            }
         }
+        return false; 
     }
-    return false; 
-}
 
+    // compute x = log_g h
+    bool Solve(const ECPoint &h, BigInt &x) const
+    {    
+        AssertReady(); 
+        size_t SLICED_GIANTSTEP_NUM = GiantStepNum()/SEARCH_TASK_NUM;  
+        
+        /* begin to search */
+        std::vector<size_t> babystep_index(SEARCH_TASK_NUM); 
+        std::vector<size_t> giantstep_index(SEARCH_TASK_NUM); // relative giantstep index in sub-search task
 
+        // a beacon value: used to notify other tasks break if one task has already succeed
+        bool FIND = false;
 
-// compute x = log_g h
-bool ShanksDLOG(const ECPoint &g, const ECPoint &h, size_t RANGE_LEN, size_t TRADEOFF_NUM, BigInt &x)
-{    
-    size_t BABYSTEP_NUM  = pow(2, RANGE_LEN/2 + TRADEOFF_NUM); // babystep_num = giantstep_size
-    size_t GIANTSTEP_NUM = pow(2, RANGE_LEN/2 - TRADEOFF_NUM); 
+        #pragma omp parallel for shared(FIND) num_threads(NUMBER_OF_THREADS)
+        for(auto i = 0; i < SEARCH_TASK_NUM; i++){
+            if(FIND == false)
+            {
+                if(SearchSlicedRange(i, h, SLICED_GIANTSTEP_NUM, babystep_index[i], giantstep_index[i], FIND) == true)
+                {
+                    x = BigInt(babystep_index[i]) + BigInt(giantstep_index[i] + i * SLICED_GIANTSTEP_NUM) * BigInt(BabyStepNum()); 
+                    FIND = true;
+                } 
+            } 
+        }
 
-    size_t SLICED_GIANTSTEP_NUM = GIANTSTEP_NUM/SEARCH_TASK_NUM;  
-    
-    /* begin to search */
-    std::vector<size_t> babystep_index(SEARCH_TASK_NUM); 
-    std::vector<size_t> giantstep_index(SEARCH_TASK_NUM); // relative giantstep index in sub-search task
+        return FIND; 
+    }
 
-    // check if the hash map is empty
-    if(encoding2index_map.empty() == true)
+    /*
+    ** compute vec_x[i] = log_g vec_h[i] for all targets, vec_found[i] = 0 if vec_h[i] is out of range
+    ** each target is searched by SEARCH_TASK_NUM walks as in Solve, and the walks of BATCH_TARGET_NUM targets
+    ** take their giant steps in lockstep, so that the keys of all walks are computed by one BatchPointHasher call
+    ** batches of targets are searched in parallel, the walks of a target stop as soon as it is found
+    */
+    std::vector<uint8_t> Solve(const std::vector<ECPoint> &vec_h, std::vector<BigInt> &vec_x) const
     {
-        std::cout << "the hashmap is empty" << std::endl; 
-        exit (EXIT_FAILURE);
-    }
+        AssertReady(); 
+        size_t BABYSTEP_NUM = BabyStepNum(); 
+        size_t SLICED_GIANTSTEP_NUM = GiantStepNum()/SEARCH_TASK_NUM;
+
+        size_t TARGET_NUM = vec_h.size();
+        size_t BATCH_NUM = (TARGET_NUM + BATCH_TARGET_NUM - 1)/BATCH_TARGET_NUM;
+        vec_x.resize(TARGET_NUM);
+        std::vector<uint8_t> vec_found(TARGET_NUM, 0);
+
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS) schedule(dynamic)
+        for(auto b = 0; b < BATCH_NUM; b++){
+            int thread_num = omp_get_thread_num();
+            size_t BEGIN = b*BATCH_TARGET_NUM;
+            size_t END = std::min(BEGIN + BATCH_TARGET_NUM, TARGET_NUM);
+
+            // walk k of target i starts from vec_h[i] + vec_searchanchor[k]
+            size_t WALK_NUM = (END - BEGIN)*SEARCH_TASK_NUM;
+            std::vector<ECPoint> vec_walk(WALK_NUM);
+            std::vector<size_t> vec_walk_target(WALK_NUM), vec_walk_task(WALK_NUM);
+            for(auto i = BEGIN; i < END; i++){
+                for(auto k = 0; k < SEARCH_TASK_NUM; k++){
+                    size_t w = (i - BEGIN)*SEARCH_TASK_NUM + k;
+                    vec_walk[w] = vec_h[i] + vec_searchanchor[k];
+                    vec_walk_target[w] = i;
+                    vec_walk_task[w] = k;
+                }
+            }
 
-    // a beacon value: used to notify other tasks break if one task has already succeed
-    bool FIND = false;
+            BatchPointHasher hasher;
+            std::vector<size_t> vec_key(WALK_NUM);
+            for(auto j = 0; j < SLICED_GIANTSTEP_NUM && WALK_NUM > 0; j++){
+                hasher.Hash(vec_walk, WALK_NUM, vec_key);
+                for(auto w = 0; w < WALK_NUM; w++){
+                    uint32_t index;
+                    size_t i = vec_walk_target[w];
+                    if(vec_found[i] == 0 && encoding2index_map.Find(vec_key[w], index) == true){
+                        vec_x[i] = BigInt(index) + BigInt(j + vec_walk_task[w] * SLICED_GIANTSTEP_NUM) * BigInt(BABYSTEP_NUM);
+                        vec_found[i] = 1;
+                    }
+                }
+                // drop the walks of found targets, and advance the others by one giant step
+                size_t ACTIVE_NUM = 0;
+                for(auto w = 0; w < WALK_NUM; w++){
+                    if(vec_found[vec_walk_target[w]] == 1) continue;
+                    if(ACTIVE_NUM != w){
+                        std::swap(vec_walk[ACTIVE_NUM].point_ptr, vec_walk[w].point_ptr);
+                        vec_walk_target[ACTIVE_NUM] = vec_walk_target[w];
+                        vec_walk_task[ACTIVE_NUM] = vec_walk_task[w];
+                    }
+                    CRYPTO_CHECK(1 == EC_POINT_add(group, vec_walk[ACTIVE_NUM].point_ptr, vec_walk[ACTIVE_NUM].point_ptr,
+                                                   giantstep.point_ptr, bn_ctx[thread_num]));
+                    ACTIVE_NUM++;
+                }
+                WALK_NUM = ACTIVE_NUM;
+            }
+        }
 
-    #pragma omp parallel for shared(FIND) num_threads(NUMBER_OF_THREADS)
-    for(auto i = 0; i < SEARCH_TASK_NUM; i++){
-        if(FIND == false)
-        {
-            if(SearchSlicedRange(i, h, SLICED_GIANTSTEP_NUM, babystep_index[i], giantstep_index[i], FIND) == true)
-            {
-                x = BigInt(babystep_index[i]) + BigInt(giantstep_index[i] + i * SLICED_GIANTSTEP_NUM) * BigInt(BABYSTEP_NUM); 
-                FIND = true;
-            } 
-        } 
+        return vec_found;
     }
+};
 
-    return FIND; 
-}
 # endif
 
 // class naivehash{
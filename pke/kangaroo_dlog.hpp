@@ -0,0 +1,465 @@
+/****************************************************************************
+this hpp implements Pollard's kangaroo algorithm with a precomputed table of distinguished points
+*****************************************************************************
+* @author     This file is part of Kunlun, developed by Yu Chen
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_KANGAROO_DLOG_HPP_
+#define KUNLUN_KANGAROO_DLOG_HPP_
+
+/*
+** DLOG problem: given (g, h) find x \in [0, n = 2^RANGE_LEN) s.t. g^x = h, for ranges whose Shanks table does not fit in RAM
+** parallel kangaroos with distinguished points (van Oorschot-Wiener), and a precomputed table of distinguished points
+** as in "Computing small discrete logarithms faster" (Bernstein-Lange, Indocrypt 2012)
+** (1) a walk jumps from P to P + g^{s_j}, where j is read from the key of P, so walks that meet stay together
+** (2) P is distinguished iff LOG_WALK_LEN bits of its key are zero, so a walk reaches one after W = 2^LOG_WALK_LEN steps on average
+** (3) precomputation: tame walks start from random g^a, the 2^LOG_TABLE_SIZE distinguished points hit most often are kept
+** (4) query: KANGAROO_WALK_NUM wild walks start from h + g^y, once one of them reaches a distinguished point of the table,
+**     x = a + (distance of the tame walk) - y - (distance of the wild walk)
+** (5) the walks of a batch advance in lockstep in affine coordinates, so the slopes of one step share one field inversion
+** with T = 2^LOG_TABLE_SIZE and K = KANGAROO_WALK_NUM, W = sqrt(n/(T*K)) and a query takes about 2*sqrt(n*K/T) steps:
+** a 4x larger table halves the query time, at the cost of KANGAROO_OVERSAMPLE*T*W steps of precomputation
+*/
+
+#include "../crypto/ec_point.hpp"
+#include "../crypto/hash.hpp"
+#include "../utility/flat_hash_table.hpp"
+#include "../utility/print.hpp"
+
+inline const size_t KANGAROO_WALK_NUM = 32;  // walks per batch, they share the inversion of a step
+inline const size_t KANGAROO_JUMP_BIT = 6;   // the low bits of a key pick one of 2^KANGAROO_JUMP_BIT jumps
+inline const size_t KANGAROO_JUMP_NUM = size_t(1) << KANGAROO_JUMP_BIT;
+inline const size_t KANGAROO_OVERSAMPLE = 4; // distinguished points found per table entry during precomputation
+inline const size_t KANGAROO_WALK_CAP = 16;  // a walk longer than KANGAROO_WALK_CAP*W is assumed to loop and is restarted
+inline const size_t KANGAROO_QUERY_CAP = 16; // a query gives up after KANGAROO_QUERY_CAP times the expected number of steps
+
+// magic of the table file, see WriteObject
+inline const char KANGAROO_TABLE_MAGIC[8] = "KLKANGA";
+
+class KangarooDLOG{
+public:
+    ECPoint g;
+    size_t RANGE_LEN = 0;
+    size_t LOG_TABLE_SIZE = 0;
+    size_t LOG_WALK_LEN = 0;
+
+    std::vector<uint64_t> vec_jump_exponent; // s_j, uniform in [1, n/(2W)]
+    FlatHashTable dp_table;                  // key of a distinguished point -> index of its exponent
+    std::vector<uint64_t> vec_dp_exponent;
+
+    BN_MONT_CTX *mont_ctx = nullptr;
+    std::vector<BIGNUM*> vec_jump_x, vec_jump_y; // g^{s_j} in affine coordinates, in Montgomery form
+
+    // the state of a batch of walks, coordinates are in Montgomery form
+    struct WalkBatch{
+        std::vector<BIGNUM*> vec_x, vec_y, vec_diff, vec_prefix;
+        std::vector<uint64_t> vec_key;      // the low 64 bits of x
+        std::vector<uint64_t> vec_start;    // a of a tame walk, y of a wild walk
+        std::vector<uint64_t> vec_distance; // sum of the jumps taken
+        std::vector<size_t> vec_step_num;
+        std::vector<uint8_t> vec_restart;   // the walk hit the point at infinity or a degenerate addition
+        BIGNUM *inverse, *diff_inverse, *slope, *temp;
+
+        WalkBatch(size_t WALK_NUM)
+        {
+            for(auto i = 0; i < WALK_NUM; i++){
+                vec_x.emplace_back(BN_new()); vec_y.emplace_back(BN_new());
+                vec_diff.emplace_back(BN_new()); vec_prefix.emplace_back(BN_new());
+            }
+            vec_key.resize(WALK_NUM);
+            vec_start.resize(WALK_NUM);
+            vec_distance.resize(WALK_NUM);
+            vec_step_num.resize(WALK_NUM);
+            vec_restart.resize(WALK_NUM);
+            inverse = BN_new(); diff_inverse = BN_new(); slope = BN_new(); temp = BN_new();
+        }
+
+        WalkBatch(const WalkBatch&) = delete;
+        WalkBatch& operator=(const WalkBatch&) = delete;
+
+        ~WalkBatch()
+        {
+            for(auto i = 0; i < vec_x.size(); i++){
+                BN_free(vec_x[i]); BN_free(vec_y[i]); BN_free(vec_diff[i]); BN_free(vec_prefix[i]);
+            }
+            BN_free(inverse); BN_free(diff_inverse); BN_free(slope); BN_free(temp);
+        }
+    };
+
+    KangarooDLOG() {};
+
+    /*
+    ** W is chosen to balance the two phases of a query: n/(T*K) steps before a wild walk runs into a tame path,
+    ** and W steps from there to the distinguished point
+    */
+    KangarooDLOG(const ECPoint &g, size_t RANGE_LEN, size_t LOG_TABLE_SIZE)
+    {
+        this->g = g;
+        this->RANGE_LEN = RANGE_LEN;
+        this->LOG_TABLE_SIZE = LOG_TABLE_SIZE;
+        size_t LOG_WALK_NUM = size_t(log2(KANGAROO_WALK_NUM));
+        if(RANGE_LEN > 60 || RANGE_LEN < LOG_TABLE_SIZE + LOG_WALK_NUM + 2 || LOG_TABLE_SIZE > 30){
+            std::cerr << "kangaroo parameters are out of range: RANGE_LEN <= 60, LOG_TABLE_SIZE <= 30 and "
+                      << "RANGE_LEN >= LOG_TABLE_SIZE + " << LOG_WALK_NUM + 2 << " are required" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        LOG_WALK_LEN = (RANGE_LEN - LOG_TABLE_SIZE - LOG_WALK_NUM)/2;
+    }
+
+    KangarooDLOG(const KangarooDLOG&) = delete;
+    KangarooDLOG& operator=(const KangarooDLOG&) = delete;
+
+    ~KangarooDLOG()
+    {
+        FreeJumps();
+    }
+
+    inline void FreeJumps()
+    {
+        for(auto j = 0; j < vec_jump_x.size(); j++){
+            BN_free(vec_jump_x[j]);
+            BN_free(vec_jump_y[j]);
+        }
+        vec_jump_x.clear();
+        vec_jump_y.clear();
+        if(mont_ctx != nullptr) BN_MONT_CTX_free(mont_ctx);
+        mont_ctx = nullptr;
+    }
+
+    std::string GetTableFileName() const
+    {
+        std::string str_suffix = ToHexString(Hash::ECPointToString(g)).substr(0, 16);
+        return str_suffix + "[2^" + std::to_string(RANGE_LEN) + ",2^" + std::to_string(LOG_TABLE_SIZE) + "].kangaroo";
+    }
+
+    // compute the jump points g^{s_j} from vec_jump_exponent
+    inline void InitializeJumps()
+    {
+        FreeJumps();
+        BN_CTX *ctx = bn_ctx[omp_get_thread_num()];
+        mont_ctx = BN_MONT_CTX_new();
+        CRYPTO_CHECK(1 == BN_MONT_CTX_set(mont_ctx, curve_params_p, ctx));
+        for(auto j = 0; j < KANGAROO_JUMP_NUM; j++){
+            ECPoint jump = g * BigInt(vec_jump_exponent[j]);
+            vec_jump_x.emplace_back(BN_new());
+            vec_jump_y.emplace_back(BN_new());
+            CRYPTO_CHECK(1 == EC_POINT_get_affine_coordinates(group, jump.point_ptr, vec_jump_x[j], vec_jump_y[j], ctx));
+            BN_to_montgomery(vec_jump_x[j], vec_jump_x[j], mont_ctx, ctx);
+            BN_to_montgomery(vec_jump_y[j], vec_jump_y[j], mont_ctx, ctx);
+        }
+    }
+
+    // the key of a point is the low 64 bits of its x coordinate in Montgomery form, key_buffer is a scratch BIGNUM
+    inline uint64_t Key(const BIGNUM *x, BIGNUM *key_buffer) const
+    {
+        BN_copy(key_buffer, x);
+        BN_mask_bits(key_buffer, 64);
+        return BN_get_word(key_buffer);
+    }
+
+    inline bool IsDistinguished(uint64_t key) const
+    {
+        return ((key >> KANGAROO_JUMP_BIT) & ((uint64_t(1) << LOG_WALK_LEN) - 1)) == 0;
+    }
+
+    // walk i of batch restarts from P = g^start (tame) or h + g^start (wild)
+    inline void StartWalk(WalkBatch &batch, size_t i, const ECPoint &P, uint64_t start) const
+    {
+        BN_CTX *ctx = bn_ctx[omp_get_thread_num()];
+        batch.vec_start[i] = start;
+        batch.vec_distance[i] = 0;
+        batch.vec_step_num[i] = 0;
+        batch.vec_restart[i] = P.IsAtInfinity();
+        if(batch.vec_restart[i] == 1) return;
+        CRYPTO_CHECK(1 == EC_POINT_get_affine_coordinates(group, P.point_ptr, batch.vec_x[i], batch.vec_y[i], ctx));
+        BN_to_montgomery(batch.vec_x[i], batch.vec_x[i], mont_ctx, ctx);
+        BN_to_montgomery(batch.vec_y[i], batch.vec_y[i], mont_ctx, ctx);
+        batch.vec_key[i] = Key(batch.vec_x[i], batch.slope);
+    }
+
+    /*
+    ** one step of all walks: P_i + J_i = (s^2 - x_i - x_J, s(x_i - x_3) - y_i) with slope s = (y_J - y_i)/(x_J - x_i)
+    ** the inverses of all x_J - x_i are computed with one inversion and 3 multiplications per walk
+    */
+    inline void Step(WalkBatch &batch) const
+    {
+        BN_CTX *ctx = bn_ctx[omp_get_thread_num()];
+        size_t WALK_NUM = batch.vec_x.size();
+        for(auto i = 0; i < WALK_NUM; i++){
+            size_t j = batch.vec_key[i] & (KANGAROO_JUMP_NUM - 1);
+            if(batch.vec_restart[i] == 0){
+                BN_mod_sub_quick(batch.vec_diff[i], vec_jump_x[j], batch.vec_x[i], curve_params_p);
+                // P_i = +-J_i is negligible, but it would zero the product of the whole batch
+                if(BN_is_zero(batch.vec_diff[i])) batch.vec_restart[i] = 1;
+            }
+            if(batch.vec_restart[i] == 1) BN_one(batch.vec_diff[i]);
+            if(i == 0) BN_copy(batch.vec_prefix[0], batch.vec_diff[0]);
+            else BN_mod_mul_montgomery(batch.vec_prefix[i], batch.vec_prefix[i-1], batch.vec_diff[i], mont_ctx, ctx);
+        }
+
+        BN_from_montgomery(batch.inverse, batch.vec_prefix[WALK_NUM-1], mont_ctx, ctx);
+        CRYPTO_CHECK(nullptr != BN_mod_inverse(batch.inverse, batch.inverse, curve_params_p, ctx));
+        BN_to_montgomery(batch.inverse, batch.inverse, mont_ctx, ctx);
+
+        for(auto i = WALK_NUM; i-- > 0; ){
+            if(i > 0){
+                BN_mod_mul_montgomery(batch.diff_inverse, batch.inverse, batch.vec_prefix[i-1], mont_ctx, ctx);
+                BN_mod_mul_montgomery(batch.inverse, batch.inverse, batch.vec_diff[i], mont_ctx, ctx);
+            }
+            else BN_copy(batch.diff_inverse, batch.inverse);
+            if(batch.vec_restart[i] == 1) continue;
+
+            size_t j = batch.vec_key[i] & (KANGAROO_JUMP_NUM - 1);
+            BN_mod_sub_quick(batch.slope, vec_jump_y[j], batch.vec_y[i], curve_params_p);
+            BN_mod_mul_montgomery(batch.slope, batch.slope, batch.diff_inverse, mont_ctx, ctx);
+            // temp = x_3 = s^2 - x_i - x_J
+            BN_mod_mul_montgomery(batch.temp, batch.slope, batch.slope, mont_ctx, ctx);
+            BN_mod_sub_quick(batch.temp, batch.temp, batch.vec_x[i], curve_params_p);
+            BN_mod_sub_quick(batch.temp, batch.temp, vec_jump_x[j], curve_params_p);
+            // y_3 = s(x_i - x_3) - y_i
+            BN_mod_sub_quick(batch.vec_x[i], batch.vec_x[i], batch.temp, curve_params_p);
+            BN_mod_mul_montgomery(batch.vec_x[i], batch.vec_x[i], batch.slope, mont_ctx, ctx);
+            BN_mod_sub_quick(batch.vec_y[i], batch.vec_x[i], batch.vec_y[i], curve_params_p);
+            std::swap(batch.vec_x[i], batch.temp);
+
+            batch.vec_key[i] = Key(batch.vec_x[i], batch.slope);
+            batch.vec_distance[i] += vec_jump_exponent[j];
+            batch.vec_step_num[i]++;
+        }
+    }
+
+    /*
+    ** generate the jumps and the table of distinguished points
+    ** NUMBER_OF_THREADS batches of tame walks collect KANGAROO_OVERSAMPLE*T distinguished points in parallel,
+    ** then the T points reached by most walks are kept: they lie on the most travelled paths
+    */
+    void Build()
+    {
+        std::cout << "begin to build kangaroo table: RANGE_LEN = " << RANGE_LEN << ", LOG_TABLE_SIZE = " << LOG_TABLE_SIZE
+                  << ", LOG_WALK_LEN = " << LOG_WALK_LEN << " >>>" << std::endl;
+        auto start_time = std::chrono::steady_clock::now();
+
+        uint64_t RANGE_SIZE = uint64_t(1) << RANGE_LEN;
+        uint64_t MAX_JUMP = std::max<uint64_t>(1, RANGE_SIZE >> (LOG_WALK_LEN + 1)); // mean jump n/(4W)
+        std::mt19937_64 jump_prg((uint64_t(global_built_in_prg()) << 32) | global_built_in_prg());
+        vec_jump_exponent.resize(KANGAROO_JUMP_NUM);
+        for(auto j = 0; j < KANGAROO_JUMP_NUM; j++) vec_jump_exponent[j] = 1 + jump_prg() % MAX_JUMP;
+        InitializeJumps();
+
+        size_t TABLE_SIZE = size_t(1) << LOG_TABLE_SIZE;
+        size_t RECORD_NUM = KANGAROO_OVERSAMPLE * TABLE_SIZE;
+        size_t MAX_STEP_NUM = KANGAROO_WALK_CAP << LOG_WALK_LEN;
+        size_t TASK_NUM = NUMBER_OF_THREADS;
+        std::vector<std::vector<std::pair<uint64_t, uint64_t>>> vec_record(TASK_NUM); // (key, exponent)
+        std::vector<uint64_t> vec_seed(TASK_NUM);
+        for(auto t = 0; t < TASK_NUM; t++) vec_seed[t] = (uint64_t(global_built_in_prg()) << 32) | global_built_in_prg();
+
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+        for(auto t = 0; t < TASK_NUM; t++){
+            std::mt19937_64 prg(vec_seed[t]);
+            size_t QUOTA = RECORD_NUM/TASK_NUM + (t < RECORD_NUM % TASK_NUM);
+            WalkBatch batch(KANGAROO_WALK_NUM);
+            auto restart = [&](size_t i){
+                uint64_t a = 1 + prg() % (RANGE_SIZE - 1);
+                StartWalk(batch, i, g * BigInt(a), a);
+            };
+            for(auto i = 0; i < KANGAROO_WALK_NUM; i++) restart(i);
+            while(vec_record[t].size() < QUOTA){
+                for(auto i = 0; i < KANGAROO_WALK_NUM; i++){
+                    if(batch.vec_restart[i] == 1 || batch.vec_step_num[i] > MAX_STEP_NUM){
+                        restart(i);
+                    }
+                    else if(IsDistinguished(batch.vec_key[i])){
+                        vec_record[t].emplace_back(batch.vec_key[i], batch.vec_start[i] + batch.vec_distance[i]);
+                        restart(i);
+                    }
+                }
+                Step(batch);
+            }
+        }
+
+        // count the walks that reached each distinguished point
+        std::vector<std::pair<uint64_t, uint64_t>> vec_all_record;
+        for(auto t = 0; t < TASK_NUM; t++){
+            vec_all_record.insert(vec_all_record.end(), vec_record[t].begin(), vec_record[t].end());
+        }
+        std::sort(vec_all_record.begin(), vec_all_record.end());
+        std::vector<std::pair<size_t, size_t>> vec_count; // (hit num, position of the first record)
+        for(auto i = 0; i < vec_all_record.size(); ){
+            size_t k = i;
+            while(k < vec_all_record.size() && vec_all_record[k].first == vec_all_record[i].first) k++;
+            vec_count.emplace_back(k - i, i);
+            i = k;
+        }
+        size_t KEEP_NUM = std::min(TABLE_SIZE, vec_count.size());
+        std::partial_sort(vec_count.begin(), vec_count.begin() + KEEP_NUM, vec_count.end(),
+                          [](const std::pair<size_t, size_t> &a, const std::pair<size_t, size_t> &b){ return a.first > b.first; });
+
+        dp_table.Reserve(KEEP_NUM);
+        vec_dp_exponent.resize(KEEP_NUM);
+        for(auto i = 0; i < KEEP_NUM; i++){
+            dp_table.Insert(vec_all_record[vec_count[i].second].first, uint32_t(i));
+            vec_dp_exponent[i] = vec_all_record[vec_count[i].second].second;
+        }
+
+        auto end_time = std::chrono::steady_clock::now();
+        std::cout << "build kangaroo table takes time = "
+                  << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms: "
+                  << vec_all_record.size() << " distinguished points found, " << vec_count.size() << " distinct, "
+                  << KEEP_NUM << " kept" << std::endl;
+    }
+
+    /*
+    ** KANGAROO_WALK_NUM wild walks for h, until one of them reaches a distinguished point of the table
+    ** a match is confirmed by g^x = h, which also rules out collisions of keys
+    */
+    bool Search(const ECPoint &h, uint64_t seed, const bool &FIND, uint64_t &result) const
+    {
+        std::mt19937_64 prg(seed);
+        uint64_t RANGE_SIZE = uint64_t(1) << RANGE_LEN;
+        uint64_t START_RANGE = std::max<uint64_t>(1, RANGE_SIZE >> 2);
+        size_t MAX_STEP_NUM = KANGAROO_WALK_CAP << LOG_WALK_LEN;
+        // rounds of a batch: about W steps to reach the table's paths and W more to the distinguished point
+        size_t WALK_LEN = size_t(1) << LOG_WALK_LEN;
+        size_t MAX_ROUND_NUM = KANGAROO_QUERY_CAP * (WALK_LEN + (RANGE_SIZE >> LOG_TABLE_SIZE)/(WALK_LEN*KANGAROO_WALK_NUM));
+
+        WalkBatch batch(KANGAROO_WALK_NUM);
+        auto restart = [&](size_t i){
+            uint64_t y = 1 + prg() % START_RANGE;
+            StartWalk(batch, i, h + g * BigInt(y), y);
+        };
+        for(auto i = 0; i < KANGAROO_WALK_NUM; i++) restart(i);
+
+        for(auto round = 0; round < MAX_ROUND_NUM && FIND == false; round++){
+            for(auto i = 0; i < KANGAROO_WALK_NUM; i++){
+                if(batch.vec_restart[i] == 1 || batch.vec_step_num[i] > MAX_STEP_NUM){
+                    restart(i);
+                    continue;
+                }
+                if(IsDistinguished(batch.vec_key[i]) == false) continue;
+                uint32_t index;
+                uint64_t offset = batch.vec_start[i] + batch.vec_distance[i];
+                if(dp_table.Find(batch.vec_key[i], index) && vec_dp_exponent[index] >= offset){
+                    uint64_t candidate = vec_dp_exponent[index] - offset;
+                    if(candidate < RANGE_SIZE && g * BigInt(candidate) == h){
+                        result = candidate;
+                        return true;
+                    }
+                }
+                restart(i);
+            }
+            Step(batch);
+        }
+        return false;
+    }
+
+    // compute x = log_g h, NUMBER_OF_THREADS batches of walks search in parallel
+    bool Solve(const ECPoint &h, BigInt &x) const
+    {
+        if(dp_table.Empty() == true){
+            std::cerr << "the kangaroo table is empty" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        std::vector<uint64_t> vec_seed(NUMBER_OF_THREADS);
+        for(auto t = 0; t < NUMBER_OF_THREADS; t++) vec_seed[t] = (uint64_t(global_built_in_prg()) << 32) | global_built_in_prg();
+
+        // a beacon value: used to notify other tasks break if one task has already succeed
+        bool FIND = false;
+        #pragma omp parallel for shared(FIND) num_threads(NUMBER_OF_THREADS)
+        for(auto t = 0; t < NUMBER_OF_THREADS; t++){
+            uint64_t result;
+            if(Search(h, vec_seed[t], FIND, result) == true){
+                #pragma omp critical
+                {
+                    x = BigInt(result);
+                    FIND = true;
+                }
+            }
+        }
+        return FIND;
+    }
+
+    // compute vec_x[i] = log_g vec_h[i], vec_found[i] = 0 if it is not found; the targets are searched in parallel
+    std::vector<uint8_t> Solve(const std::vector<ECPoint> &vec_h, std::vector<BigInt> &vec_x) const
+    {
+        if(dp_table.Empty() == true){
+            std::cerr << "the kangaroo table is empty" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        vec_x.resize(vec_h.size());
+        std::vector<uint8_t> vec_found(vec_h.size(), 0);
+        std::vector<uint64_t> vec_seed(vec_h.size());
+        for(auto i = 0; i < vec_h.size(); i++) vec_seed[i] = (uint64_t(global_built_in_prg()) << 32) | global_built_in_prg();
+
+        #pragma omp parallel for num_threads(NUMBER_OF_THREADS) schedule(dynamic)
+        for(auto i = 0; i < vec_h.size(); i++){
+            const bool STOP = false;
+            uint64_t result;
+            if(Search(vec_h[i], vec_seed[i], STOP, result) == true){
+                vec_x[i] = BigInt(result);
+                vec_found[i] = 1;
+            }
+        }
+        return vec_found;
+    }
+
+    /*
+    ** the table file: | header | table parameters | aux | padding | dp_table |, see FlatHashTable::WriteMappedObject
+    ** aux: | RANGE_LEN | LOG_TABLE_SIZE | LOG_WALK_LEN | g | jump exponents | exponents of the distinguished points |
+    */
+    bool WriteObject(std::string file_name) const
+    {
+        size_t offset = 0;
+        std::vector<uint8_t> aux(3*sizeof(uint64_t) + POINT_COMPRESSED_BYTE_LEN
+                                 + (KANGAROO_JUMP_NUM + vec_dp_exponent.size())*sizeof(uint64_t));
+        uint64_t field[3] = {RANGE_LEN, LOG_TABLE_SIZE, LOG_WALK_LEN};
+        memcpy(aux.data(), field, 3*sizeof(uint64_t));
+        offset += 3*sizeof(uint64_t);
+        std::string g_str = g.ToByteString();
+        memcpy(aux.data() + offset, g_str.data(), POINT_COMPRESSED_BYTE_LEN);
+        offset += POINT_COMPRESSED_BYTE_LEN;
+        memcpy(aux.data() + offset, vec_jump_exponent.data(), KANGAROO_JUMP_NUM*sizeof(uint64_t));
+        offset += KANGAROO_JUMP_NUM*sizeof(uint64_t);
+        memcpy(aux.data() + offset, vec_dp_exponent.data(), vec_dp_exponent.size()*sizeof(uint64_t));
+        return dp_table.WriteMappedObject(file_name, KANGAROO_TABLE_MAGIC, aux);
+    }
+
+    // map a table written by WriteObject, which must match the generator and parameters of this object
+    bool ReadObject(std::string file_name)
+    {
+        std::vector<uint8_t> aux;
+        if(dp_table.MapObject(file_name, KANGAROO_TABLE_MAGIC, aux) == false) return false;
+
+        size_t HEAD_LEN = 3*sizeof(uint64_t) + POINT_COMPRESSED_BYTE_LEN + KANGAROO_JUMP_NUM*sizeof(uint64_t);
+        uint64_t field[3] = {0, 0, 0};
+        if(aux.size() >= HEAD_LEN) memcpy(field, aux.data(), 3*sizeof(uint64_t));
+        if(field[0] != RANGE_LEN || field[1] != LOG_TABLE_SIZE || field[2] != LOG_WALK_LEN
+           || aux.size() != HEAD_LEN + dp_table.Size()*sizeof(uint64_t)
+           || memcmp(aux.data() + 3*sizeof(uint64_t), g.ToByteString().data(), POINT_COMPRESSED_BYTE_LEN) != 0){
+            std::cerr << file_name << " does not match the kangaroo parameters" << std::endl;
+            dp_table = FlatHashTable();
+            return false;
+        }
+        size_t offset = 3*sizeof(uint64_t) + POINT_COMPRESSED_BYTE_LEN;
+        vec_jump_exponent.resize(KANGAROO_JUMP_NUM);
+        memcpy(vec_jump_exponent.data(), aux.data() + offset, KANGAROO_JUMP_NUM*sizeof(uint64_t));
+        offset += KANGAROO_JUMP_NUM*sizeof(uint64_t);
+        vec_dp_exponent.resize(dp_table.Size());
+        memcpy(vec_dp_exponent.data(), aux.data() + offset, dp_table.Size()*sizeof(uint64_t));
+        InitializeJumps();
+        return true;
+    }
+
+    void PrintInfo() const
+    {
+        PrintSplitLine('-');
+        std::cout << "KangarooDLOG Status:" << std::endl;
+        std::cout << "RANGE_LEN = " << RANGE_LEN << std::endl;
+        std::cout << "table size = 2^" << LOG_TABLE_SIZE << " (" << dp_table.Size() << " distinguished points, "
+                  << ((dp_table.MemorySize() + vec_dp_exponent.size()*sizeof(uint64_t)) >> 10) << " KB)" << std::endl;
+        std::cout << "walk length = 2^" << LOG_WALK_LEN << ", walks per batch = " << KANGAROO_WALK_NUM << std::endl;
+        PrintSplitLine('-');
+    }
+};
+
+#endif
@@ -156,23 +156,27 @@ PP Setup(size_t MSG_LEN, size_t TRADEOFF_NUM)
 }
 
 
-/* initialize the hashmap to accelerate decryption */
-void Initialize(PP &pp)
+/* 
+** initialize a DLOG solver to accelerate decryption: the table w.r.t. h is built once and then mapped from file
+** the solver is passed to Dec, so that instances with different parameters keep their own tables
+*/
+DLogSolver Initialize(const PP &pp)
 {
     std::cout << "initialize twisted exponential ElGamal PKE >>>" << std::endl; 
 
-    CheckDlogParameters(pp.MSG_LEN, pp.TRADEOFF_NUM); 
- 
-    std::string table_filename = GetTableFileName(pp.h, pp.MSG_LEN, pp.TRADEOFF_NUM);      
-    /* generate and save table */
-    if(FileExist(table_filename) == false){
-        std::cout << table_filename << " does not exist" << std::endl;
-        BuildSaveTable(pp.h, pp.MSG_LEN, pp.TRADEOFF_NUM, table_filename);
+    DLogSolver dlog_solver(pp.h, pp.MSG_LEN, pp.TRADEOFF_NUM); 
+    dlog_solver.Initialize(); 
+    return dlog_solver; 
+}
+
+// a solver built for other public parameters would search the wrong table
+void CheckDLogSolver(const PP &pp, const DLogSolver &dlog_solver)
+{
+    if(dlog_solver.Match(pp.h, pp.MSG_LEN) == false)
+    {
+        std::cerr << "the DLOG solver does not match the public parameters" << std::endl; 
+        exit(EXIT_FAILURE); 
     }
-    
-    // load the table from file 
-    std::cout << table_filename << " already exists" << std::endl;
-    LoadTable(table_filename, pp.MSG_LEN, pp.TRADEOFF_NUM); 
 }
 
 /* KeyGen algorithm */ 
@@ -235,13 +239,14 @@ CT Enc(const PP &pp, const ECPoint &pk, const BigInt &m, const BigInt &r)
 
 
 /* Decryption algorithm: compute m = Dec(sk, CT) */ 
-BigInt Dec(const PP &pp, const BigInt& sk, const CT &ct)
+BigInt Dec(const PP &pp, const DLogSolver &dlog_solver, const BigInt& sk, const CT &ct)
 { 
+    CheckDLogSolver(pp, dlog_solver); 
     BigInt m;
     //begin decryption  
     ECPoint M = ct.Y - ct.X * sk.ModInverse(order); // M = Y - X^{sk^{-1}} = h^m 
 
-    bool SUCCESS = ShanksDLOG(pp.h, M, pp.MSG_LEN, pp.TRADEOFF_NUM, m); 
+    bool SUCCESS = dlog_solver.Solve(M, m); 
     if(SUCCESS == false)
     {
         std::cout << "decyption fails in the specified range" << std::endl; 
@@ -250,6 +255,30 @@ BigInt Dec(const PP &pp, const BigInt& sk, const CT &ct)
     return m; 
 }
 
+/* 
+** batch decryption: the DLOGs of all ciphertexts are solved together by the batch DLogSolver::Solve, 
+** which shares one field inversion per giant step among many ciphertexts
+*/ 
+std::vector<BigInt> Dec(const PP &pp, const DLogSolver &dlog_solver, const BigInt& sk, const std::vector<CT> &vec_ct)
+{ 
+    CheckDLogSolver(pp, dlog_solver); 
+    BigInt sk_inverse = sk.ModInverse(order); 
+    std::vector<ECPoint> vec_M(vec_ct.size()); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < vec_ct.size(); i++){
+        vec_M[i] = vec_ct[i].Y - vec_ct[i].X * sk_inverse; // M = Y - X^{sk^{-1}} = h^m 
+    }
+
+    std::vector<BigInt> vec_m; 
+    std::vector<uint8_t> vec_found = dlog_solver.Solve(vec_M, vec_m); 
+    if(std::find(vec_found.begin(), vec_found.end(), 0) != vec_found.end())
+    {
+        std::cout << "decyption fails in the specified range" << std::endl; 
+        exit(EXIT_FAILURE); 
+    }  
+    return vec_m; 
+}
+
 
 // add an method to encrypt message in G
 CT Enc(const PP &pp, const ECPoint &pk, const ECPoint &m, const BigInt &r)
@@ -73,6 +73,9 @@ void Emulate_ADCP_System()
     ADCP::FetchPP(pp, "adcp.pp"); 
     ADCP::PrintPP(pp); 
 
+    // the table built in Build_ADCP_Test_Enviroment is mapped from file
+    DLogSolver dlog_solver = ADCP::Initialize(pp); 
+
     ADCP::Account Acct_Alice;  
     ADCP::FetchAccount(Acct_Alice, "Alice.account"); 
     ADCP::PrintAccount(Acct_Alice); 
@@ -101,7 +104,7 @@ void Emulate_ADCP_System()
 
     ECPoint noisy = GenRandomGenerator(); 
     wrong_ctx1.transfer_ct.vec_X[0] = wrong_ctx1.transfer_ct.vec_X[0] + noisy;
-    ADCP::Miner(pp, wrong_ctx1, Acct_Alice, Acct_Bob); 
+    ADCP::Miner(pp, dlog_solver, wrong_ctx1, Acct_Alice, Acct_Bob); 
     PrintSplitLine('-'); 
 
     std::cout << "press any key to continue >>>" << std::endl; 
@@ -111,7 +114,7 @@ void Emulate_ADCP_System()
     v = BigInt(4294967296); 
     std::cout << "Alice is going to transfer "<< BN_bn2dec(v.bn_ptr) << " coins to Bob" << std::endl; 
     ADCP::ToOneCTx wrong_ctx2 = ADCP::CreateCTx(pp, Acct_Alice, v, Acct_Bob.pk);
-    ADCP::Miner(pp, wrong_ctx2, Acct_Alice, Acct_Bob); 
+    ADCP::Miner(pp, dlog_solver, wrong_ctx2, Acct_Alice, Acct_Bob); 
     PrintSplitLine('-'); 
 
     std::cout << "press any key to continue >>>" << std::endl; 
@@ -121,7 +124,7 @@ void Emulate_ADCP_System()
     v = BigInt(513);  
     std::cout << "Alice is going to transfer "<< BN_bn2dec(v.bn_ptr) << " coins to Bob" << std::endl; 
     ADCP::ToOneCTx wrong_ctx3 = ADCP::CreateCTx(pp, Acct_Alice, v, Acct_Bob.pk);
-    ADCP::Miner(pp, wrong_ctx3, Acct_Alice, Acct_Bob);  
+    ADCP::Miner(pp, dlog_solver, wrong_ctx3, Acct_Alice, Acct_Bob);  
     PrintSplitLine('-'); 
 
     std::cout << "press any key to continue >>>" << std::endl; 
@@ -131,7 +134,7 @@ void Emulate_ADCP_System()
     v = BigInt(128); 
     std::cout << "Alice is going to transfer "<< BN_bn2dec(v.bn_ptr) << " coins to Bob" << std::endl; 
     ADCP::ToOneCTx ctx1 = ADCP::CreateCTx(pp, Acct_Alice, v, Acct_Bob.pk);
-    ADCP::Miner(pp, ctx1, Acct_Alice, Acct_Bob); 
+    ADCP::Miner(pp, dlog_solver, ctx1, Acct_Alice, Acct_Bob); 
     PrintSplitLine('-'); 
 
     std::cout << "after 1st valid 1-to-1 ctx >>>>>>" << std::endl; 
@@ -148,7 +151,7 @@ void Emulate_ADCP_System()
     v = BigInt(32);  
     std::cout << "Bob is going to transfer "<< BN_bn2dec(v.bn_ptr) << " coins to Tax" << std::endl; 
     ADCP::ToOneCTx ctx2 = ADCP::CreateCTx(pp, Acct_Bob, v, Acct_Tax.pk);
-    ADCP::Miner(pp, ctx2, Acct_Bob, Acct_Tax); 
+    ADCP::Miner(pp, dlog_solver, ctx2, Acct_Bob, Acct_Tax); 
     PrintSplitLine('-'); 
 
     std::cout << "after 2nd valid 1-to-1 ctx >>>>>>" << std::endl; 
@@ -165,7 +168,7 @@ void Emulate_ADCP_System()
     v = BigInt(384);  
     std::cout << "Alice is going to transfer "<< BN_bn2dec(v.bn_ptr) << " coins to Bob" << std::endl; 
     ADCP::ToOneCTx ctx3 = ADCP::CreateCTx(pp, Acct_Alice, v, Acct_Bob.pk);
-    ADCP::Miner(pp, ctx3, Acct_Alice, Acct_Bob); 
+    ADCP::Miner(pp, dlog_solver, ctx3, Acct_Alice, Acct_Bob); 
     PrintSplitLine('-'); 
 
     std::cout << "after 3nd valid 1-to-1 ctx >>>>>>" << std::endl; 
@@ -182,7 +185,7 @@ void Emulate_ADCP_System()
     v = BigInt(128);  
     std::cout << "Carl is going to transfer "<< BN_bn2dec(v.bn_ptr) << " coins to Tax" << std::endl; 
     ADCP::ToOneCTx ctx4 = ADCP::CreateCTx(pp, Acct_Carl, v, Acct_Tax.pk);
-    ADCP::Miner(pp, ctx4, Acct_Carl, Acct_Tax); 
+    ADCP::Miner(pp, dlog_solver, ctx4, Acct_Carl, Acct_Tax); 
     PrintSplitLine('-'); 
 
     std::cout << "after 4th valid 1-to-1 ctx >>>>>>" << std::endl; 
@@ -195,11 +198,11 @@ void Emulate_ADCP_System()
 
     std::cout << "supervision of 1-to-1 ctx begins >>>" << std::endl; 
     PrintSplitLine('-'); 
-    ADCP::SuperviseCTx(sp, pp, ctx1); 
+    ADCP::SuperviseCTx(sp, pp, dlog_solver, ctx1); 
     PrintSplitLine('-'); 
-    ADCP::SuperviseCTx(sp, pp, ctx2);
+    ADCP::SuperviseCTx(sp, pp, dlog_solver, ctx2);
     PrintSplitLine('-'); 
-    ADCP::SuperviseCTx(sp, pp, ctx3);
+    ADCP::SuperviseCTx(sp, pp, dlog_solver, ctx3);
     PrintSplitLine('-');  
     std::cout << "supervision of 1-to-1 ctx ends >>>" << std::endl; 
     PrintSplitLine('-');
@@ -226,7 +229,7 @@ void Emulate_ADCP_System()
     limit_policy.LEFT_BOUND = bn_0; limit_policy.RIGHT_BOUND = BigInt(513);  
     std::vector<ADCP::ToOneCTx> ctx_set = {ctx1, ctx3}; 
     Gadget::Proof_type2 limit_proof; 
-    ADCP::JustifyPolicy(pp, Acct_Alice, ctx_set, limit_policy, limit_proof); 
+    ADCP::JustifyPolicy(pp, dlog_solver, Acct_Alice, ctx_set, limit_policy, limit_proof); 
     ADCP::AuditPolicy(pp, Acct_Alice.pk, ctx_set, limit_policy, limit_proof);
     
     PrintSplitLine('-'); 
@@ -251,7 +254,7 @@ void Emulate_ADCP_System()
     std::vector<ADCP::Account> vec_Acct_receiver = {Acct_Alice, Acct_Bob, Acct_Carl};  
 
     ADCP::ToManyCTx ctx5 = ADCP::CreateCTx(pp, Acct_Tax, vec_v, vec_pkr);
-    ADCP::Miner(pp, ctx5, Acct_Tax, vec_Acct_receiver); 
+    ADCP::Miner(pp, dlog_solver, ctx5, Acct_Tax, vec_Acct_receiver); 
     PrintSplitLine('-'); 
 
     std::cout << "after 1st valid 1-to-n ctx >>>>>>" << std::endl; 
@@ -266,7 +269,7 @@ void Emulate_ADCP_System()
 
     std::cout << "supervision of 1-to-n ctx begins >>>" << std::endl; 
     PrintSplitLine('-'); 
-    ADCP::SuperviseCTx(sp, pp, ctx5); 
+    ADCP::SuperviseCTx(sp, pp, dlog_solver, ctx5); 
     PrintSplitLine('-'); 
     std::cout << "supervision of 1-to-n ctx ends >>>" << std::endl; 
     PrintSplitLine('-');
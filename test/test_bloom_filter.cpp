@@ -1,6 +1,7 @@
 #define DEBUG
 
 #include "../filter/bloom_filter.hpp"
+#include "../crypto/prg.hpp"
 
 
 template <class T, class Allocator, template <class,class> class Container>
@@ -87,8 +88,170 @@ void test_bloom_filter()
 }
 
 
+// compare the per-element interfaces with the batch interfaces on random blocks
+void test_bloom_filter_batch(size_t LOG_ITEM_NUM)
+{
+    PrintSplitLine('-'); 
+    std::cout << "begin the test of bloom filter batch interfaces with " << NUMBER_OF_THREADS << " threads >>>" << std::endl;
+    PrintSplitLine('-'); 
+
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM; 
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0); 
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, ITEM_NUM); 
+    std::vector<block> vec_Q = PRG::GenRandomBlocks(seed, ITEM_NUM); 
+    for(auto i = 0; i < ITEM_NUM; i += 2) vec_Q[i] = vec_X[(i*7)%ITEM_NUM]; // half of the queries hit
+
+    BloomFilter filter(ITEM_NUM, 40); 
+    auto start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 0; i < ITEM_NUM; i++) filter.Insert(vec_X[i]); 
+    auto end_time = std::chrono::steady_clock::now(); 
+    std::cout << "insert 2^" << LOG_ITEM_NUM << " elements one by one takes " 
+              << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl; 
+
+    BloomFilter batch_filter(ITEM_NUM, 40); 
+    start_time = std::chrono::steady_clock::now(); 
+    batch_filter.InsertBatch(vec_X.data(), ITEM_NUM); 
+    end_time = std::chrono::steady_clock::now(); 
+    std::cout << "insert 2^" << LOG_ITEM_NUM << " elements in batch takes " 
+              << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl; 
+
+    std::vector<uint8_t> vec_indication_bit(ITEM_NUM); 
+    start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 0; i < ITEM_NUM; i++) vec_indication_bit[i] = filter.Contain(vec_Q[i]); 
+    end_time = std::chrono::steady_clock::now(); 
+    std::cout << "query 2^" << LOG_ITEM_NUM << " elements one by one takes " 
+              << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl; 
+
+    start_time = std::chrono::steady_clock::now(); 
+    std::vector<uint8_t> vec_batch_indication_bit = batch_filter.ContainBatch(vec_Q.data(), ITEM_NUM); 
+    end_time = std::chrono::steady_clock::now(); 
+    std::cout << "query 2^" << LOG_ITEM_NUM << " elements in batch takes " 
+              << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl; 
+
+    if(filter.bit_table == batch_filter.bit_table && vec_indication_bit == vec_batch_indication_bit){
+        std::cout << "batch interfaces agree with per-element interfaces, hits = " 
+                  << std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0)) << std::endl; 
+    }
+    else{
+        std::cout << "batch interfaces disagree with per-element interfaces" << std::endl; 
+    }
+
+    // the mapped filter queries the table in place and must answer exactly as the in-memory one
+    batch_filter.WriteMappedObject("bloom_filter.map"); 
+    BloomFilter mapped_filter; 
+    start_time = std::chrono::steady_clock::now(); 
+    mapped_filter.MapObject("bloom_filter.map"); 
+    end_time = std::chrono::steady_clock::now(); 
+    std::cout << "map the filter takes " << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl; 
+    if(mapped_filter.ContainBatch(vec_Q.data(), ITEM_NUM) == vec_batch_indication_bit && mapped_filter.Contain(vec_X[0]) == true){
+        std::cout << "mapped filter agrees with in-memory filter" << std::endl; 
+    }
+    else{
+        std::cout << "mapped filter disagrees with in-memory filter" << std::endl;
+    }
+
+    // lengths whose sums wrap around 2^64 must be rejected, even under a valid header checksum
+    std::ifstream fin("bloom_filter.map", std::ios::binary);
+    std::vector<uint8_t> map_buffer((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+    fin.close();
+    bool reject_all = true;
+    for(auto k = 0; k < 2; k++){
+        std::vector<uint8_t> bad_buffer(map_buffer);
+        MappedFileHeader* header = reinterpret_cast<MappedFileHeader*>(bad_buffer.data());
+        if(k == 0) header->parameter_len = ~uint64_t(0) - sizeof(MappedFileHeader) + 1;
+        if(k == 1){
+            header->header_len = uint32_t((bad_buffer.size()/MAPPED_FILE_PAGE_SIZE + 1)*MAPPED_FILE_PAGE_SIZE); // past the end of file
+            header->table_len = uint64_t(bad_buffer.size()) - header->header_len;
+        }
+        header->header_checksum = MappedFile::HeaderChecksum(bad_buffer.data(), std::min<size_t>(header->header_len, bad_buffer.size()));
+        std::ofstream fout("bloom_filter.map", std::ios::binary);
+        fout.write(reinterpret_cast<char*>(bad_buffer.data()), bad_buffer.size());
+        fout.close();
+        BloomFilter bad_filter;
+        reject_all &= (bad_filter.MapObject("bloom_filter.map") == false);
+    }
+    std::cout << (reject_all ? "mapped files with wrapping lengths are rejected" : "a mapped file with wrapping lengths is accepted") << std::endl;
+
+    PrintSplitLine('-'); 
+    std::cout << "finish the test of bloom filter batch interfaces >>>" << std::endl;
+    PrintSplitLine('-'); 
+}
+
+
+// compressed size and coding time against the raw table, for decreasing numbers of hash functions at lambda = 40
+void test_bloom_filter_compression(size_t LOG_ITEM_NUM)
+{
+    PrintSplitLine('-'); 
+    std::cout << "begin the test of bloom filter compression >>>" << std::endl;
+    PrintSplitLine('-'); 
+
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM; 
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0); 
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, ITEM_NUM); 
+
+    for(size_t hash_num : {40, 20, 13, 8, 6}){
+        BloomFilter filter(ITEM_NUM, 40, hash_num); 
+        filter.InsertBatch(vec_X.data(), ITEM_NUM); 
+
+        std::vector<uint8_t> buffer; 
+        auto start_time = std::chrono::steady_clock::now(); 
+        filter.WriteCompressedObject(buffer); 
+        auto end_time = std::chrono::steady_clock::now(); 
+        double encode_time = std::chrono::duration <double, std::milli> (end_time - start_time).count(); 
+
+        BloomFilter recovered_filter; 
+        start_time = std::chrono::steady_clock::now(); 
+        bool status = recovered_filter.ReadCompressedObject(buffer.data(), buffer.size()); 
+        end_time = std::chrono::steady_clock::now(); 
+        double decode_time = std::chrono::duration <double, std::milli> (end_time - start_time).count(); 
+        status &= (recovered_filter.bit_table == filter.bit_table) && (recovered_filter.Contain(vec_X[0]) == true); 
+
+        std::cout << "hash num = " << hash_num << ": table = " << double(filter.table_size)/ITEM_NUM 
+                  << " bits per element, compressed = " << 8.0*buffer.size()/ITEM_NUM << " bits per element, " 
+                  << "encode takes " << encode_time << " ms, decode takes " << decode_time << " ms, " 
+                  << "round trip " << (status ? "succeeds" : "fails") << std::endl; 
+    }
+
+    // a malformed header must be rejected before it touches the filter: the seed is changed as well to catch partial writes
+    BloomFilter filter(ITEM_NUM, 40, 8); 
+    filter.InsertBatch(vec_X.data(), ITEM_NUM); 
+    std::vector<uint8_t> buffer; 
+    filter.WriteCompressedObject(buffer); 
+    bool reject_all = true; 
+    for(uint32_t field_offset : {4, 32}){ // hash_num, chunk_num
+        for(uint32_t bad_value : {uint32_t(0), uint32_t(BLOOM_MAX_HASH_NUM + 1), ~uint32_t(0)}){
+            std::vector<uint8_t> bad_buffer(buffer); 
+            bad_buffer[0] ^= 0xFF; 
+            memcpy(bad_buffer.data() + field_offset, &bad_value, sizeof(uint32_t)); 
+            BloomFilter recovered_filter(filter); 
+            reject_all &= (recovered_filter.ReadCompressedObject(bad_buffer.data(), bad_buffer.size()) == false); 
+            reject_all &= (recovered_filter.random_seed == filter.random_seed && recovered_filter.hash_num == filter.hash_num 
+                           && recovered_filter.inserted_element_num == filter.inserted_element_num 
+                           && recovered_filter.bit_table == filter.bit_table); 
+        }
+    }
+    std::cout << (reject_all ? "malformed compressed headers are rejected and leave the filter untouched" 
+                             : "a malformed compressed header is accepted or modifies the filter") << std::endl; 
+
+    PrintSplitLine('-'); 
+    std::cout << "finish the test of bloom filter compression >>>" << std::endl;
+    PrintSplitLine('-'); 
+}
+
+
 int main()
 { 
+    test_bloom_filter_batch(20);
+    size_t DEFAULT_THREAD_NUM = NUMBER_OF_THREADS; 
+    NUMBER_OF_THREADS = 4; 
+    test_bloom_filter_batch(20); // the batch interfaces partition the table by byte ranges above 1 thread
+    NUMBER_OF_THREADS = DEFAULT_THREAD_NUM; 
+
+    test_bloom_filter_compression(20); 
+    NUMBER_OF_THREADS = 4; 
+    test_bloom_filter_compression(20); 
+    NUMBER_OF_THREADS = DEFAULT_THREAD_NUM; 
+
     test_bloom_filter();
     
     return 0;
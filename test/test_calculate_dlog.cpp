@@ -1,5 +1,82 @@
 #include "../pke/calculate_dlog.hpp"
 #include "../crypto/setup.hpp"
+#include "../crypto/prg.hpp"
+
+/*
+** compare the flat baby-step table with std::unordered_map<size_t, size_t> on 2^LOG_KEY_NUM random 8-byte keys
+** giant-step lookups almost always miss, so hits and misses are timed separately
+*/
+void benchmark_babystep_table(size_t LOG_KEY_NUM)
+{
+    PrintSplitLine('-'); 
+    std::cout << "babystep table benchmark begins >>>" << std::endl;
+    PrintSplitLine('-'); 
+
+    size_t KEY_NUM = size_t(1) << LOG_KEY_NUM; 
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0); 
+    std::vector<uint8_t> key_buffer = PRG::GenRandomBytes(seed, KEY_NUM*HASH_KEY_LEN); 
+    std::vector<uint8_t> miss_buffer = PRG::GenRandomBytes(seed, KEY_NUM*HASH_KEY_LEN); 
+    std::vector<size_t> vec_key(KEY_NUM), vec_miss(KEY_NUM); 
+    memcpy(vec_key.data(), key_buffer.data(), KEY_NUM*HASH_KEY_LEN); 
+    memcpy(vec_miss.data(), miss_buffer.data(), KEY_NUM*HASH_KEY_LEN); 
+
+    auto start_time = std::chrono::steady_clock::now(); 
+    std::unordered_map<size_t, size_t> map; 
+    map.reserve(KEY_NUM); 
+    for(auto i = 0; i < KEY_NUM; i++) map[vec_key[i]] = i; 
+    auto end_time = std::chrono::steady_clock::now(); 
+    double map_build_time = std::chrono::duration <double, std::milli> (end_time - start_time).count(); 
+
+    start_time = std::chrono::steady_clock::now(); 
+    FlatHashTable table(KEY_NUM); 
+    table.InsertBatch(key_buffer.data(), KEY_NUM); 
+    end_time = std::chrono::steady_clock::now(); 
+    double table_build_time = std::chrono::duration <double, std::milli> (end_time - start_time).count(); 
+
+    size_t ERROR_NUM = 0; 
+    start_time = std::chrono::steady_clock::now(); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(+:ERROR_NUM)
+    for(auto i = 0; i < KEY_NUM; i++) ERROR_NUM += (map.find(vec_key[i])->second != i); 
+    end_time = std::chrono::steady_clock::now(); 
+    double map_hit_time = std::chrono::duration <double> (end_time - start_time).count(); 
+
+    start_time = std::chrono::steady_clock::now(); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(+:ERROR_NUM)
+    for(auto i = 0; i < KEY_NUM; i++) ERROR_NUM += (map.find(vec_miss[i]) != map.end()); 
+    end_time = std::chrono::steady_clock::now(); 
+    double map_miss_time = std::chrono::duration <double> (end_time - start_time).count(); 
+
+    start_time = std::chrono::steady_clock::now(); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(+:ERROR_NUM)
+    for(auto i = 0; i < KEY_NUM; i++){
+        uint32_t index; 
+        ERROR_NUM += (table.Find(vec_key[i], index) == false || index != i); 
+    }
+    end_time = std::chrono::steady_clock::now(); 
+    double table_hit_time = std::chrono::duration <double> (end_time - start_time).count(); 
+
+    start_time = std::chrono::steady_clock::now(); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(+:ERROR_NUM)
+    for(auto i = 0; i < KEY_NUM; i++){
+        uint32_t index; 
+        ERROR_NUM += table.Find(vec_miss[i], index); 
+    }
+    end_time = std::chrono::steady_clock::now(); 
+    double table_miss_time = std::chrono::duration <double> (end_time - start_time).count(); 
+
+    // a node of std::unordered_map holds the next pointer, key and value, and the allocator rounds it up to 32 bytes
+    size_t MAP_MEMORY = map.bucket_count()*sizeof(void*) + map.size()*32; 
+    std::cout << "2^" << LOG_KEY_NUM << " keys" << std::endl; 
+    std::cout << "std::unordered_map: about " << MAP_MEMORY/(1024*1024) << " MB, build takes " << map_build_time << " ms, " 
+              << KEY_NUM/map_hit_time/1000000 << " M hits/s, " << KEY_NUM/map_miss_time/1000000 << " M misses/s" << std::endl; 
+    std::cout << "FlatHashTable: " << table.MemorySize()/(1024*1024) << " MB, build takes " << table_build_time << " ms, " 
+              << KEY_NUM/table_hit_time/1000000 << " M hits/s, " << KEY_NUM/table_miss_time/1000000 << " M misses/s" << std::endl; 
+    std::cout << "wrong lookups = " << ERROR_NUM << std::endl; 
+
+    PrintSplitLine('-'); 
+    std::cout << "babystep table benchmark finishes <<<" << std::endl; 
+    PrintSplitLine('-'); 
+}
 
 void benchmark_dlog(size_t RANGE_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
 {
@@ -11,20 +88,9 @@ void benchmark_dlog(size_t RANGE_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
     std::cout << "TEST_NUM = " << TEST_NUM << std::endl;
     PrintSplitLine('-'); 
 
-    CheckDlogParameters(RANGE_LEN, TRADEOFF_NUM); 
-
     ECPoint g = ECPoint(generator); 
-    std::string table_filename = GetTableFileName(g, RANGE_LEN, TRADEOFF_NUM);   
-
-    /* generate and save table */
-    if(FileExist(table_filename) == false){
-        std::cout << table_filename << " does not exist" << std::endl;
-        BuildSaveTable(g, RANGE_LEN, TRADEOFF_NUM, table_filename);
-    }
-    
-    // load the table from file 
-    std::cout << table_filename << " already exists" << std::endl;
-    LoadTable(table_filename, RANGE_LEN, TRADEOFF_NUM); 
+    DLogSolver dlog_solver(g, RANGE_LEN, TRADEOFF_NUM); 
+    dlog_solver.Initialize(); 
     
     BigInt x[TEST_NUM];                        // scalars  
     BigInt x_real[TEST_NUM];                  // dlog scalars
@@ -40,7 +106,7 @@ void benchmark_dlog(size_t RANGE_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
     auto start_time = std::chrono::steady_clock::now(); 
     for(auto i = 0; i < TEST_NUM; i++)
     {
-        ShanksDLOG(g, Y[i], RANGE_LEN, TRADEOFF_NUM, x_real[i]); 
+        dlog_solver.Solve(Y[i], x_real[i]); 
     }
     auto end_time = std::chrono::steady_clock::now(); 
     auto running_time = end_time - start_time;
@@ -51,14 +117,99 @@ void benchmark_dlog(size_t RANGE_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
     {        
         if(x[i] != x_real[i]){ 
             std::cout << "dlog fails at test case " << i << std::endl;
-        } 
+        }
+    }
+
+    /* test batch dlog efficiency */
+    std::vector<ECPoint> vec_Y(Y, Y + TEST_NUM);
+    std::vector<BigInt> vec_x_real;
+    start_time = std::chrono::steady_clock::now();
+    std::vector<uint8_t> vec_found = dlog_solver.Solve(vec_Y, vec_x_real);
+    end_time = std::chrono::steady_clock::now();
+    running_time = end_time - start_time;
+    std::cout << "average batch dlog takes time = "
+    << std::chrono::duration <double, std::milli> (running_time).count()/TEST_NUM << " ms" << std::endl;
+
+    for(auto i = 0; i < TEST_NUM; i++)
+    {
+        if(vec_found[i] == 0 || x[i] != vec_x_real[i]){
+            std::cout << "batch dlog fails at test case " << i << std::endl;
+        }
     }
 
+    /* 
+    ** boundary cases for both single and batch solve: 0, multiples of the baby step number and 2^RANGE_LEN - 1 are found, 
+    ** while 2^RANGE_LEN is out of range
+    */
+    std::vector<BigInt> vec_x_edge = {bn_0, BigInt(dlog_solver.BabyStepNum()), 
+                                      BigInt(dlog_solver.BabyStepNum()) * BigInt(dlog_solver.GiantStepNum() - 1), MAX - bn_1}; 
+    std::vector<ECPoint> vec_Y_edge(vec_x_edge.size()); 
+    for(auto i = 0; i < vec_x_edge.size(); i++) vec_Y_edge[i] = g * vec_x_edge[i]; 
+    vec_Y_edge.emplace_back(g * MAX); 
+
+    size_t EDGE_ERROR_NUM = 0; 
+    BigInt x_edge; 
+    for(auto i = 0; i < vec_x_edge.size(); i++){
+        if(dlog_solver.Solve(vec_Y_edge[i], x_edge) == false || x_edge != vec_x_edge[i]) EDGE_ERROR_NUM++; 
+    }
+    if(dlog_solver.Solve(vec_Y_edge.back(), x_edge) == true) EDGE_ERROR_NUM++; 
+
+    std::vector<BigInt> vec_x_edge_real; 
+    std::vector<uint8_t> vec_edge_found = dlog_solver.Solve(vec_Y_edge, vec_x_edge_real); 
+    for(auto i = 0; i < vec_x_edge.size(); i++){
+        if(vec_edge_found[i] == 0 || vec_x_edge_real[i] != vec_x_edge[i]) EDGE_ERROR_NUM++; 
+    }
+    if(vec_edge_found.back() != 0) EDGE_ERROR_NUM++; 
+    std::cout << "wrong boundary cases = " << EDGE_ERROR_NUM << std::endl; 
+
     PrintSplitLine('-'); 
     std::cout << "dlog benchmark test finishes <<<" << std::endl; 
     PrintSplitLine('-'); 
 }
 
+/* 
+** two solvers w.r.t. different generators coexist, and are queried concurrently from one parallel loop
+** the second generator is fixed as g^2, so its table is built once and reused by later runs
+*/
+void test_concurrent_dlog(size_t RANGE_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
+{
+    PrintSplitLine('-'); 
+    std::cout << "concurrent dlog test begins >>>"<< std::endl;
+    PrintSplitLine('-'); 
+
+    std::vector<ECPoint> vec_g = {ECPoint(generator), ECPoint(generator) * bn_2}; 
+    std::vector<DLogSolver> vec_solver(vec_g.size()); 
+    for(auto j = 0; j < vec_g.size(); j++){
+        vec_solver[j] = DLogSolver(vec_g[j], RANGE_LEN, TRADEOFF_NUM); 
+        vec_solver[j].Initialize(); 
+    }
+
+    std::vector<BigInt> x(TEST_NUM), x_real(TEST_NUM); 
+    std::vector<ECPoint> Y(TEST_NUM); 
+    BigInt MAX = BigInt(bn_2).Exp(RANGE_LEN);
+    for(auto i = 0; i < TEST_NUM; i++)
+    {
+        x[i] = GenRandomBigIntLessThan(MAX); 
+        Y[i] = vec_g[i % vec_g.size()] * x[i];  
+    }
+
+    size_t ERROR_NUM = 0; 
+    auto start_time = std::chrono::steady_clock::now(); 
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(+:ERROR_NUM)
+    for(auto i = 0; i < TEST_NUM; i++)
+    {
+        if(vec_solver[i % vec_g.size()].Solve(Y[i], x_real[i]) == false || x[i] != x_real[i]) ERROR_NUM++; 
+    }
+    auto end_time = std::chrono::steady_clock::now(); 
+    std::cout << "average concurrent dlog takes time = " 
+    << std::chrono::duration <double, std::milli> (end_time - start_time).count()/TEST_NUM << " ms" << std::endl;
+    std::cout << "wrong dlogs = " << ERROR_NUM << std::endl; 
+
+    PrintSplitLine('-'); 
+    std::cout << "concurrent dlog test finishes <<<" << std::endl; 
+    PrintSplitLine('-'); 
+}
+
 
 
 int main()
@@ -71,8 +222,13 @@ int main()
     size_t TRADEOFF_NUM = 7; 
     size_t TEST_NUM = 10000;  
 
+    benchmark_babystep_table(RANGE_LEN/2 + TRADEOFF_NUM); 
+
     benchmark_dlog(RANGE_LEN, TRADEOFF_NUM, TEST_NUM);
 
+    // a smaller range keeps the two tables of the concurrency test small
+    test_concurrent_dlog(24, 4, TEST_NUM/10);
+
     CRYPTO_Finalize(); 
 
     return 0; 
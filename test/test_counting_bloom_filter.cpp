@@ -0,0 +1,102 @@
+#define DEBUG
+
+#include "../filter/counting_bloom_filter.hpp"
+#include "../crypto/prg.hpp"
+
+/*
+** a long-lived set of 2^LOG_ITEM_NUM elements, each round removes the CHURN_PERCENT% oldest elements and inserts as many new ones
+** compare rebuilding the filter from scratch with updating the counting filter incrementally
+*/
+void test_counting_bloom_filter(size_t LOG_ITEM_NUM, size_t CHURN_PERCENT, size_t ROUND_NUM)
+{
+    PrintSplitLine('-');
+    std::cout << "begin the test of counting bloom filter with " << NUMBER_OF_THREADS << " threads >>>" << std::endl;
+    PrintSplitLine('-');
+
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM;
+    size_t CHURN_NUM = ITEM_NUM*CHURN_PERCENT/100;
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, ITEM_NUM + CHURN_NUM*ROUND_NUM);
+    std::vector<block> vec_Q = PRG::GenRandomBlocks(seed, ITEM_NUM); // never inserted
+
+    CountingBloomFilter filter(ITEM_NUM, 40);
+    auto start_time = std::chrono::steady_clock::now();
+    filter.Insert(std::vector<block>(vec_X.begin(), vec_X.begin() + ITEM_NUM));
+    auto end_time = std::chrono::steady_clock::now();
+    std::cout << "insert 2^" << LOG_ITEM_NUM << " elements takes "
+              << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl;
+
+    double rebuild_time = 0, plain_rebuild_time = 0, update_time = 0;
+    bool consistent = true;
+    for(auto r = 0; r < ROUND_NUM; r++){
+        // the current set is vec_X[BEGIN, BEGIN + ITEM_NUM)
+        size_t BEGIN = (r+1)*CHURN_NUM;
+        std::vector<block> vec_current(vec_X.begin() + BEGIN, vec_X.begin() + BEGIN + ITEM_NUM);
+
+        start_time = std::chrono::steady_clock::now();
+        size_t REMOVED_NUM = filter.Remove(std::vector<block>(vec_X.begin() + BEGIN - CHURN_NUM, vec_X.begin() + BEGIN));
+        filter.Insert(std::vector<block>(vec_X.begin() + BEGIN + ITEM_NUM - CHURN_NUM, vec_X.begin() + BEGIN + ITEM_NUM));
+        end_time = std::chrono::steady_clock::now();
+        update_time += std::chrono::duration <double, std::milli> (end_time - start_time).count();
+
+        start_time = std::chrono::steady_clock::now();
+        CountingBloomFilter rebuilt_filter(ITEM_NUM, 40);
+        rebuilt_filter.Insert(vec_current);
+        end_time = std::chrono::steady_clock::now();
+        rebuild_time += std::chrono::duration <double, std::milli> (end_time - start_time).count();
+
+        start_time = std::chrono::steady_clock::now();
+        BlockedBloomFilter plain_filter(ITEM_NUM, 40);
+        plain_filter.Insert(vec_current);
+        end_time = std::chrono::steady_clock::now();
+        plain_rebuild_time += std::chrono::duration <double, std::milli> (end_time - start_time).count();
+
+        // without saturated counters, the exported filter is exactly the filter of the current set
+        const BlockedBloomFilter &exported_filter = filter.ExportFilter();
+        consistent &= (REMOVED_NUM == CHURN_NUM) && (exported_filter.inserted_element_num == ITEM_NUM);
+        consistent &= memcmp(exported_filter.block_table.data(), plain_filter.block_table.data(),
+                             plain_filter.block_num*sizeof(BloomBlock)) == 0;
+    }
+    std::cout << "churn = " << CHURN_PERCENT << "% per round, average over " << ROUND_NUM << " rounds:" << std::endl;
+    std::cout << "incremental update takes " << update_time/ROUND_NUM << " ms" << std::endl;
+    std::cout << "rebuild counting filter from scratch takes " << rebuild_time/ROUND_NUM << " ms" << std::endl;
+    std::cout << "rebuild blocked bloom filter from scratch takes " << plain_rebuild_time/ROUND_NUM << " ms" << std::endl;
+    if(consistent) std::cout << "exported filter equals the filter rebuilt from the current set" << std::endl;
+    else std::cout << "exported filter differs from the filter rebuilt from the current set" << std::endl;
+
+    size_t BEGIN = ROUND_NUM*CHURN_NUM;
+    std::vector<uint8_t> vec_indication_bit = filter.Contain(std::vector<block>(vec_X.begin() + BEGIN, vec_X.begin() + BEGIN + ITEM_NUM));
+    size_t MISS_NUM = ITEM_NUM - std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0));
+    vec_indication_bit = filter.Contain(vec_Q);
+    size_t FALSE_POSITIVE_NUM = std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0));
+    std::cout << "false negatives = " << MISS_NUM << ", false positives = " << FALSE_POSITIVE_NUM << " in 2^" << LOG_ITEM_NUM << " queries" << std::endl;
+
+    std::string filter_file_name = "counting_bloom_filter.object";
+    filter.WriteObject(filter_file_name);
+    CountingBloomFilter recovered_filter;
+    recovered_filter.ReadObject(filter_file_name);
+    if(recovered_filter.Remove(vec_X[BEGIN]) == true && filter.Remove(vec_X[BEGIN]) == true
+       && memcmp(recovered_filter.counter_table.data(), filter.counter_table.data(), filter.filter.block_num*sizeof(CounterBlock)) == 0){
+        std::cout << "serialization round trip succeeds" << std::endl;
+    }
+    else{
+        std::cout << "serialization round trip fails" << std::endl;
+    }
+    filter.PrintInfo();
+
+    PrintSplitLine('-');
+    std::cout << "finish the test of counting bloom filter >>>" << std::endl;
+    PrintSplitLine('-');
+}
+
+
+int main()
+{
+    test_counting_bloom_filter(20, 1, 10);
+    size_t DEFAULT_THREAD_NUM = NUMBER_OF_THREADS;
+    NUMBER_OF_THREADS = 4;
+    test_counting_bloom_filter(20, 1, 10);
+    NUMBER_OF_THREADS = DEFAULT_THREAD_NUM;
+
+    return 0;
+}
@@ -3,6 +3,7 @@
 
 #include "../filter/cuckoo_filter.hpp"
 #include "../utility/print.hpp"
+#include "../crypto/prg.hpp"
 
 template <class T, class Allocator, template <class,class> class Container>
 bool ReadFileToContainer(std::string file_name, Container<T, Allocator>& container)
@@ -114,8 +115,77 @@ void test_cuckoo_filter()
 }
 
 
+// compare the per-element interfaces with the batch interfaces on random blocks, for 8/16/32-bit tags
+void test_cuckoo_filter_batch(size_t LOG_ITEM_NUM)
+{
+    PrintSplitLine('-'); 
+    std::cout << "begin the test of cuckoo filter batch interfaces with " << NUMBER_OF_THREADS << " threads >>>" << std::endl;
+    PrintSplitLine('-'); 
+
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM; 
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0); 
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, ITEM_NUM); 
+    std::vector<block> vec_Q = PRG::GenRandomBlocks(seed, ITEM_NUM); 
+    for(auto i = 0; i < ITEM_NUM; i += 2) vec_Q[i] = vec_X[(i*7)%ITEM_NUM]; // half of the queries hit
+
+    for(auto desired_false_positive_probability : {pow(2, -5), pow(2, -12), pow(2, -28)}){
+        CuckooFilter filter(ITEM_NUM, desired_false_positive_probability); 
+        auto start_time = std::chrono::steady_clock::now(); 
+        for(auto i = 0; i < ITEM_NUM; i++) filter.Insert(vec_X[i]); 
+        auto end_time = std::chrono::steady_clock::now(); 
+        std::cout << filter.tag_bit_size << "-bit tag: insert 2^" << LOG_ITEM_NUM << " elements one by one takes " 
+                  << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl; 
+
+        CuckooFilter batch_filter(ITEM_NUM, desired_false_positive_probability); 
+        start_time = std::chrono::steady_clock::now(); 
+        batch_filter.InsertBatch(vec_X.data(), ITEM_NUM); 
+        end_time = std::chrono::steady_clock::now(); 
+        std::cout << filter.tag_bit_size << "-bit tag: insert 2^" << LOG_ITEM_NUM << " elements in batch takes " 
+                  << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl; 
+
+        std::vector<uint8_t> vec_indication_bit(ITEM_NUM); 
+        start_time = std::chrono::steady_clock::now(); 
+        for(auto i = 0; i < ITEM_NUM; i++) vec_indication_bit[i] = filter.Contain(vec_Q[i]); 
+        end_time = std::chrono::steady_clock::now(); 
+        std::cout << filter.tag_bit_size << "-bit tag: query 2^" << LOG_ITEM_NUM << " elements one by one takes " 
+                  << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl; 
+
+        start_time = std::chrono::steady_clock::now(); 
+        std::vector<uint8_t> vec_batch_indication_bit = batch_filter.ContainBatch(vec_Q.data(), ITEM_NUM); 
+        end_time = std::chrono::steady_clock::now(); 
+        std::cout << filter.tag_bit_size << "-bit tag: query 2^" << LOG_ITEM_NUM << " elements in batch takes " 
+                  << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl; 
+
+        // kicks pick random slots, so the two tables may differ, but no inserted element may be missing
+        size_t MISS_NUM = 0; 
+        for(auto i = 0; i < ITEM_NUM; i += 2) MISS_NUM += (vec_batch_indication_bit[i] == 0) + (vec_indication_bit[i] == 0); 
+        std::cout << "hits = " << std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0)) 
+                  << " (one by one), " << std::accumulate(vec_batch_indication_bit.begin(), vec_batch_indication_bit.end(), size_t(0)) 
+                  << " (batch), false negatives = " << MISS_NUM << std::endl; 
+
+        // the mapped filter queries the table in place and must answer exactly as the in-memory one
+        batch_filter.WriteMappedObject("cuckoo_filter.map"); 
+        CuckooFilter mapped_filter; 
+        mapped_filter.MapObject("cuckoo_filter.map", true); 
+        std::cout << "mapped filter " << (mapped_filter.ContainBatch(vec_Q.data(), ITEM_NUM) == vec_batch_indication_bit ? "agrees" : "disagrees") 
+                  << " with in-memory filter" << std::endl; 
+    }
+
+    PrintSplitLine('-'); 
+    std::cout << "finish the test of cuckoo filter batch interfaces >>>" << std::endl;
+    PrintSplitLine('-'); 
+}
+
+
 int main()
 { 
+    test_cuckoo_filter_batch(20);
+    // batch insert switches to the concurrent build with more than one thread
+    size_t DEFAULT_THREAD_NUM = NUMBER_OF_THREADS; 
+    NUMBER_OF_THREADS = 4; 
+    test_cuckoo_filter_batch(20);
+    NUMBER_OF_THREADS = DEFAULT_THREAD_NUM; 
+
     test_cuckoo_filter();
     
     return 0;
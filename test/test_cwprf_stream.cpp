@@ -0,0 +1,185 @@
+#include "../mpc/psi/cwprf_psi.hpp"
+#include "../mpc/rpmt/cwprf_mqrpmt.hpp"
+#include "../crypto/setup.hpp"
+#include <sys/resource.h>
+
+/*
+** wall-clock benchmark of batch vs. streaming mode for cwPRF-based PSI and mqRPMT
+** both parties run in one process and talk over the loopback interface
+** with LINK_MBPS > 0 the client connects through a relay that paces both directions to LINK_MBPS megabits per second,
+** so the overlap of computation and transmission in streaming mode is measured on a throttled link
+** run one (protocol, mode) per process so that the reported peak RSS is meaningful:
+**   ./test_cwprf_stream [psi|mqrpmt] [batch|stream] [LOG_ITEM_NUM] [CHUNK_LEN] [LINK_MBPS]
+*/
+
+inline const size_t RELAY_BUFFER_SIZE = 64*1024;
+
+// copy from in_socket to out_socket, sleeping so that the output never exceeds LINK_MBPS
+void RelayOneWay(int in_socket, int out_socket, double LINK_MBPS)
+{
+    std::vector<char> buffer(RELAY_BUFFER_SIZE);
+    auto next_time = std::chrono::steady_clock::now();
+    while(true){
+        ssize_t LEN = read(in_socket, buffer.data(), buffer.size());
+        if(LEN <= 0) break;
+        // idle time is not banked, a burst after a pause is paced from now on
+        next_time = std::max(next_time, std::chrono::steady_clock::now());
+        next_time += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                     std::chrono::duration<double>(LEN*8/(LINK_MBPS*1e6)));
+        std::this_thread::sleep_until(next_time);
+        for(ssize_t HAVE_SENT_LEN = 0; HAVE_SENT_LEN < LEN; ){
+            ssize_t SENT_LEN = write(out_socket, buffer.data() + HAVE_SENT_LEN, LEN - HAVE_SENT_LEN);
+            if(SENT_LEN <= 0) return;
+            HAVE_SENT_LEN += SENT_LEN;
+        }
+    }
+    shutdown(out_socket, SHUT_WR);
+}
+
+// accept one client on RELAY_PORT, connect it to the server on SERVER_PORT and relay both directions at LINK_MBPS
+// the relay threads are detached, they end when the parties close the connection or the process exits
+void StartThrottledRelay(int RELAY_PORT, int SERVER_PORT, double LINK_MBPS)
+{
+    int master_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    int reuse = 1;
+    setsockopt(master_socket, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = inet_addr("127.0.0.1");
+    address.sin_port = htons(RELAY_PORT);
+    if(bind(master_socket, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(master_socket, 1) < 0){
+        perror("error: relay fails to listen");
+        exit(EXIT_FAILURE);
+    }
+
+    std::thread([=](){
+        int client_socket = accept(master_socket, nullptr, nullptr);
+        close(master_socket);
+        int server_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        struct sockaddr_in server_address = address;
+        server_address.sin_port = htons(SERVER_PORT);
+        if(client_socket < 0 || connect(server_socket, (struct sockaddr *)&server_address, sizeof(server_address)) < 0){
+            perror("error: relay fails to connect");
+            exit(EXIT_FAILURE);
+        }
+        const int one = 1;
+        setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        setsockopt(server_socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        std::thread(RelayOneWay, server_socket, client_socket, LINK_MBPS).detach();
+        RelayOneWay(client_socket, server_socket, LINK_MBPS);
+    }).detach();
+}
+
+// Y shares every other item of X
+void GenTestSets(size_t ITEM_NUM, std::vector<block> &vec_X, std::vector<block> &vec_Y, std::vector<uint8_t> &vec_indication_bit)
+{
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    vec_X = PRG::GenRandomBlocks(seed, ITEM_NUM);
+    vec_Y = PRG::GenRandomBlocks(seed, ITEM_NUM);
+    vec_indication_bit.resize(ITEM_NUM);
+    for(auto i = 0; i < ITEM_NUM; i++){
+        vec_indication_bit[i] = (i%2 == 0);
+        if(vec_indication_bit[i] == 1) vec_Y[(i*7)%ITEM_NUM] = vec_X[i];
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    CRYPTO_Initialize();
+
+    std::string protocol = (argc > 1) ? argv[1] : "psi";
+    std::string mode = (argc > 2) ? argv[2] : "stream";
+    size_t LOG_ITEM_NUM = (argc > 3) ? std::stoul(argv[3]) : 16;
+    size_t CHUNK_LEN = (argc > 4) ? std::stoul(argv[4]) : (1 << 12);
+    double LINK_MBPS = (argc > 5) ? std::stod(argv[5]) : 0;
+    if(mode == "batch") CHUNK_LEN = 0;
+
+    // the client connects to CLIENT_PORT, which is the server itself or the throttled relay in front of it
+    int CLIENT_PORT = (LINK_MBPS > 0) ? 8081 : 8080;
+
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM;
+    std::vector<block> vec_X, vec_Y;
+    std::vector<uint8_t> vec_indication_bit;
+    GenTestSets(ITEM_NUM, vec_X, vec_Y, vec_indication_bit);
+
+    PrintSplitLine('-');
+    std::cout << protocol << " in " << mode << " mode: item num = 2^" << LOG_ITEM_NUM
+              << ", chunk len = " << CHUNK_LEN;
+    if(LINK_MBPS > 0) std::cout << ", link = " << LINK_MBPS << " Mbps";
+    std::cout << std::endl;
+
+    bool SUCCESS = false;
+    size_t COMMUNICATION_COST = 0;
+    auto start_time = std::chrono::steady_clock::now();
+
+    if(protocol == "psi"){
+        cwPRFPSI::PP pp = cwPRFPSI::Setup(128, 40, LOG_ITEM_NUM, LOG_ITEM_NUM, "sortmerge", CHUNK_LEN);
+        std::vector<block> vec_intersection;
+        std::thread receiver([&](){
+            NetIO server("server", "", 8080);
+            vec_intersection = cwPRFPSI::Receive(server, pp, vec_X);
+            COMMUNICATION_COST = server.total;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // wait until the server listens
+        if(LINK_MBPS > 0) StartThrottledRelay(CLIENT_PORT, 8080, LINK_MBPS);
+        std::thread sender([&](){
+            NetIO client("client", "127.0.0.1", CLIENT_PORT);
+            cwPRFPSI::Send(client, pp, vec_Y);
+        });
+        receiver.join();
+        sender.join();
+
+        std::vector<block> vec_intersection_ideal;
+        for(auto i = 0; i < ITEM_NUM; i++){
+            if(vec_indication_bit[i] == 1) vec_intersection_ideal.emplace_back(vec_X[i]);
+        }
+        SUCCESS = Block::Compare(vec_intersection, vec_intersection_ideal);
+    }
+
+    if(protocol == "mqrpmt"){
+        cwPRFmqRPMT::PP pp = cwPRFmqRPMT::Setup(40, LOG_ITEM_NUM, LOG_ITEM_NUM, CHUNK_LEN);
+        std::vector<uint8_t> vec_indication_bit_real;
+        std::thread server_thread([&](){
+            NetIO server("server", "", 8080);
+            vec_indication_bit_real = cwPRFmqRPMT::Server(server, pp, vec_Y);
+            COMMUNICATION_COST = server.total;
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100)); // wait until the server listens
+        if(LINK_MBPS > 0) StartThrottledRelay(CLIENT_PORT, 8080, LINK_MBPS);
+        std::thread client_thread([&](){
+            NetIO client("client", "127.0.0.1", CLIENT_PORT);
+            cwPRFmqRPMT::Client(client, pp, vec_X);
+        });
+        server_thread.join();
+        client_thread.join();
+
+        // Bloom filter admits false positives, count mismatches instead
+        size_t ERROR_NUM = 0;
+        for(auto i = 0; i < ITEM_NUM; i++) ERROR_NUM += (vec_indication_bit_real[i] != vec_indication_bit[i]);
+        std::cout << "mismatched indication bits = " << ERROR_NUM << std::endl;
+        SUCCESS = (ERROR_NUM == 0);
+    }
+
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    PrintSplitLine('-');
+    std::cout << protocol << " (" << mode << ") wall-clock time = "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+    std::cout << protocol << " (" << mode << ") communication = " << (double)COMMUNICATION_COST/(1024*1024) << " MB" << std::endl;
+    #ifdef IS_MACOS
+    std::cout << protocol << " (" << mode << ") peak RSS = " << usage.ru_maxrss/(1024*1024) << " MB" << std::endl;
+    #else
+    std::cout << protocol << " (" << mode << ") peak RSS = " << usage.ru_maxrss/1024 << " MB" << std::endl;
+    #endif
+    std::cout << protocol << " (" << mode << ") output is " << (SUCCESS ? "correct" : "wrong") << std::endl;
+    PrintSplitLine('-');
+
+    CRYPTO_Finalize();
+
+    return 0;
+}
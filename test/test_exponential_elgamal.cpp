@@ -13,7 +13,7 @@ void benchmark_test(size_t MSG_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
     PrintSplitLine('-'); 
 
     ExponentialElGamal::PP pp = ExponentialElGamal::Setup(MSG_LEN, TRADEOFF_NUM);
-    ExponentialElGamal::Initialize(pp); 
+    DLogSolver dlog_solver = ExponentialElGamal::Initialize(pp); 
     PrintSplitLine('-'); 
 
     ECPoint pk[TEST_NUM];                      // pk
@@ -70,7 +70,7 @@ void benchmark_test(size_t MSG_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
     start_time = std::chrono::steady_clock::now(); 
     for(auto i = 0; i < TEST_NUM; i++)
     {
-        m_real[i] = ExponentialElGamal::Dec(pp, sk[i], ct_new[i]); 
+        m_real[i] = ExponentialElGamal::Dec(pp, dlog_solver, sk[i], ct_new[i]); 
     }
     end_time = std::chrono::steady_clock::now(); 
     running_time = end_time - start_time;
@@ -131,7 +131,7 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
     PrintSplitLine('-'); 
 
     ExponentialElGamal::PP pp = ExponentialElGamal::Setup(MSG_LEN, TRADEOFF_NUM);
-    ExponentialElGamal::Initialize(pp); 
+    DLogSolver dlog_solver = ExponentialElGamal::Initialize(pp); 
     PrintSplitLine('-'); 
 
     ECPoint pk;                      // pk
@@ -150,7 +150,7 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
 
     CT = ExponentialElGamal::Enc(pp, pk, m_random);
 
-    m_real = ExponentialElGamal::Dec(pp, sk, CT); 
+    m_real = ExponentialElGamal::Dec(pp, dlog_solver, sk, CT); 
     if(m_random != m_real){ 
         std::cout << "decryption fails for random message" << std::endl;
     }
@@ -160,7 +160,7 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
 
     CT = ExponentialElGamal::Enc(pp, pk, m_left);
 
-    m_real = ExponentialElGamal::Dec(pp, sk, CT); 
+    m_real = ExponentialElGamal::Dec(pp, dlog_solver, sk, CT); 
 
     if(m_left != m_real){ 
         std::cout << "decryption fails for left boundary" << std::endl;
@@ -170,7 +170,7 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
     }
 
     CT = ExponentialElGamal::Enc(pp, pk, m_right);
-    m_real = ExponentialElGamal::Dec(pp, sk, CT); 
+    m_real = ExponentialElGamal::Dec(pp, dlog_solver, sk, CT); 
     if(m_right != m_real){ 
         std::cout << "decryption fails for right boundary" << std::endl;
     }
@@ -0,0 +1,94 @@
+#include "../utility/flat_intersection.hpp"
+#include "../crypto/prg.hpp"
+#include "../crypto/setup.hpp"
+#include "../utility/print.hpp"
+
+/*
+** compare the post-crypto intersection step of cwPRF-based PSI:
+** std::unordered_set<std::string> vs. flat radix partition + sort-merge
+*/
+void benchmark_intersection(size_t LOG_SET_SIZE, size_t LOG_QUERY_SIZE, size_t TRUNCATE_LEN)
+{
+    PrintSplitLine('-');
+    std::cout << "intersection benchmark begins >>>>>>" << std::endl;
+    std::cout << "set size = 2^" << LOG_SET_SIZE << ", query size = 2^" << LOG_QUERY_SIZE
+              << ", truncate length = " << TRUNCATE_LEN << " bytes" << std::endl;
+    PrintSplitLine('-');
+
+    size_t SET_SIZE = size_t(1) << LOG_SET_SIZE;
+    size_t QUERY_SIZE = size_t(1) << LOG_QUERY_SIZE;
+
+    // emulate 32-byte PRF values on the set side and truncated values on the query side
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    std::vector<uint8_t> vec_set_value(32*SET_SIZE);
+    std::vector<uint8_t> vec_query_value(TRUNCATE_LEN*QUERY_SIZE);
+    PRG::GenRandomBytes(seed, vec_set_value.data(), vec_set_value.size());
+    PRG::GenRandomBytes(seed, vec_query_value.data(), vec_query_value.size());
+
+    // half of the queries hit
+    size_t HIT_NUM = std::min(SET_SIZE, QUERY_SIZE)/2;
+    for(auto i = 0; i < HIT_NUM; i++){
+        memcpy(vec_query_value.data() + 2*i*TRUNCATE_LEN, vec_set_value.data() + 32*i, TRUNCATE_LEN);
+    }
+
+    // legacy path
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<std::string> vec_query_str(QUERY_SIZE);
+    for(auto i = 0; i < QUERY_SIZE; i++){
+        vec_query_str[i] = std::string(vec_query_value.data() + i*TRUNCATE_LEN, vec_query_value.data() + (i+1)*TRUNCATE_LEN);
+    }
+    std::unordered_set<std::string> S;
+    for(auto i = 0; i < SET_SIZE; i++){
+        S.insert(std::string(vec_set_value.data() + 32*i, vec_set_value.data() + 32*i + TRUNCATE_LEN));
+    }
+    std::vector<size_t> vec_index_hashset;
+    for(auto i = 0; i < QUERY_SIZE; i++){
+        if(S.find(vec_query_str[i]) != S.end()) vec_index_hashset.emplace_back(i);
+    }
+    auto end_time = std::chrono::steady_clock::now();
+    auto running_time = end_time - start_time;
+    std::cout << "hashset engine takes time = "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    // flat path
+    start_time = std::chrono::steady_clock::now();
+    std::vector<size_t> vec_index_sortmerge;
+    if(TRUNCATE_LEN <= sizeof(uint64_t)){
+        std::vector<uint64_t> vec_set = FlatIntersection::PackKeys<uint64_t>(vec_set_value.data(), SET_SIZE, 32, TRUNCATE_LEN);
+        std::vector<uint64_t> vec_query = FlatIntersection::PackKeys<uint64_t>(vec_query_value.data(), QUERY_SIZE, TRUNCATE_LEN, TRUNCATE_LEN);
+        vec_index_sortmerge = FlatIntersection::SortMergeIntersect(vec_set, vec_query);
+    }
+    else{
+        std::vector<FlatIntersection::uint128_t> vec_set =
+            FlatIntersection::PackKeys<FlatIntersection::uint128_t>(vec_set_value.data(), SET_SIZE, 32, TRUNCATE_LEN);
+        std::vector<FlatIntersection::uint128_t> vec_query =
+            FlatIntersection::PackKeys<FlatIntersection::uint128_t>(vec_query_value.data(), QUERY_SIZE, TRUNCATE_LEN, TRUNCATE_LEN);
+        vec_index_sortmerge = FlatIntersection::SortMergeIntersect(vec_set, vec_query);
+    }
+    end_time = std::chrono::steady_clock::now();
+    running_time = end_time - start_time;
+    std::cout << "sortmerge engine takes time = "
+              << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
+
+    if(vec_index_hashset == vec_index_sortmerge) std::cout << "two engines agree: intersection size = " << vec_index_sortmerge.size() << std::endl;
+    else std::cout << "two engines disagree" << std::endl;
+
+    PrintSplitLine('-');
+    std::cout << "intersection benchmark finishes <<<<<<" << std::endl;
+    PrintSplitLine('-');
+}
+
+int main()
+{
+    CRYPTO_Initialize();
+
+    // TRUNCATE_LEN = (40 + LOG_SENDER_ITEM_NUM + LOG_RECEIVER_ITEM_NUM + 7)/8
+    benchmark_intersection(10, 10, 8);
+    benchmark_intersection(16, 16, 9);
+    benchmark_intersection(20, 20, 10);
+    benchmark_intersection(20, 16, 10);
+
+    CRYPTO_Finalize();
+
+    return 0;
+}
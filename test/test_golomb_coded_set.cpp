@@ -0,0 +1,79 @@
+#define DEBUG
+
+#include "../filter/golomb_coded_set.hpp"
+#include "../crypto/prg.hpp"
+
+
+// build, serialize and query the golomb coded set on random blocks, and measure the false positive rate
+void test_golomb_coded_set(size_t LOG_ITEM_NUM, size_t statistical_security_parameter)
+{
+    PrintSplitLine('-');
+    std::cout << "begin the test of golomb coded set with lambda = " << statistical_security_parameter << " >>>" << std::endl;
+    PrintSplitLine('-');
+
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM;
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, ITEM_NUM);
+    std::vector<block> vec_Q = PRG::GenRandomBlocks(seed, ITEM_NUM); // fresh blocks, none of them is in X
+
+    GolombCodedSet filter(ITEM_NUM, statistical_security_parameter);
+    auto start_time = std::chrono::steady_clock::now();
+    filter.Build(vec_X);
+    auto end_time = std::chrono::steady_clock::now();
+    std::cout << "build with 2^" << LOG_ITEM_NUM << " elements takes "
+              << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl;
+    filter.PrintInfo();
+
+    std::vector<char> buffer(filter.ObjectSize());
+    filter.WriteObject(buffer.data());
+    GolombCodedSet new_filter;
+    if(new_filter.ReadObject(buffer.data(), buffer.size()) == false || new_filter.code != filter.code){
+        std::cout << "serialization round trip fails" << std::endl;
+    }
+
+    start_time = std::chrono::steady_clock::now();
+    std::vector<uint8_t> vec_member_bit = new_filter.Contain(vec_X);
+    end_time = std::chrono::steady_clock::now();
+    std::cout << "query 2^" << LOG_ITEM_NUM << " elements in batch takes "
+              << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms" << std::endl;
+
+    size_t FALSE_NEGATIVE_NUM = ITEM_NUM - std::accumulate(vec_member_bit.begin(), vec_member_bit.end(), size_t(0));
+    for(auto i = 0; i < ITEM_NUM; i += ITEM_NUM/1024){
+        if(new_filter.Contain(vec_X[i]) == false) FALSE_NEGATIVE_NUM++;
+    }
+    std::cout << "false negatives = " << FALSE_NEGATIVE_NUM << std::endl;
+
+    std::vector<uint8_t> vec_indication_bit = new_filter.Contain(vec_Q);
+    size_t FALSE_POSITIVE_NUM = std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0));
+    std::cout << "false positives = " << FALSE_POSITIVE_NUM << " among 2^" << LOG_ITEM_NUM << " queries, measured rate = "
+              << double(FALSE_POSITIVE_NUM)/ITEM_NUM << ", expected rate = " << pow(2, -double(statistical_security_parameter)) << std::endl;
+
+    // a buffer from the peer must be rejected if its layout does not match its length
+    std::vector<char> bad_buffer(buffer);
+    bool status = (new_filter.ReadObject(bad_buffer.data(), bad_buffer.size() - 1) == false);
+    uint32_t chunk_num = filter.chunk_num + 1;
+    memcpy(bad_buffer.data() + sizeof(uint32_t), &chunk_num, sizeof(uint32_t));
+    status &= (new_filter.ReadObject(bad_buffer.data(), bad_buffer.size()) == false);
+    if(filter.chunk_num > 1){
+        bad_buffer = buffer;
+        uint64_t chunk_offset = filter.vec_chunk_offset[2] + 1; // chunk 1 now starts after chunk 2
+        memcpy(bad_buffer.data() + 2*sizeof(uint32_t) + (2 + filter.chunk_num + 1)*sizeof(uint64_t), &chunk_offset, sizeof(uint64_t));
+        status &= (new_filter.ReadObject(bad_buffer.data(), bad_buffer.size()) == false);
+    }
+    std::cout << "malformed buffers are " << (status ? "rejected" : "accepted") << std::endl;
+
+    PrintSplitLine('-');
+    std::cout << "finish the test of golomb coded set >>>" << std::endl;
+    PrintSplitLine('-');
+}
+
+
+int main()
+{
+    // small lambda makes the false positive rate measurable with 2^20 queries
+    test_golomb_coded_set(20, 8);
+    test_golomb_coded_set(20, 16);
+    test_golomb_coded_set(20, 40);
+
+    return 0;
+}
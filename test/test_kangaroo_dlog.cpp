@@ -0,0 +1,85 @@
+#include "../pke/kangaroo_dlog.hpp"
+#include "../crypto/setup.hpp"
+
+/*
+** the kangaroo table of 2^LOG_TABLE_SIZE distinguished points is built once and saved, later runs map it
+** time one DLOG at a time (all threads on one target), and a batch of DLOGs (one target per thread)
+*/
+void benchmark_kangaroo_dlog(size_t RANGE_LEN, size_t LOG_TABLE_SIZE, size_t TEST_NUM)
+{
+    PrintSplitLine('-'); 
+    std::cout << "kangaroo dlog benchmark test begins with " << NUMBER_OF_THREADS << " threads >>>" << std::endl;
+    PrintSplitLine('-'); 
+    std::cout << "RANGE_LEN = " << RANGE_LEN << std::endl;
+    std::cout << "LOG_TABLE_SIZE = " << LOG_TABLE_SIZE << std::endl; 
+    std::cout << "TEST_NUM = " << TEST_NUM << std::endl;
+    PrintSplitLine('-'); 
+
+    ECPoint g = ECPoint(generator); 
+    KangarooDLOG solver(g, RANGE_LEN, LOG_TABLE_SIZE); 
+    std::string table_filename = solver.GetTableFileName(); 
+
+    if(FileExist(table_filename) == false || solver.ReadObject(table_filename) == false){
+        solver.Build(); 
+        solver.WriteObject(table_filename); 
+    }
+    solver.PrintInfo(); 
+
+    std::vector<BigInt> vec_x(TEST_NUM);
+    std::vector<ECPoint> vec_Y(TEST_NUM);  
+    BigInt MAX = BigInt(bn_2).Exp(RANGE_LEN);
+    for(auto i = 0; i < TEST_NUM; i++)
+    {
+        vec_x[i] = GenRandomBigIntLessThan(MAX); 
+        vec_Y[i] = g * vec_x[i];  
+    }
+
+    std::vector<BigInt> vec_x_real(TEST_NUM); 
+    auto start_time = std::chrono::steady_clock::now(); 
+    for(auto i = 0; i < TEST_NUM; i++)
+    {
+        solver.Solve(vec_Y[i], vec_x_real[i]); 
+    }
+    auto end_time = std::chrono::steady_clock::now(); 
+    std::cout << "average dlog takes time = " 
+              << std::chrono::duration <double, std::milli> (end_time - start_time).count()/TEST_NUM << " ms" << std::endl;
+
+    size_t FAIL_NUM = 0; 
+    for(auto i = 0; i < TEST_NUM; i++) FAIL_NUM += (vec_x[i] != vec_x_real[i]); 
+
+    start_time = std::chrono::steady_clock::now(); 
+    std::vector<uint8_t> vec_found = solver.Solve(vec_Y, vec_x_real); 
+    end_time = std::chrono::steady_clock::now(); 
+    std::cout << "average batch dlog takes time = " 
+              << std::chrono::duration <double, std::milli> (end_time - start_time).count()/TEST_NUM << " ms" << std::endl;
+
+    for(auto i = 0; i < TEST_NUM; i++) FAIL_NUM += (vec_found[i] == 0 || vec_x[i] != vec_x_real[i]); 
+    std::cout << "failed dlog num = " << FAIL_NUM << std::endl; 
+
+    PrintSplitLine('-'); 
+    std::cout << "kangaroo dlog benchmark test finishes <<<" << std::endl; 
+    PrintSplitLine('-'); 
+}
+
+
+/*
+** ./test_kangaroo_dlog [MAX_RANGE_LEN]
+** only the 32-bit case runs by default, the 40-bit (MAX_RANGE_LEN >= 40) and 48-bit (MAX_RANGE_LEN >= 48) cases
+** build their tables in about 100 s and 770 s on one thread, and a 48-bit query takes 3-7 s
+*/
+int main(int argc, char* argv[])
+{  
+    CRYPTO_Initialize();   
+    
+    std::ios::sync_with_stdio(false);
+
+    size_t MAX_RANGE_LEN = (argc > 1) ? std::stoul(argv[1]) : 32; 
+
+    benchmark_kangaroo_dlog(32, 12, 100); 
+    if(MAX_RANGE_LEN >= 40) benchmark_kangaroo_dlog(40, 14, 20); 
+    if(MAX_RANGE_LEN >= 48) benchmark_kangaroo_dlog(48, 12, 4); 
+
+    CRYPTO_Finalize(); 
+
+    return 0; 
+}
@@ -0,0 +1,94 @@
+#include "../mpc/psi/labeled_psi.hpp"
+#include "../crypto/setup.hpp"
+
+/*
+** labeled PSI throughput for several label lengths
+** both parties derive the same test case from fixed_seed, then run one instance per label length over one connection
+*/
+
+struct TestCase{
+    size_t ITEM_NUM;
+    std::vector<block> vec_X; // receiver's set
+    std::vector<block> vec_Y; // sender's set
+    std::vector<size_t> vec_map; // vec_X[i] = vec_Y[vec_map[i]] for even i
+};
+
+// every even-indexed item of X appears in Y
+TestCase GenTestCase(size_t LOG_ITEM_NUM)
+{
+    TestCase testcase;
+    testcase.ITEM_NUM = size_t(pow(2, LOG_ITEM_NUM));
+
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0);
+    testcase.vec_X = PRG::GenRandomBlocks(seed, testcase.ITEM_NUM);
+    testcase.vec_Y = PRG::GenRandomBlocks(seed, testcase.ITEM_NUM);
+    testcase.vec_map.resize(testcase.ITEM_NUM);
+    for(auto i = 0; i < testcase.ITEM_NUM; i += 2){
+        testcase.vec_map[i] = (i*7) % testcase.ITEM_NUM;
+        testcase.vec_Y[testcase.vec_map[i]] = testcase.vec_X[i];
+    }
+    return testcase;
+}
+
+int main()
+{
+    CRYPTO_Initialize();
+
+    PrintSplitLine('-');
+    std::cout << "labeled PSI test begins >>>" << std::endl;
+    PrintSplitLine('-');
+
+    size_t LOG_ITEM_NUM = 16;
+    std::vector<size_t> vec_LABEL_LEN = {16, 256, 1024, 4096};
+    TestCase testcase = GenTestCase(LOG_ITEM_NUM);
+    std::cout << "number of items = 2^" << LOG_ITEM_NUM << std::endl;
+
+    std::string party;
+    std::cout << "please select your role between sender and receiver (hint: first start receiver, then start sender) ==> ";
+    std::getline(std::cin, party);
+    PrintSplitLine('-');
+
+    if(party == "sender"){
+        NetIO client("client", "127.0.0.1", 8080);
+        for(auto LABEL_LEN : vec_LABEL_LEN){
+            LabeledPSI::PP pp = LabeledPSI::Setup(40, LOG_ITEM_NUM, LOG_ITEM_NUM, LABEL_LEN);
+            PRG::Seed seed = PRG::SetSeed(fixed_seed, 1);
+            std::vector<uint8_t> vec_label = PRG::GenRandomBytes(seed, pp.SENDER_ITEM_NUM*LABEL_LEN);
+            LabeledPSI::Send(client, pp, testcase.vec_Y, vec_label);
+        }
+    }
+
+    if(party == "receiver"){
+        NetIO server("server", "", 8080);
+        for(auto LABEL_LEN : vec_LABEL_LEN){
+            LabeledPSI::PP pp = LabeledPSI::Setup(40, LOG_ITEM_NUM, LOG_ITEM_NUM, LABEL_LEN);
+            PRG::Seed seed = PRG::SetSeed(fixed_seed, 1);
+            std::vector<uint8_t> vec_label_ideal = PRG::GenRandomBytes(seed, pp.SENDER_ITEM_NUM*LABEL_LEN);
+
+            std::vector<uint8_t> vec_label;
+            auto start_time = std::chrono::steady_clock::now();
+            std::vector<size_t> vec_index = LabeledPSI::Receive(server, pp, testcase.vec_X, vec_label);
+            auto end_time = std::chrono::steady_clock::now();
+            double running_time = std::chrono::duration <double, std::milli> (end_time - start_time).count();
+
+            bool SUCCESS = (vec_index.size() == testcase.ITEM_NUM/2);
+            for(auto t = 0; SUCCESS && t < vec_index.size(); t++){
+                size_t i = vec_index[t];
+                SUCCESS = (i%2 == 0) && memcmp(vec_label.data() + t*LABEL_LEN,
+                                               vec_label_ideal.data() + testcase.vec_map[i]*LABEL_LEN, LABEL_LEN) == 0;
+            }
+
+            std::cout << "label length = " << LABEL_LEN << " bytes: " << running_time << " ms, "
+                      << testcase.ITEM_NUM/(running_time/1000) << " items/s, "
+                      << (double)testcase.ITEM_NUM*LABEL_LEN/(1024*1024)/(running_time/1000) << " MB/s of labels, "
+                      << "communication = " << (double)server.total/(1024*1024) << " MB (cumulative)" << std::endl;
+            if(SUCCESS) std::cout << "labeled PSI test succeeds" << std::endl;
+            else std::cout << "labeled PSI test fails" << std::endl;
+            PrintSplitLine('-');
+        }
+    }
+
+    CRYPTO_Finalize();
+
+    return 0;
+}
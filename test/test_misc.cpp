@@ -3,6 +3,7 @@
 #include "../crypto/prg.hpp"
 #include "../crypto/hash.hpp"
 #include "../utility/print.hpp"
+#include "../utility/murmurhash3.hpp"
 #include "../crypto/setup.hpp"
 
 
@@ -78,6 +79,70 @@ void test_hash_to_point(size_t LEN)
     << std::chrono::duration <double, std::milli> (running_time).count() << " ms" << std::endl;
 }
 
+// compare the scalar keyed hash used by the filters with its multi-lane versions on 16- and 32-byte keys
+void benchmark_batch_hash(size_t LOG_ITEM_NUM)
+{
+    PrintSplitLine('-'); 
+    std::cout << "batch hash benchmark begins with " << LiteMurmurHashLaneNum() << " lanes >>>>>>" << std::endl; 
+    PrintSplitLine('-'); 
+
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM; 
+    PRG::Seed seed = PRG::SetSeed(fixed_seed, 0); // initialize PRG
+    std::vector<block> vec_M = PRG::GenRandomBlocks(seed, 2*ITEM_NUM);
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(vec_M.data()); 
+    std::vector<uint32_t> vec_digest(ITEM_NUM); 
+    std::vector<uint32_t> vec_batch_digest(ITEM_NUM); 
+
+    for(auto ITEM_LEN : {16, 32}){
+        auto start_time = std::chrono::steady_clock::now(); 
+        for(auto i = 0; i < ITEM_NUM; i++){
+            vec_digest[i] = LiteMurmurHash(fixed_salt32, input + i*ITEM_LEN, ITEM_LEN); 
+        }
+        auto end_time = std::chrono::steady_clock::now(); 
+        double scalar_time = std::chrono::duration <double> (end_time - start_time).count(); 
+
+        start_time = std::chrono::steady_clock::now(); 
+        LiteMurmurHashBatch(fixed_salt32, input, ITEM_LEN, ITEM_NUM, vec_batch_digest.data()); 
+        end_time = std::chrono::steady_clock::now(); 
+        double batch_time = std::chrono::duration <double> (end_time - start_time).count(); 
+
+        std::cout << ITEM_LEN << "-byte keys: scalar " << ITEM_NUM/scalar_time/1000000 << " M hashes/s, batch " 
+                  << ITEM_NUM/batch_time/1000000 << " M hashes/s, outputs " 
+                  << (vec_digest == vec_batch_digest ? "identical" : "differ") << std::endl; 
+    }
+
+    // 40 salted hashes per key, as in a bloom filter with statistical security parameter 40
+    size_t SALT_NUM = 40; 
+    size_t KEY_NUM = ITEM_NUM/SALT_NUM; 
+    std::vector<uint32_t> vec_salt(SALT_NUM); 
+    for(auto j = 0; j < SALT_NUM; j++) vec_salt[j] = fmix32(j + 1); 
+    for(auto ITEM_LEN : {16, 32}){
+        auto start_time = std::chrono::steady_clock::now(); 
+        for(auto i = 0; i < KEY_NUM; i++){
+            for(auto j = 0; j < SALT_NUM; j++){
+                vec_digest[i*SALT_NUM+j] = LiteMurmurHash(vec_salt[j], input + i*ITEM_LEN, ITEM_LEN); 
+            }
+        }
+        auto end_time = std::chrono::steady_clock::now(); 
+        double scalar_time = std::chrono::duration <double> (end_time - start_time).count(); 
+
+        start_time = std::chrono::steady_clock::now(); 
+        for(auto i = 0; i < KEY_NUM; i++){
+            LiteMurmurHashMultiSalt(vec_salt.data(), SALT_NUM, input + i*ITEM_LEN, ITEM_LEN, vec_batch_digest.data() + i*SALT_NUM); 
+        }
+        end_time = std::chrono::steady_clock::now(); 
+        double batch_time = std::chrono::duration <double> (end_time - start_time).count(); 
+
+        std::cout << ITEM_LEN << "-byte keys with " << SALT_NUM << " salts: scalar " << KEY_NUM*SALT_NUM/scalar_time/1000000 
+                  << " M hashes/s, multi-salt " << KEY_NUM*SALT_NUM/batch_time/1000000 << " M hashes/s, outputs " 
+                  << (vec_digest == vec_batch_digest ? "identical" : "differ") << std::endl; 
+    }
+
+    PrintSplitLine('-'); 
+    std::cout << "batch hash benchmark finishes <<<<<<" << std::endl; 
+    PrintSplitLine('-'); 
+}
+
 // void test_fast_hash_to_point(size_t LEN)
 // {
 //     PRG::Seed seed; 
@@ -162,6 +227,8 @@ int main()
 
     // test_hash_to_point(TEST_NUM);
 
+    benchmark_batch_hash(24); 
+
 
     // std::string test_filename = "testio.txt";
     // std::ofstream fout; 
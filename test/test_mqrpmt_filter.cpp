@@ -0,0 +1,167 @@
+#include "../mpc/rpmt/cwprf_mqrpmt.hpp"
+#include "../crypto/setup.hpp"
+
+/*
+** compare the filter types of cwPRF-based mqRPMT
+** (1) end-to-end: both parties run in one process over loopback, report bytes of the step-2 message and correctness
+** (2) server query throughput: query 2^LOG_ITEM_NUM random points against each filter built on 2^LOG_ITEM_NUM points
+**   ./test_mqrpmt_filter [LOG_ITEM_NUM] [CHUNK_LEN]
+*/
+
+std::vector<EC25519Point> GenRandomPoints(PRG::Seed &seed, size_t NUM)
+{
+    std::vector<EC25519Point> vec_A(NUM);
+    for(auto i = 0; i < NUM; i++) PRG::GenRandomBytes(seed, vec_A[i].px, 32);
+    return vec_A;
+}
+
+template <typename FilterType>
+double QueryThroughput(FilterType &filter, std::vector<EC25519Point> &vec_query, size_t &HIT_NUM)
+{
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<uint8_t> vec_indication_bit = filter.Contain(vec_query); // batch query, as the server does
+    auto end_time = std::chrono::steady_clock::now();
+    HIT_NUM = std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0));
+    return vec_query.size()/std::chrono::duration <double> (end_time - start_time).count();
+}
+
+void benchmark_protocol(std::string filter_type, size_t LOG_ITEM_NUM, size_t CHUNK_LEN, size_t PORT)
+{
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM;
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, ITEM_NUM);
+    std::vector<block> vec_Y = PRG::GenRandomBlocks(seed, ITEM_NUM);
+    for(auto i = 0; i < ITEM_NUM; i += 2) vec_Y[(i*7)%ITEM_NUM] = vec_X[i];
+
+    // the tags of cuckoo filter are at most 32 bits, so it only meets lambda = 29
+    size_t statistical_security_parameter = (filter_type == "cuckoo") ? 29 : 40;
+    cwPRFmqRPMT::PP pp = cwPRFmqRPMT::Setup(statistical_security_parameter, LOG_ITEM_NUM, LOG_ITEM_NUM, CHUNK_LEN, filter_type);
+    std::vector<uint8_t> vec_indication_bit;
+    size_t COMMUNICATION_COST = 0;
+
+    auto start_time = std::chrono::steady_clock::now();
+    std::thread server_thread([&](){
+        NetIO server("server", "", PORT);
+        vec_indication_bit = cwPRFmqRPMT::Server(server, pp, vec_Y);
+        COMMUNICATION_COST = server.total;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100)); // wait until the server listens
+    std::thread client_thread([&](){
+        NetIO client("client", "127.0.0.1", PORT);
+        cwPRFmqRPMT::Client(client, pp, vec_X);
+    });
+    server_thread.join();
+    client_thread.join();
+    auto end_time = std::chrono::steady_clock::now();
+
+    size_t ERROR_NUM = 0;
+    for(auto i = 0; i < ITEM_NUM; i++) ERROR_NUM += (vec_indication_bit[i] != (i%2 == 0));
+
+    // everything except the step-2 message: F_k1(y_i) and F_k2(x_i)
+    size_t FILTER_BYTES = COMMUNICATION_COST - 2*32*ITEM_NUM;
+    std::cout << filter_type << (CHUNK_LEN == 0 ? " (batch)" : " (stream)") << ": step-2 message = "
+              << (double)FILTER_BYTES/(1024*1024) << " MB (" << 8.0*FILTER_BYTES/ITEM_NUM << " bits per item), "
+              << "wall-clock time = " << std::chrono::duration <double, std::milli> (end_time - start_time).count() << " ms, "
+              << "mismatched indication bits = " << ERROR_NUM << std::endl;
+}
+
+// the filters built from block keys must report every key as present when queried with the same keys
+void test_block_round_trip(size_t LOG_ITEM_NUM)
+{
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM;
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    std::vector<block> vec_X = PRG::GenRandomBlocks(seed, ITEM_NUM);
+    std::vector<block> vec_Z = PRG::GenRandomBlocks(seed, ITEM_NUM);
+
+    BinaryFuseFilter filter(ITEM_NUM, 40);
+    filter.Build(vec_X);
+    std::vector<uint8_t> vec_indication_bit = filter.Contain(vec_X);
+    size_t MISS_NUM = ITEM_NUM - std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0));
+    vec_indication_bit = filter.Contain(vec_Z);
+    size_t FALSE_HIT_NUM = std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0));
+
+    std::vector<block> vec_digest(ITEM_NUM);
+    for(auto i = 0; i < ITEM_NUM; i++) vec_digest[i] = BinaryFuseFilter::Digest(vec_X[i]);
+    BinaryFuseFilter digest_filter(ITEM_NUM, 40);
+    digest_filter.BuildDigest(vec_digest);
+    vec_indication_bit = digest_filter.ContainDigest(vec_digest);
+    MISS_NUM += ITEM_NUM - std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0));
+    vec_indication_bit = digest_filter.Contain(vec_X);
+    MISS_NUM += ITEM_NUM - std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0));
+
+    std::cout << "binaryfuse block round trip, 2^" << LOG_ITEM_NUM << " keys: missing members = " << MISS_NUM
+              << ", false hits among non-members = " << FALSE_HIT_NUM << std::endl;
+    if(MISS_NUM != 0) std::cout << "binaryfuse block round trip fails" << std::endl;
+}
+
+void benchmark_query(size_t LOG_ITEM_NUM)
+{
+    size_t ITEM_NUM = size_t(1) << LOG_ITEM_NUM;
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    std::vector<EC25519Point> vec_set = GenRandomPoints(seed, ITEM_NUM);
+    std::vector<EC25519Point> vec_query = GenRandomPoints(seed, ITEM_NUM);
+    for(auto i = 0; i < ITEM_NUM; i += 2) vec_query[i] = vec_set[(i*7)%ITEM_NUM];
+
+    PrintSplitLine('-');
+    std::cout << "server query throughput, set size = query size = 2^" << LOG_ITEM_NUM << ", half of the queries hit" << std::endl;
+    size_t HIT_NUM;
+
+    BloomFilter bloom(ITEM_NUM, 40);
+    bloom.Insert(vec_set);
+    double throughput = QueryThroughput(bloom, vec_query, HIT_NUM);
+    std::cout << "bloom: " << throughput/1000000 << " M queries/s, hits = " << HIT_NUM << std::endl;
+
+    CuckooFilter cuckoo(ITEM_NUM, pow(2, -40.0));
+    cuckoo.Insert(vec_set);
+    throughput = QueryThroughput(cuckoo, vec_query, HIT_NUM);
+    std::cout << "cuckoo: " << throughput/1000000 << " M queries/s, hits = " << HIT_NUM << std::endl;
+
+    BinaryFuseFilter binaryfuse(ITEM_NUM, 40);
+    binaryfuse.Build(vec_set);
+    throughput = QueryThroughput(binaryfuse, vec_query, HIT_NUM);
+    std::cout << "binaryfuse: " << throughput/1000000 << " M queries/s, hits = " << HIT_NUM << std::endl;
+
+    BlockedBloomFilter blockedbloom(ITEM_NUM, 40);
+    blockedbloom.Insert(vec_set);
+    throughput = QueryThroughput(blockedbloom, vec_query, HIT_NUM);
+    std::cout << "blockedbloom: " << throughput/1000000 << " M queries/s, hits = " << HIT_NUM << std::endl;
+
+    GolombCodedSet gcs(ITEM_NUM, 40);
+    gcs.Build(vec_set);
+    throughput = QueryThroughput(gcs, vec_query, HIT_NUM);
+    std::cout << "gcs: " << throughput/1000000 << " M queries/s, hits = " << HIT_NUM << std::endl;
+
+    std::unordered_set<EC25519Point, EC25519PointHash> S(vec_set.begin(), vec_set.end());
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<uint8_t> vec_indication_bit(ITEM_NUM);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < ITEM_NUM; i++) vec_indication_bit[i] = (S.find(vec_query[i]) != S.end());
+    auto end_time = std::chrono::steady_clock::now();
+    HIT_NUM = std::accumulate(vec_indication_bit.begin(), vec_indication_bit.end(), size_t(0));
+    throughput = ITEM_NUM/std::chrono::duration <double> (end_time - start_time).count();
+    std::cout << "shuffle (hash set): " << throughput/1000000 << " M queries/s, hits = " << HIT_NUM << std::endl;
+    PrintSplitLine('-');
+}
+
+int main(int argc, char* argv[])
+{
+    CRYPTO_Initialize();
+
+    size_t LOG_ITEM_NUM = (argc > 1) ? std::stoul(argv[1]) : 16;
+    size_t CHUNK_LEN = (argc > 2) ? std::stoul(argv[2]) : (1 << 12);
+
+    std::vector<std::string> vec_filter_type = {"bloom", "cuckoo", "binaryfuse", "blockedbloom", "shuffle", "compressedbloom", "gcs"};
+    // a fresh port per run avoids waiting for TIME_WAIT of the previous connection
+    size_t PORT = 8080;
+    for(auto filter_type : vec_filter_type){
+        benchmark_protocol(filter_type, LOG_ITEM_NUM, 0, PORT++);
+        benchmark_protocol(filter_type, LOG_ITEM_NUM, CHUNK_LEN, PORT++);
+    }
+
+    test_block_round_trip(LOG_ITEM_NUM);
+    benchmark_query(LOG_ITEM_NUM);
+
+    CRYPTO_Finalize();
+
+    return 0;
+}
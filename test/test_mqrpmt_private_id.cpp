@@ -166,16 +166,38 @@ int main()
     std::getline(std::cin, party); // first the server, then the client
     PrintSplitLine('-'); 
 
+    std::string mode;
+    // the concurrent mode is opt-in: it is slower unless each party has spare cores for the second OPRF role
+    std::cout << "run the two OPRFs of Phase 1 concurrently over two channels (must be same for both parties) [y/N] ==> ";  
+    std::getline(std::cin, mode); 
+    PrintSplitLine('-'); 
+
     size_t ITEM_LEN = pp.oprf_part.RANGE_SIZE; // byte length of each item
     
     if(party == "sender"){
-        NetIO server_io("server", "", 8080);
-        mqRPMTPrivateID::Send(server_io, pp, testcase.vec_X, ITEM_LEN);
+        if(mode == "y"){
+            // listen on both ports before the receiver connects, it connects to 8081 right after 8080
+            std::unique_ptr<NetIO> aux_server_io; 
+            std::thread aux_thread([&](){ aux_server_io = std::make_unique<NetIO>("server", "", 8081); }); 
+            NetIO server_io("server", "", 8080);
+            aux_thread.join(); 
+            mqRPMTPrivateID::Send(server_io, *aux_server_io, pp, testcase.vec_X, ITEM_LEN);
+        }
+        else{
+            NetIO server_io("server", "", 8080);
+            mqRPMTPrivateID::Send(server_io, pp, testcase.vec_X, ITEM_LEN);
+        }
     }
     
     if(party == "receiver"){
         NetIO client_io("client", "127.0.0.1", 8080);        
-        mqRPMTPrivateID::Receive(client_io, pp, testcase.vec_Y, ITEM_LEN);
+        if(mode == "y"){
+            NetIO aux_client_io("client", "127.0.0.1", 8081);
+            mqRPMTPrivateID::Receive(client_io, aux_client_io, pp, testcase.vec_Y, ITEM_LEN);
+        }
+        else{
+            mqRPMTPrivateID::Receive(client_io, pp, testcase.vec_Y, ITEM_LEN);
+        }
     } 
 
     CRYPTO_Finalize();   
@@ -225,6 +225,25 @@ int main()
         else{
             std::cout << "mqRPMT-based PSI-card-sum test fails" << std::endl; 
         }
+
+        /* 
+        ** rerun with a sum bound above 64 bits to take the BigInt path: 
+        ** the test values sum up to less than 2^LOG_SUM_BOUND, so both paths must output the same result 
+        */
+        mqRPMTPSIcardsum::PP wide_pp = pp; 
+        wide_pp.LOG_SUM_BOUND = 72; 
+        std::vector<BigInt> vec_value = testcase.vec_value; // the BigInt path masks the values in place
+
+        size_t WIDE_CARDINALITY; 
+        BigInt WIDE_SUM; 
+        std::tie(WIDE_CARDINALITY, WIDE_SUM) = mqRPMTPSIcardsum::Send(server, wide_pp, testcase.vec_X, vec_value); 
+
+        if(WIDE_CARDINALITY == CARDINALITY && WIDE_SUM == SUM){
+            std::cout << "native and BigInt paths of PSI-card-sum agree" << std::endl; 
+        }
+        else{
+            std::cout << "native and BigInt paths of PSI-card-sum disagree" << std::endl; 
+        }
     }
     
     if(party == "receiver"){
@@ -235,6 +254,17 @@ int main()
 
         double error_probability = abs(double(testcase.HAMMING_WEIGHT)-double(CARDINALITY))/double(testcase.HAMMING_WEIGHT); 
         std::cout << "mqRPMT-based PSI-card-sum test succeeds with probability " << (1 - error_probability) << std::endl; 
+
+        // the sender reruns on the BigInt path, see above
+        mqRPMTPSIcardsum::PP wide_pp = pp; 
+        wide_pp.LOG_SUM_BOUND = 72; 
+        size_t WIDE_CARDINALITY = mqRPMTPSIcardsum::Receive(client, wide_pp, testcase.vec_Y);
+        if(WIDE_CARDINALITY == CARDINALITY){
+            std::cout << "native and BigInt paths of PSI-card-sum agree on the cardinality" << std::endl; 
+        }
+        else{
+            std::cout << "native and BigInt paths of PSI-card-sum disagree on the cardinality" << std::endl; 
+        }
  
     }
 
@@ -184,6 +184,11 @@ int main()
         NetIO client("client", ip, 8080);        
         mqRPMTPSU::Send(client, pp, testcase.vec_X);
         std::cout << "TOTAL COMM: "<< client.total << "\n"; 
+
+        // run the flat-buffer overload on the same set, each block as a 16-byte item
+        std::vector<uint8_t> vec_flat_X(testcase.SENDER_ITEM_NUM*sizeof(block)); 
+        memcpy(vec_flat_X.data(), testcase.vec_X.data(), vec_flat_X.size()); 
+        mqRPMTPSU::Send(client, pp, vec_flat_X, sizeof(block));
     } 
 
     if(party == "receiver"){
@@ -195,6 +200,21 @@ int main()
         double error_probability = set_diff_result.size()/double(testcase.vec_union.size()); 
         std::cout << "mqRPMT-based PSU test succeeds with probability " << (1 - error_probability) << std::endl; 
         std::cout << "TOTAL COMM: "<< server.total << "\n"; 
+
+        // the flat-buffer overload must return the same union as the block-based path
+        std::vector<uint8_t> vec_flat_Y(testcase.RECEIVER_ITEM_NUM*sizeof(block)); 
+        memcpy(vec_flat_Y.data(), testcase.vec_Y.data(), vec_flat_Y.size()); 
+        std::vector<uint8_t> vec_flat_union = mqRPMTPSU::Receive(server, pp, vec_flat_Y, sizeof(block)); 
+        std::vector<block> vec_flat_union_real(vec_flat_union.size()/sizeof(block)); 
+        memcpy(vec_flat_union_real.data(), vec_flat_union.data(), vec_flat_union.size()); 
+        
+        if(vec_flat_union_real.size() == vec_union_real.size() && 
+           ComputeSetDifference(vec_flat_union_real, vec_union_real).empty()){
+            std::cout << "flat-buffer PSU matches the block-based PSU" << std::endl; 
+        }
+        else{
+            std::cout << "flat-buffer PSU does not match the block-based PSU" << std::endl; 
+        }
     }
 
     CRYPTO_Finalize();   
@@ -1,4 +1,5 @@
 #include "../mpc/peqt/peqt_from_ddh.hpp"
+#include "../mpc/peqt/peqt_from_x25519.hpp"
 #include "../crypto/setup.hpp"
 
 
@@ -70,18 +71,29 @@ int main()
     CRYPTO_Initialize(); 
 
     PrintSplitLine('-'); 
-    std::cout << "DDH-based PEQT test begins >>>" << std::endl; 
+    std::cout << "PEQT test begins >>>" << std::endl; 
     PrintSplitLine('-'); 
     std::cout << "generate or load public parameters and test case" << std::endl;
 
-    // generate pp (must be same for both server and client)
-
-    size_t ROW_NUM = size_t(pow(2, 0));
-    size_t COLUMN_NUM = size_t(pow(2, 8)); 
+    // matrix dimension and curve (must be same for both server and client)
+    std::string str_dimension; 
+    std::cout << "please input LOG_ROW_NUM and LOG_COLUMN_NUM (e.g. \"0 8\", up to 2^24 items in total) ==> "; 
+    std::getline(std::cin, str_dimension); 
+    size_t LOG_ROW_NUM = 0, LOG_COLUMN_NUM = 8; 
+    std::stringstream(str_dimension) >> LOG_ROW_NUM >> LOG_COLUMN_NUM; 
+
+    std::string curve; 
+    std::cout << "please select the curve between p256 and x25519 ==> "; 
+    std::getline(std::cin, curve); 
+    if(curve != "x25519") curve = "p256"; 
+    std::string protocol_name = (curve == "x25519") ? "x25519-based PEQT" : "DDH-based PEQT"; 
+
+    size_t ROW_NUM = size_t(pow(2, LOG_ROW_NUM));
+    size_t COLUMN_NUM = size_t(pow(2, LOG_COLUMN_NUM)); 
     std::cout << "matrix dimension = " << ROW_NUM << "*" << COLUMN_NUM << std::endl; 
 
     size_t LEN = ROW_NUM * COLUMN_NUM; 
-    std::string testcase_filename = "PEQT.testcase"; 
+    std::string testcase_filename = "PEQT_" + std::to_string(LOG_ROW_NUM) + "_" + std::to_string(LOG_COLUMN_NUM) + ".testcase"; 
     PEQTTestcase testcase; 
     if(!FileExist(testcase_filename)){
         testcase = GenTestInstance(LEN); 
@@ -100,19 +112,44 @@ int main()
     std::getline(std::cin, party); // first the server, then the client
     PrintSplitLine('-'); 
 
+    auto start_time = std::chrono::steady_clock::now(); 
+    double running_time = 0; 
+
     if(party == "sender"){
         NetIO server("server", "", 8080);
-        std::vector<uint64_t> permutation_map = DDHPEQT::Send(server, testcase.vec_X, ROW_NUM, COLUMN_NUM);
+        std::vector<uint64_t> permutation_map; 
+        if(curve == "x25519") permutation_map = X25519PEQT::Send(server, testcase.vec_X, ROW_NUM, COLUMN_NUM);
+        else permutation_map = DDHPEQT::Send(server, testcase.vec_X, ROW_NUM, COLUMN_NUM);
+        running_time = std::chrono::duration <double> (std::chrono::steady_clock::now() - start_time).count(); 
+
+        // reveal the permutation after the protocol, only for the receiver to check its result
+        server.SendBytes(permutation_map.data(), LEN*sizeof(uint64_t)); 
     }
 
     if(party == "receiver")
     {
         NetIO client("client", "127.0.0.1", 8080);        
-        std::vector<uint8_t> vec_result = DDHPEQT::Receive(client, testcase.vec_Y, ROW_NUM, COLUMN_NUM);
+        std::vector<uint8_t> vec_result; 
+        if(curve == "x25519") vec_result = X25519PEQT::Receive(client, testcase.vec_Y, ROW_NUM, COLUMN_NUM);
+        else vec_result = DDHPEQT::Receive(client, testcase.vec_Y, ROW_NUM, COLUMN_NUM);
+        running_time = std::chrono::duration <double> (std::chrono::steady_clock::now() - start_time).count(); 
+        std::cout << "TOTAL COMM: " << client.total << std::endl; 
+
+        // the i-th item lands at position permutation_map[i] of the result
+        std::vector<uint64_t> permutation_map(LEN); 
+        client.ReceiveBytes(permutation_map.data(), LEN*sizeof(uint64_t)); 
+        size_t ERROR_NUM = 0; 
+        for(size_t i = 0; i < LEN; i++){
+            if(permutation_map[i] >= LEN || vec_result[permutation_map[i]] != testcase.vec_indication_bit[i]) ERROR_NUM++; 
+        }
+        if(ERROR_NUM == 0) std::cout << protocol_name << " test succeeds" << std::endl; 
+        else std::cout << protocol_name << " test fails at " << ERROR_NUM << " positions" << std::endl; 
     } 
+
+    std::cout << protocol_name << " throughput = " << LEN/running_time << " items/s" << std::endl; 
     
     PrintSplitLine('-'); 
-    std::cout << "DDH-based PEQT test ends >>>" << std::endl; 
+    std::cout << protocol_name << " test ends >>>" << std::endl; 
     PrintSplitLine('-'); 
 
     CRYPTO_Finalize();   
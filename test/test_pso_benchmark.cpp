@@ -0,0 +1,652 @@
+#include "../mpc/pso/mqrpmt_psi.hpp"
+#include "../mpc/pso/mqrpmt_psi_card.hpp"
+#include "../mpc/pso/mqrpmt_psi_card_sum.hpp"
+#include "../mpc/pso/mqrpmt_psu.hpp"
+#include "../mpc/pso/mqrpmt_private_id.hpp"
+#include "../mpc/psi/cwprf_psi.hpp"
+#include "../crypto/setup.hpp"
+
+#include <map>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/*
+** non-interactive benchmark driver for the PSO protocols, results are written as JSON or CSV
+** each run is executed in a forked child, so that the peak RSS of one run does not leak into the next
+**   localhost mode: sender and receiver are two processes talking over 127.0.0.1, peak RSS is per party
+**   inprocess mode: sender and receiver are two threads of one process, peak RSS covers both parties
+** phases are delimited by the "[...] Phase N: ..." banners the protocols already print,
+** for each phase we record wall-clock time and bytes sent/received by that party;
+** protocols without phase banners (cwprf_psi) are reported as a single phase
+**
+** usage: ./test_pso_benchmark [key=value ...], comma separated values are swept
+**   protocol=psi,psi_card,psi_card_sum,psu,private_id,cwprf_psi   (default psi)
+**   log_item_num=12,16:20      "a:b" means 2^a sender items and 2^b receiver items (default 12)
+**   threads=1,4                value of NUMBER_OF_THREADS used by both parties (default NUMBER_OF_THREADS)
+**   filter=bloom,binaryfuse,blockedbloom,shuffle,compressedbloom,gcs   filter of cwPRF-based mqRPMT, ignored by cwprf_psi (default bloom)
+**   mode=localhost|inprocess   (default localhost)
+**   repeat=N port=P format=json|csv output=FILE verbose=0|1
+*/
+
+struct BenchConfig{
+    std::string protocol;
+    std::string mode;
+    size_t LOG_SENDER_ITEM_NUM;
+    size_t LOG_RECEIVER_ITEM_NUM;
+    size_t thread_num;
+    std::string filter_type;
+    size_t repeat_index;
+    int port;
+    bool verbose;
+};
+
+struct PhaseReport{
+    std::string name;
+    double time_ms = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_received = 0;
+};
+
+struct PartyReport{
+    std::string party;
+    bool finished = false; // false if the child crashed or exited early
+    bool correct = false;
+    double time_ms = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t bytes_received = 0;
+    long peak_rss_kb = 0;
+    std::vector<PhaseReport> vec_phase;
+
+    // bookkeeping while the party runs
+    NetIO *io = nullptr;
+    std::chrono::steady_clock::time_point start_time;
+};
+
+/*
+** a streambuf installed on std::cout while a party runs: every complete line is checked for a phase banner,
+** the banner opens a new phase of the party that printed it (parties are told apart by thread)
+** the protocol output itself is dropped unless verbose
+*/
+class PhaseRecorder: public std::streambuf{
+public:
+    static inline thread_local PartyReport *current_report = nullptr;
+
+    PhaseRecorder(std::streambuf *original, bool verbose): original(original), verbose(verbose) {}
+
+protected:
+    int overflow(int c) override
+    {
+        if(c == EOF) return 0;
+        line += char(c);
+        if(c == '\n') ProcessLine();
+        return c;
+    }
+
+    std::streamsize xsputn(const char *s, std::streamsize n) override
+    {
+        for(auto i = 0; i < n; i++) overflow((unsigned char)s[i]);
+        return n;
+    }
+
+private:
+    std::streambuf *original;
+    bool verbose;
+    std::mutex mtx;
+    static inline thread_local std::string line;
+
+    void ProcessLine()
+    {
+        PartyReport *report = current_report;
+        size_t pos = line.find("] Phase ");
+        if(report != nullptr && report->io != nullptr && pos != std::string::npos){
+            // "[mqRPMT-based PSI] Phase 2: execute one-sided OTe >>>" ==> "[mqRPMT-based PSI] Phase 2: execute one-sided OTe"
+            // the tag is kept, since a protocol may run another one as a sub-protocol (e.g., Private-ID runs PSU)
+            size_t begin = line.rfind('[', pos);
+            if(begin == std::string::npos) begin = pos + 2;
+            std::string name = line.substr(begin);
+            name = name.substr(0, std::min(name.find(">>>"), name.find(" [", pos - begin)));
+            while(!name.empty() && isspace((unsigned char)name.back())) name.pop_back();
+
+            PhaseReport phase;
+            phase.name = name;
+            phase.time_ms = std::chrono::duration <double, std::milli> (std::chrono::steady_clock::now() - report->start_time).count();
+            phase.bytes_sent = report->io->sent;
+            phase.bytes_received = report->io->received;
+            report->vec_phase.emplace_back(phase); // stores the start point, turned into deltas by FinishParty
+        }
+        if(verbose){
+            std::lock_guard<std::mutex> lock(mtx);
+            original->sputn(line.data(), line.size());
+        }
+        line.clear();
+    }
+};
+
+void StartParty(PartyReport &report, NetIO &io)
+{
+    report.io = &io;
+    PhaseRecorder::current_report = &report;
+    report.start_time = std::chrono::steady_clock::now();
+}
+
+// turn the recorded phase start points into per-phase cost
+void FinishParty(PartyReport &report)
+{
+    report.time_ms = std::chrono::duration <double, std::milli> (std::chrono::steady_clock::now() - report.start_time).count();
+    report.bytes_sent = report.io->sent;
+    report.bytes_received = report.io->received;
+    PhaseRecorder::current_report = nullptr;
+
+    // traffic before the first banner (e.g., none for the PSO protocols) is merged into the first phase
+    if(report.vec_phase.empty()) report.vec_phase.emplace_back(PhaseReport{"protocol", 0, 0, 0});
+    report.vec_phase[0].time_ms = 0;
+    report.vec_phase[0].bytes_sent = 0;
+    report.vec_phase[0].bytes_received = 0;
+    // walk forward: vec_phase[i+1] still holds its start point when vec_phase[i] is computed
+    for(auto i = 0; i < report.vec_phase.size(); i++){
+        PhaseReport end_point{"", report.time_ms, report.bytes_sent, report.bytes_received};
+        if(i+1 < report.vec_phase.size()) end_point = report.vec_phase[i+1];
+        report.vec_phase[i].time_ms = end_point.time_ms - report.vec_phase[i].time_ms;
+        report.vec_phase[i].bytes_sent = end_point.bytes_sent - report.vec_phase[i].bytes_sent;
+        report.vec_phase[i].bytes_received = end_point.bytes_received - report.vec_phase[i].bytes_received;
+    }
+    report.io = nullptr;
+}
+
+long PeakRSS()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    #ifdef IS_MACOS
+    return usage.ru_maxrss/1024; // bytes on macOS
+    #else
+    return usage.ru_maxrss; // kilobytes on Linux
+    #endif
+}
+
+// reports travel from the child to the parent through a pipe as plain text
+std::string SerializeReport(const PartyReport &report)
+{
+    std::ostringstream out;
+    out << "party " << report.party << "\n";
+    out << "total " << report.correct << " " << report.time_ms << " " << report.bytes_sent << " "
+        << report.bytes_received << " " << report.peak_rss_kb << "\n";
+    for(auto &phase: report.vec_phase){
+        out << "phase " << phase.time_ms << " " << phase.bytes_sent << " " << phase.bytes_received << " " << phase.name << "\n";
+    }
+    out << "end\n";
+    return out.str();
+}
+
+std::vector<PartyReport> DeserializeReports(const std::string &str)
+{
+    std::vector<PartyReport> vec_report;
+    std::istringstream in(str);
+    std::string tag;
+    PartyReport report;
+    while(in >> tag){
+        if(tag == "party") in >> report.party;
+        if(tag == "total") in >> report.correct >> report.time_ms >> report.bytes_sent >> report.bytes_received >> report.peak_rss_kb;
+        if(tag == "phase"){
+            PhaseReport phase;
+            in >> phase.time_ms >> phase.bytes_sent >> phase.bytes_received;
+            std::getline(in >> std::ws, phase.name);
+            report.vec_phase.emplace_back(phase);
+        }
+        if(tag == "end"){
+            report.finished = true;
+            vec_report.emplace_back(report);
+            report = PartyReport();
+        }
+    }
+    return vec_report;
+}
+
+void WriteAll(int fd, const std::string &str)
+{
+    size_t offset = 0;
+    while(offset < str.size()){
+        ssize_t LEN = write(fd, str.data() + offset, str.size() - offset);
+        if(LEN <= 0) break;
+        offset += LEN;
+    }
+}
+
+std::string ReadAll(int fd)
+{
+    std::string str;
+    char buffer[4096];
+    ssize_t LEN;
+    while((LEN = read(fd, buffer, sizeof(buffer))) > 0) str.append(buffer, LEN);
+    return str;
+}
+
+/*
+** run one party: connect, run the role with phase recording, and fill its report
+** role(io) runs the protocol and returns whether its output is correct
+*/
+template <typename Role>
+void RunParty(const BenchConfig &config, bool IS_SERVER, Role &role, PartyReport &report)
+{
+    NUMBER_OF_THREADS = config.thread_num;
+    if(IS_SERVER == false) std::this_thread::sleep_for(std::chrono::milliseconds(100)); // wait until the server listens
+    NetIO io(IS_SERVER ? "server" : "client", IS_SERVER ? "" : "127.0.0.1", config.port);
+    StartParty(report, io);
+    report.correct = role(io);
+    FinishParty(report);
+    report.peak_rss_kb = PeakRSS();
+}
+
+/*
+** run sender and receiver in child process(es), collect their reports in the parent
+** SENDER_IS_SERVER tells which party listens
+*/
+template <typename SenderRole, typename ReceiverRole>
+std::vector<PartyReport> Launch(const BenchConfig &config, bool SENDER_IS_SERVER,
+                                SenderRole sender_role, ReceiverRole receiver_role)
+{
+    std::cout.flush();
+    int fd[2];
+    if(pipe(fd) != 0){
+        perror("error: pipe");
+        exit(1); // EXIT_FAILURE
+    }
+
+    // each child writes its report(s) to the pipe and leaves with _exit to skip the parent's atexit handlers
+    auto child_main = [&](std::vector<std::function<void(PartyReport&)>> vec_party, std::vector<std::string> vec_name){
+        close(fd[0]);
+        PhaseRecorder recorder(std::cout.rdbuf(), config.verbose);
+        std::streambuf *original = std::cout.rdbuf(&recorder);
+        std::vector<PartyReport> vec_report(vec_party.size());
+        std::vector<std::thread> vec_thread;
+        for(auto i = 0; i < vec_party.size(); i++){
+            vec_report[i].party = vec_name[i];
+            vec_thread.emplace_back([&, i](){ vec_party[i](vec_report[i]); });
+        }
+        for(auto &t: vec_thread) t.join();
+        std::cout.rdbuf(original);
+
+        std::string str;
+        for(auto &report: vec_report){
+            report.peak_rss_kb = PeakRSS();
+            str += SerializeReport(report);
+        }
+        WriteAll(fd[1], str);
+        close(fd[1]);
+        _exit(0);
+    };
+
+    std::function<void(PartyReport&)> sender = [&](PartyReport &report){
+        RunParty(config, SENDER_IS_SERVER, sender_role, report);
+    };
+    std::function<void(PartyReport&)> receiver = [&](PartyReport &report){
+        RunParty(config, !SENDER_IS_SERVER, receiver_role, report);
+    };
+
+    std::vector<pid_t> vec_pid;
+    if(config.mode == "inprocess"){
+        pid_t pid = fork();
+        if(pid == 0) child_main({sender, receiver}, {"sender", "receiver"});
+        vec_pid.emplace_back(pid);
+    }
+    else{
+        // start the listening party first
+        std::vector<std::function<void(PartyReport&)>> vec_party = {sender, receiver};
+        std::vector<std::string> vec_name = {"sender", "receiver"};
+        if(SENDER_IS_SERVER == false){
+            std::swap(vec_party[0], vec_party[1]);
+            std::swap(vec_name[0], vec_name[1]);
+        }
+        for(auto i = 0; i < 2; i++){
+            pid_t pid = fork();
+            if(pid == 0) child_main({vec_party[i]}, {vec_name[i]});
+            vec_pid.emplace_back(pid);
+        }
+    }
+
+    close(fd[1]);
+    std::string str = ReadAll(fd[0]);
+    close(fd[0]);
+    for(auto pid: vec_pid) waitpid(pid, nullptr, 0);
+
+    std::vector<PartyReport> vec_report = DeserializeReports(str);
+    std::vector<PartyReport> vec_result(2);
+    vec_result[0].party = "sender";
+    vec_result[1].party = "receiver";
+    for(auto &report: vec_report){
+        if(report.party == "sender") vec_result[0] = report;
+        if(report.party == "receiver") vec_result[1] = report;
+    }
+    return vec_result;
+}
+
+struct Workload{
+    std::vector<block> vec_X; // sender's set
+    std::vector<block> vec_Y; // receiver's set
+    std::vector<uint64_t> vec_value; // sender's values for PSI-card-sum
+    std::vector<block> vec_intersection;
+    size_t INTERSECTION_NUM;
+    size_t UNION_NUM;
+    uint64_t INTERSECTION_SUM;
+};
+
+Workload GenWorkload(size_t SENDER_ITEM_NUM, size_t RECEIVER_ITEM_NUM)
+{
+    Workload workload;
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0);
+    workload.vec_X = PRG::GenRandomBlocks(seed, SENDER_ITEM_NUM);
+    workload.vec_Y = PRG::GenRandomBlocks(seed, RECEIVER_ITEM_NUM);
+    workload.vec_value.resize(SENDER_ITEM_NUM);
+    PRG::GenRandomBytes(seed, (uint8_t*)workload.vec_value.data(), SENDER_ITEM_NUM*sizeof(uint64_t));
+
+    // half of the smaller set lies in the intersection
+    workload.INTERSECTION_NUM = std::min(SENDER_ITEM_NUM, RECEIVER_ITEM_NUM)/2;
+    workload.UNION_NUM = SENDER_ITEM_NUM + RECEIVER_ITEM_NUM - workload.INTERSECTION_NUM;
+    workload.INTERSECTION_SUM = 0;
+    for(auto i = 0; i < workload.INTERSECTION_NUM; i++){
+        workload.vec_value[i] &= 0xFFFFFFFF; // LOG_VALUE_BOUND = 32
+        workload.vec_X[i] = workload.vec_Y[i];
+        workload.vec_intersection.emplace_back(workload.vec_X[i]);
+        workload.INTERSECTION_SUM += workload.vec_value[i];
+    }
+    for(auto i = workload.INTERSECTION_NUM; i < SENDER_ITEM_NUM; i++) workload.vec_value[i] &= 0xFFFFFFFF;
+    std::shuffle(workload.vec_Y.begin(), workload.vec_Y.end(), global_built_in_prg);
+    return workload;
+}
+
+bool SameSet(std::vector<block> &vec_A, std::vector<block> &vec_B)
+{
+    std::set<block, BlockCompare> set_A(vec_A.begin(), vec_A.end());
+    std::set<block, BlockCompare> set_B(vec_B.begin(), vec_B.end());
+    if(set_A.size() != vec_A.size() || set_A.size() != set_B.size()) return false;
+    BlockCompare blockcmp;
+    return std::equal(set_A.begin(), set_A.end(), set_B.begin(),
+                      [&](const block &a, const block &b){ return !blockcmp(a, b) && !blockcmp(b, a); });
+}
+
+// the PSO Setups fix the default filter, so redo cwPRFmqRPMT::Setup with the chosen one to keep its range checks
+cwPRFmqRPMT::PP SetupFilter(const cwPRFmqRPMT::PP &pp, const std::string &filter_type)
+{
+    return cwPRFmqRPMT::Setup(pp.statistical_security_parameter, pp.LOG_SERVER_LEN, pp.LOG_CLIENT_LEN, pp.CHUNK_LEN, filter_type);
+}
+
+// "a:b" means 2^a sender items and 2^b receiver items, "a" means 2^a on both sides
+std::pair<size_t, size_t> ParseLogItemNum(const std::string &log_item_num)
+{
+    size_t pos = log_item_num.find(':');
+    size_t LOG_SENDER_ITEM_NUM = std::stoul(log_item_num.substr(0, pos));
+    size_t LOG_RECEIVER_ITEM_NUM = (pos == std::string::npos) ? LOG_SENDER_ITEM_NUM : std::stoul(log_item_num.substr(pos + 1));
+    return {LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM};
+}
+
+std::vector<PartyReport> Benchmark(const BenchConfig &config)
+{
+    // public parameters and the workload are generated once in the parent and inherited by the children
+    // each role works on its own copy of pp, since some protocols write to it (e.g., the okvs seed of VOLE-based OPRF)
+    size_t computational_security_parameter = 128;
+    size_t statistical_security_parameter = 40;
+    size_t LOG_SENDER_ITEM_NUM = config.LOG_SENDER_ITEM_NUM;
+    size_t LOG_RECEIVER_ITEM_NUM = config.LOG_RECEIVER_ITEM_NUM;
+    Workload workload = GenWorkload(size_t(1) << LOG_SENDER_ITEM_NUM, size_t(1) << LOG_RECEIVER_ITEM_NUM);
+
+    if(config.protocol == "psi"){
+        mqRPMTPSI::PP pp = mqRPMTPSI::Setup(computational_security_parameter, statistical_security_parameter,
+                                            LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM);
+        pp.mqrpmt_part = SetupFilter(pp.mqrpmt_part, config.filter_type);
+        return Launch(config, false,
+            [&, pp](NetIO &io) mutable { mqRPMTPSI::Send(io, pp, workload.vec_X); return true; },
+            [&, pp](NetIO &io) mutable {
+                std::vector<block> vec_intersection = mqRPMTPSI::Receive(io, pp, workload.vec_Y);
+                return SameSet(vec_intersection, workload.vec_intersection);
+            });
+    }
+
+    if(config.protocol == "psi_card"){
+        mqRPMTPSIcard::PP pp = mqRPMTPSIcard::Setup(computational_security_parameter, statistical_security_parameter,
+                                                    LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM);
+        pp.mqrpmt_part = SetupFilter(pp.mqrpmt_part, config.filter_type);
+        return Launch(config, false,
+            [&, pp](NetIO &io) mutable { mqRPMTPSIcard::Send(io, pp, workload.vec_X); return true; },
+            [&, pp](NetIO &io) mutable { return mqRPMTPSIcard::Receive(io, pp, workload.vec_Y) == workload.INTERSECTION_NUM; });
+    }
+
+    if(config.protocol == "psi_card_sum"){
+        mqRPMTPSIcardsum::PP pp = mqRPMTPSIcardsum::Setup(computational_security_parameter, statistical_security_parameter,
+                                                          LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM, 64, 32);
+        pp.mqrpmt_part = SetupFilter(pp.mqrpmt_part, config.filter_type);
+        return Launch(config, false,
+            [&, pp](NetIO &io) mutable {
+                auto [CARDINALITY, SUM] = mqRPMTPSIcardsum::Send(io, pp, workload.vec_X, workload.vec_value);
+                return CARDINALITY == workload.INTERSECTION_NUM && SUM == workload.INTERSECTION_SUM;
+            },
+            [&, pp](NetIO &io) mutable { return mqRPMTPSIcardsum::Receive(io, pp, workload.vec_Y) == workload.INTERSECTION_NUM; });
+    }
+
+    if(config.protocol == "psu"){
+        mqRPMTPSU::PP pp = mqRPMTPSU::Setup(computational_security_parameter, statistical_security_parameter,
+                                            LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM);
+        pp.mqrpmt_part = SetupFilter(pp.mqrpmt_part, config.filter_type);
+        return Launch(config, false,
+            [&, pp](NetIO &io) mutable { mqRPMTPSU::Send(io, pp, workload.vec_X); return true; },
+            [&, pp](NetIO &io) mutable {
+                std::vector<block> vec_union = mqRPMTPSU::Receive(io, pp, workload.vec_Y);
+                std::vector<block> vec_union_ideal = workload.vec_Y;
+                vec_union_ideal.insert(vec_union_ideal.end(), workload.vec_X.begin() + workload.INTERSECTION_NUM, workload.vec_X.end());
+                return SameSet(vec_union, vec_union_ideal);
+            });
+    }
+
+    if(config.protocol == "private_id"){
+        // the distributed OPRF is set up for 2^LOG_PRF_INPUT_LEN inputs on both sides
+        if(LOG_SENDER_ITEM_NUM != LOG_RECEIVER_ITEM_NUM){
+            std::cerr << "private_id requires equal set sizes, reported as failed" << std::endl;
+            std::vector<PartyReport> vec_report(2);
+            vec_report[0].party = "sender";
+            vec_report[1].party = "receiver";
+            return vec_report;
+        }
+        size_t LOG_PRF_INPUT_LEN = std::max(LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM);
+        mqRPMTPrivateID::PP pp = mqRPMTPrivateID::Setup(LOG_PRF_INPUT_LEN, computational_security_parameter,
+                                                        statistical_security_parameter, LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM);
+        pp.psu_part.mqrpmt_part = SetupFilter(pp.psu_part.mqrpmt_part, config.filter_type);
+        size_t ITEM_LEN = pp.oprf_part.RANGE_SIZE;
+        VOLE::PreparePP(); // both children would otherwise race to create the base OT files
+
+        // each party checks that the union has the right size and contains all of its own IDs
+        auto CheckID = [&](std::vector<std::vector<uint8_t>> &vec_union_id, std::vector<std::vector<uint8_t>> &vec_own_id){
+            std::set<std::vector<uint8_t>> set_union(vec_union_id.begin(), vec_union_id.end());
+            if(vec_union_id.size() != workload.UNION_NUM || set_union.size() != workload.UNION_NUM) return false;
+            for(auto &id: vec_own_id) if(set_union.count(id) == 0) return false;
+            return true;
+        };
+        return Launch(config, true,
+            [&, pp](NetIO &io) mutable {
+                auto [vec_union_id, vec_X_id] = mqRPMTPrivateID::Send(io, pp, workload.vec_X, ITEM_LEN);
+                return CheckID(vec_union_id, vec_X_id);
+            },
+            [&, pp](NetIO &io) mutable {
+                auto [vec_union_id, vec_Y_id] = mqRPMTPrivateID::Receive(io, pp, workload.vec_Y, ITEM_LEN);
+                return CheckID(vec_union_id, vec_Y_id);
+            });
+    }
+
+    if(config.protocol == "cwprf_psi"){
+        cwPRFPSI::PP pp = cwPRFPSI::Setup(computational_security_parameter, statistical_security_parameter,
+                                          LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM);
+        return Launch(config, false,
+            [&, pp](NetIO &io) mutable { cwPRFPSI::Send(io, pp, workload.vec_X); return true; },
+            [&, pp](NetIO &io) mutable {
+                std::vector<block> vec_intersection = cwPRFPSI::Receive(io, pp, workload.vec_Y);
+                return SameSet(vec_intersection, workload.vec_intersection);
+            });
+    }
+
+    std::cerr << "unknown protocol: " << config.protocol << std::endl;
+    exit(1); // EXIT_FAILURE
+}
+
+std::string EscapeJSON(const std::string &str)
+{
+    std::string result;
+    for(auto c: str){
+        if(c == '"' || c == '\\') result += '\\';
+        if((unsigned char)c < 0x20) continue;
+        result += c;
+    }
+    return result;
+}
+
+void WriteJSON(std::ostream &out, const BenchConfig &config, const std::vector<PartyReport> &vec_report, bool first)
+{
+    out << (first ? "[\n" : ",\n");
+    out << "  {\"protocol\": \"" << config.protocol << "\", \"mode\": \"" << config.mode << "\""
+        << ", \"log_sender_item_num\": " << config.LOG_SENDER_ITEM_NUM
+        << ", \"log_receiver_item_num\": " << config.LOG_RECEIVER_ITEM_NUM
+        << ", \"threads\": " << config.thread_num
+        << ", \"filter\": \"" << (config.protocol == "cwprf_psi" ? "" : config.filter_type) << "\""
+        << ", \"repeat\": " << config.repeat_index
+        << ", \"correct\": " << ((vec_report[0].correct && vec_report[1].correct) ? "true" : "false")
+        << ", \"parties\": {";
+    for(auto i = 0; i < vec_report.size(); i++){
+        auto &report = vec_report[i];
+        out << (i ? ", " : "") << "\n    \"" << report.party << "\": {\"finished\": " << (report.finished ? "true" : "false")
+            << ", \"time_ms\": " << report.time_ms << ", \"bytes_sent\": " << report.bytes_sent
+            << ", \"bytes_received\": " << report.bytes_received << ", \"peak_rss_kb\": " << report.peak_rss_kb
+            << ", \"phases\": [";
+        for(auto j = 0; j < report.vec_phase.size(); j++){
+            auto &phase = report.vec_phase[j];
+            out << (j ? ", " : "") << "\n      {\"name\": \"" << EscapeJSON(phase.name) << "\", \"time_ms\": " << phase.time_ms
+                << ", \"bytes_sent\": " << phase.bytes_sent << ", \"bytes_received\": " << phase.bytes_received << "}";
+        }
+        out << "]}";
+    }
+    out << "}}";
+}
+
+// one row per (run, party, phase), the party's totals are the row with phase = "total"
+void WriteCSV(std::ostream &out, const BenchConfig &config, const std::vector<PartyReport> &vec_report, bool first)
+{
+    if(first){
+        out << "protocol,mode,log_sender_item_num,log_receiver_item_num,threads,filter,repeat,correct,"
+            << "party,phase,time_ms,bytes_sent,bytes_received,peak_rss_kb\n";
+    }
+    bool correct = vec_report[0].correct && vec_report[1].correct;
+    for(auto &report: vec_report){
+        std::vector<PhaseReport> vec_row = report.vec_phase;
+        vec_row.emplace_back(PhaseReport{"total", report.time_ms, report.bytes_sent, report.bytes_received});
+        for(auto &phase: vec_row){
+            std::string name = phase.name;
+            std::replace(name.begin(), name.end(), '"', '\'');
+            out << config.protocol << "," << config.mode << "," << config.LOG_SENDER_ITEM_NUM << ","
+                << config.LOG_RECEIVER_ITEM_NUM << "," << config.thread_num << ","
+                << (config.protocol == "cwprf_psi" ? "" : config.filter_type) << "," << config.repeat_index << ","
+                << correct << "," << report.party << ",\"" << name << "\"," << phase.time_ms << ","
+                << phase.bytes_sent << "," << phase.bytes_received << "," << report.peak_rss_kb << "\n";
+        }
+    }
+}
+
+std::vector<std::string> SplitList(const std::string &str)
+{
+    std::vector<std::string> vec_item;
+    std::stringstream ss(str);
+    std::string item;
+    while(std::getline(ss, item, ',')) if(!item.empty()) vec_item.emplace_back(item);
+    return vec_item;
+}
+
+int main(int argc, char *argv[])
+{
+    // keep stdout clean for the results
+    std::streambuf *stdout_buffer = std::cout.rdbuf(std::cerr.rdbuf());
+    CRYPTO_Initialize();
+    std::cout.rdbuf(stdout_buffer);
+
+    std::map<std::string, std::string> options = {
+        {"protocol", "psi"}, {"log_item_num", "12"}, {"threads", std::to_string(NUMBER_OF_THREADS)},
+        {"filter", "bloom"}, {"mode", "localhost"}, {"repeat", "1"}, {"port", "8080"},
+        {"format", "json"}, {"output", ""}, {"verbose", "0"}
+    };
+    for(auto i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        size_t pos = arg.find('=');
+        if(pos == std::string::npos || options.count(arg.substr(0, pos)) == 0){
+            std::cerr << "unknown option: " << arg << std::endl;
+            exit(1); // EXIT_FAILURE
+        }
+        options[arg.substr(0, pos)] = arg.substr(pos + 1);
+    }
+    if(options["mode"] != "localhost" && options["mode"] != "inprocess"){
+        std::cerr << "mode must be localhost or inprocess" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+    if(options["format"] != "json" && options["format"] != "csv"){
+        std::cerr << "format must be json or csv" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+    // validate every filter against every size before the first run, cwPRFmqRPMT::Setup exits on a bad combination
+    // (cuckoo needs lambda <= 29 while the benchmark runs lambda = 40, gcs needs LOG_RECEIVER_ITEM_NUM + 40 < 64)
+    for(auto &filter_type: SplitList(options["filter"])){
+        for(auto &log_item_num: SplitList(options["log_item_num"])){
+            auto [LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM] = ParseLogItemNum(log_item_num);
+            cwPRFmqRPMT::Setup(40, LOG_RECEIVER_ITEM_NUM, LOG_SENDER_ITEM_NUM, 0, filter_type);
+        }
+    }
+
+    std::ofstream fout;
+    if(options["output"] != ""){
+        fout.open(options["output"]);
+        if(!fout){
+            std::cerr << options["output"] << " open error" << std::endl;
+            exit(1); // EXIT_FAILURE
+        }
+    }
+    std::ostream &out = (options["output"] != "") ? fout : std::cout;
+
+    // the parent stays single-threaded, so that forking never copies a live OpenMP thread pool
+    NUMBER_OF_THREADS = 1;
+
+    bool first = true;
+    size_t RUN_NUM = 0;
+    size_t FAILURE_NUM = 0;
+    int port = std::stoi(options["port"]);
+    for(auto &protocol: SplitList(options["protocol"])){
+        for(auto &log_item_num: SplitList(options["log_item_num"])){
+            for(auto &thread_num: SplitList(options["threads"])){
+                // the filter option only matters for protocols built on cwPRF-based mqRPMT
+                std::vector<std::string> vec_filter_type = SplitList(options["filter"]);
+                if(protocol == "cwprf_psi") vec_filter_type.resize(1);
+                for(auto &filter_type: vec_filter_type){
+                    for(auto repeat_index = 0; repeat_index < std::stoul(options["repeat"]); repeat_index++){
+                        BenchConfig config;
+                        config.protocol = protocol;
+                        config.mode = options["mode"];
+                        std::tie(config.LOG_SENDER_ITEM_NUM, config.LOG_RECEIVER_ITEM_NUM) = ParseLogItemNum(log_item_num);
+                        config.thread_num = std::stoul(thread_num);
+                        config.filter_type = filter_type;
+                        config.repeat_index = repeat_index;
+                        config.port = port;
+                        config.verbose = (options["verbose"] == "1");
+
+                        std::cerr << "running " << protocol << " (" << config.mode << "): 2^" << config.LOG_SENDER_ITEM_NUM
+                                  << " vs 2^" << config.LOG_RECEIVER_ITEM_NUM << " items, " << config.thread_num << " threads"
+                                  << (protocol == "cwprf_psi" ? "" : ", " + filter_type + " filter") << std::endl;
+                        std::vector<PartyReport> vec_report = Benchmark(config);
+
+                        if(options["format"] == "json") WriteJSON(out, config, vec_report, first);
+                        else WriteCSV(out, config, vec_report, first);
+                        out.flush();
+                        first = false;
+                        RUN_NUM++;
+                        if(!(vec_report[0].correct && vec_report[1].correct)) FAILURE_NUM++;
+                    }
+                }
+            }
+        }
+    }
+    if(options["format"] == "json") out << (first ? "[]\n" : "\n]\n");
+    std::cerr << RUN_NUM << " runs finished, " << FAILURE_NUM << " failed or gave wrong results" << std::endl;
+
+    CRYPTO_Finalize();
+    return (FAILURE_NUM == 0) ? 0 : 1;
+}
@@ -96,6 +96,7 @@ void test_gadget2(BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, size_t &RANGE_LEN, si
     size_t TRADEOFF_NUM = 7;
     TwistedExponentialElGamal::PP pp_enc = TwistedExponentialElGamal::Setup(RANGE_LEN, TRADEOFF_NUM); 
     Gadget::PP pp = Gadget::Setup(pp_enc, pp_bullet);
+    DLogSolver dlog_solver = TwistedExponentialElGamal::Initialize(pp.enc_part); 
     Gadget::Instance instance; 
     Gadget::Witness_type2 witness; 
     GenRandomGadget2InstanceWitness(pp, instance, witness);
@@ -104,7 +105,7 @@ void test_gadget2(BigInt &LEFT_BOUND, BigInt &RIGHT_BOUND, size_t &RANGE_LEN, si
     
     auto start_time = std::chrono::steady_clock::now(); // start to count the time
     transcript_str = ""; 
-    Gadget::Prove(pp, instance, LEFT_BOUND, RIGHT_BOUND, witness, transcript_str, proof); 
+    Gadget::Prove(pp, dlog_solver, instance, LEFT_BOUND, RIGHT_BOUND, witness, transcript_str, proof); 
     auto end_time = std::chrono::steady_clock::now(); // end to count the time
     auto running_time = end_time - start_time;
     std::cout << "proof generation takes time = " 
@@ -0,0 +1,202 @@
+#include "../mpc/psi/sharded_psi.hpp"
+#include "../crypto/setup.hpp"
+
+
+struct TestCase{
+    size_t LOG_SENDER_ITEM_NUM; 
+    size_t LOG_RECEIVER_ITEM_NUM; 
+    size_t SENDER_ITEM_NUM; 
+    size_t RECEIVER_ITEM_NUM; 
+    std::vector<block> vec_X; // sender's set
+    std::vector<block> vec_Y; // receiver's set
+
+    size_t HAMMING_WEIGHT; // cardinality of intersection
+    std::vector<uint8_t> vec_indication_bit; // X[i] = Y[i] iff b[i] = 1 
+
+    std::vector<block> vec_intersection; // for PSI 
+
+};
+
+// LEN is the cardinality of two sets
+TestCase GenTestCase(size_t LOG_SENDER_ITEM_NUM, size_t LOG_RECEIVER_ITEM_NUM)
+{
+    TestCase testcase;
+
+    testcase.LOG_SENDER_ITEM_NUM = LOG_SENDER_ITEM_NUM; 
+    testcase.LOG_RECEIVER_ITEM_NUM = LOG_RECEIVER_ITEM_NUM; 
+    testcase.SENDER_ITEM_NUM = size_t(pow(2, testcase.LOG_SENDER_ITEM_NUM));  
+    testcase.RECEIVER_ITEM_NUM = size_t(pow(2, testcase.LOG_RECEIVER_ITEM_NUM)); 
+
+    PRG::Seed seed = PRG::SetSeed(nullptr, 0); // initialize PRG
+    testcase.vec_X = PRG::GenRandomBlocks(seed, testcase.SENDER_ITEM_NUM);
+    testcase.vec_Y = PRG::GenRandomBlocks(seed, testcase.RECEIVER_ITEM_NUM);
+
+    // set the Hamming weight to be a half of the max possible intersection size
+    testcase.HAMMING_WEIGHT = std::min(testcase.SENDER_ITEM_NUM, testcase.RECEIVER_ITEM_NUM)/2;
+
+    // generate a random indication bit vector conditioned on given Hamming weight
+    testcase.vec_indication_bit.resize(testcase.SENDER_ITEM_NUM);  
+    for(auto i = 0; i < testcase.SENDER_ITEM_NUM; i++){
+        if(i < testcase.HAMMING_WEIGHT) testcase.vec_indication_bit[i] = 1; 
+        else testcase.vec_indication_bit[i] = 0; 
+    }
+
+    std::shuffle(testcase.vec_indication_bit.begin(), testcase.vec_indication_bit.end(), global_built_in_prg);
+
+    // adjust vec_X and vec_Y
+    for(auto i = 0, j = 0; i < testcase.SENDER_ITEM_NUM; i++){
+        if(testcase.vec_indication_bit[i] == 1){
+            testcase.vec_X[i] = testcase.vec_Y[j];
+            testcase.vec_intersection.emplace_back(testcase.vec_Y[j]); 
+            j++; 
+        }
+    }
+
+    std::shuffle(testcase.vec_Y.begin(), testcase.vec_Y.end(), global_built_in_prg);
+
+    return testcase; 
+}
+
+void PrintTestCase(TestCase testcase)
+{
+    PrintSplitLine('-'); 
+    std::cout << "TESTCASE INFO >>>" << std::endl;
+    std::cout << "Sender's set size = " << testcase.SENDER_ITEM_NUM << std::endl;
+    std::cout << "Receiver's set size = " << testcase.RECEIVER_ITEM_NUM << std::endl;
+    std::cout << "Intersection cardinality = " << testcase.HAMMING_WEIGHT << std::endl; 
+    PrintSplitLine('-'); 
+}
+
+void SaveTestCase(TestCase &testcase, std::string testcase_filename)
+{
+    std::ofstream fout; 
+    fout.open(testcase_filename, std::ios::binary); 
+    if(!fout)
+    {
+        std::cerr << testcase_filename << " open error" << std::endl;
+        exit(1); 
+    }
+
+    fout << testcase.LOG_SENDER_ITEM_NUM; 
+    fout << testcase.LOG_RECEIVER_ITEM_NUM; 
+    fout << testcase.SENDER_ITEM_NUM; 
+    fout << testcase.RECEIVER_ITEM_NUM; 
+    fout << testcase.HAMMING_WEIGHT; 
+     
+    fout << testcase.vec_X; 
+    fout << testcase.vec_Y; 
+    fout << testcase.vec_indication_bit;
+    fout << testcase.vec_intersection; 
+
+    fout.close(); 
+}
+
+void FetchTestCase(TestCase &testcase, std::string testcase_filename)
+{
+    std::ifstream fin; 
+    fin.open(testcase_filename, std::ios::binary); 
+    if(!fin)
+    {
+        std::cerr << testcase_filename << " open error" << std::endl;
+        exit(1); 
+    }
+
+    fin >> testcase.LOG_SENDER_ITEM_NUM; 
+    fin >> testcase.LOG_RECEIVER_ITEM_NUM; 
+    fin >> testcase.SENDER_ITEM_NUM; 
+    fin >> testcase.RECEIVER_ITEM_NUM;
+    fin >> testcase.HAMMING_WEIGHT; 
+
+    testcase.vec_X.resize(testcase.SENDER_ITEM_NUM); 
+    testcase.vec_Y.resize(testcase.RECEIVER_ITEM_NUM); 
+    testcase.vec_indication_bit.resize(testcase.SENDER_ITEM_NUM); 
+    testcase.vec_intersection.resize(testcase.HAMMING_WEIGHT);   
+
+    fin >> testcase.vec_X; 
+    fin >> testcase.vec_Y; 
+    fin >> testcase.vec_indication_bit;
+    fin >> testcase.vec_intersection; 
+
+    fin.close(); 
+}
+
+int main()
+{
+    CRYPTO_Initialize(); 
+
+    std::cout << "sharded PSI test begins >>>" << std::endl; 
+
+    PrintSplitLine('-');  
+    std::cout << "generate or load public parameters and test case" << std::endl;
+
+    // generate pp (must be same for both server and client)
+    std::string pp_filename = "ShardedPSI.pp"; 
+    ShardedPSI::PP pp;   
+    if(!FileExist(pp_filename)){
+        std::cout << pp_filename << " does not exist" << std::endl; 
+        std::string psi_type = "cwprf"; // cwprf or mqrpmt
+        size_t computational_security_parameter = 128;         
+        size_t statistical_security_parameter = 40; 
+        size_t LOG_SENDER_ITEM_NUM = 16;
+        size_t LOG_RECEIVER_ITEM_NUM = 16;  
+        size_t SHARD_NUM = 4; 
+        pp = ShardedPSI::Setup(psi_type, computational_security_parameter, statistical_security_parameter, 
+                               LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM, SHARD_NUM); 
+        ShardedPSI::SavePP(pp, pp_filename); 
+    }
+    else{
+        std::cout << pp_filename << " already exists" << std::endl; 
+        ShardedPSI::FetchPP(pp, pp_filename); 
+    }
+    std::cout << "psi type = " << pp.psi_type << ", shard num = " << pp.SHARD_NUM 
+              << ", sender shard capacity = " << pp.SENDER_SHARD_CAPACITY 
+              << ", receiver shard capacity = " << pp.RECEIVER_SHARD_CAPACITY << std::endl; 
+
+    std::string testcase_filename = "ShardedPSI.testcase"; 
+    
+    // generate test instance (must be same for server and client)
+    TestCase testcase; 
+    size_t LOG_SENDER_ITEM_NUM = size_t(log2(pp.SENDER_ITEM_NUM)); 
+    size_t LOG_RECEIVER_ITEM_NUM = size_t(log2(pp.RECEIVER_ITEM_NUM)); 
+    if(!FileExist(testcase_filename)){ 
+        std::cout << testcase_filename << " does not exist" << std::endl; 
+        testcase = GenTestCase(LOG_SENDER_ITEM_NUM, LOG_RECEIVER_ITEM_NUM); 
+        SaveTestCase(testcase, testcase_filename); 
+    }
+    else{
+        std::cout << testcase_filename << " already exist" << std::endl; 
+        FetchTestCase(testcase, testcase_filename);
+        if((testcase.LOG_SENDER_ITEM_NUM != LOG_SENDER_ITEM_NUM) || (testcase.LOG_RECEIVER_ITEM_NUM != LOG_RECEIVER_ITEM_NUM)){
+            std::cerr << "testcase and public parameter do not match" << std::endl; 
+        }
+    }
+    PrintTestCase(testcase); 
+
+    int BASE_PORT = 8080; 
+
+    std::string party;
+    std::cout << "please select your role between sender and receiver (hint: first start receiver, then start sender) ==> "; 
+    std::getline(std::cin, party);
+
+    PrintSplitLine('-'); 
+
+    // both psi types run all shards in this process, one thread and one port per shard
+    if(party == "sender"){
+        ShardedPSI::Send(pp, testcase.vec_X, "127.0.0.1", BASE_PORT);
+    } 
+
+    if(party == "receiver"){
+        std::vector<block> vec_intersection_ideal = testcase.vec_intersection; 
+        std::vector<block> vec_intersection_real = ShardedPSI::Receive(pp, testcase.vec_Y, BASE_PORT); 
+
+        std::set<block, BlockCompare> set_diff_result = 
+            ComputeSetDifference(vec_intersection_real, vec_intersection_ideal);  
+
+        double error_probability = set_diff_result.size()/double(vec_intersection_ideal.size()); 
+        std::cout << "sharded PSI test succeeds with probability " << (1 - error_probability) << std::endl; 
+    }
+
+    CRYPTO_Finalize();   
+    
+    return 0; 
+}
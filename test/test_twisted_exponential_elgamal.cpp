@@ -13,7 +13,7 @@ void benchmark_test(size_t MSG_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
     PrintSplitLine('-'); 
 
     TwistedExponentialElGamal::PP pp = TwistedExponentialElGamal::Setup(MSG_LEN, TRADEOFF_NUM);
-    TwistedExponentialElGamal::Initialize(pp); 
+    DLogSolver dlog_solver = TwistedExponentialElGamal::Initialize(pp); 
     PrintSplitLine('-'); 
 
     ECPoint pk[TEST_NUM];                      // pk
@@ -70,7 +70,7 @@ void benchmark_test(size_t MSG_LEN, size_t TRADEOFF_NUM, size_t TEST_NUM)
     start_time = std::chrono::steady_clock::now(); 
     for(auto i = 0; i < TEST_NUM; i++)
     {
-        m_real[i] = TwistedExponentialElGamal::Dec(pp, sk[i], ct_new[i]); 
+        m_real[i] = TwistedExponentialElGamal::Dec(pp, dlog_solver, sk[i], ct_new[i]); 
     }
     end_time = std::chrono::steady_clock::now(); 
     running_time = end_time - start_time;
@@ -130,7 +130,7 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
     PrintSplitLine('-'); 
 
     TwistedExponentialElGamal::PP pp = TwistedExponentialElGamal::Setup(MSG_LEN, TRADEOFF_NUM);
-    TwistedExponentialElGamal::Initialize(pp); 
+    DLogSolver dlog_solver = TwistedExponentialElGamal::Initialize(pp); 
     PrintSplitLine('-'); 
 
     ECPoint pk;                      // pk
@@ -149,7 +149,7 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
 
     ct = TwistedExponentialElGamal::Enc(pp, pk, m_random);
 
-    m_real = TwistedExponentialElGamal::Dec(pp, sk, ct); 
+    m_real = TwistedExponentialElGamal::Dec(pp, dlog_solver, sk, ct); 
     if(m_random != m_real){ 
         std::cout << "decryption fails for random message" << std::endl;
     }
@@ -159,7 +159,7 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
 
     ct = TwistedExponentialElGamal::Enc(pp, pk, m_left);
 
-    m_real = TwistedExponentialElGamal::Dec(pp, sk, ct); 
+    m_real = TwistedExponentialElGamal::Dec(pp, dlog_solver, sk, ct); 
 
     if(m_left != m_real){ 
         std::cout << "decryption fails for left boundary" << std::endl;
@@ -169,7 +169,7 @@ void function_test(size_t MSG_LEN, size_t TRADEOFF_NUM)
     }
 
     ct = TwistedExponentialElGamal::Enc(pp, pk, m_right);
-    m_real = TwistedExponentialElGamal::Dec(pp, sk, ct); 
+    m_real = TwistedExponentialElGamal::Dec(pp, dlog_solver, sk, ct); 
     if(m_right != m_real){ 
         std::cout << "decryption fails for right boundary" << std::endl;
     }
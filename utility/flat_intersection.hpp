@@ -0,0 +1,174 @@
+/****************************************************************************
+this hpp implements a flat intersection engine for fixed-width keys
+*****************************************************************************
+* @author     This file is part of Kunlun, developed by Yu Chen
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_UTILITY_FLAT_INTERSECTION_HPP_
+#define KUNLUN_UTILITY_FLAT_INTERSECTION_HPP_
+
+#include "../include/global.hpp"
+
+/*
+** keys are (truncated) pseudorandom byte strings of at most 16 bytes, kept as fixed-width integers in flat arrays
+** intersection is computed via a parallel radix partition on the lowest bits followed by a per-partition sort-merge
+** this avoids per-item heap allocation and pointer chasing of std::unordered_set<std::string>
+*/
+
+namespace FlatIntersection{
+
+inline const size_t PARTITION_BITS = 8;
+inline const size_t PARTITION_NUM = size_t(1) << PARTITION_BITS;
+
+typedef unsigned __int128 uint128_t;
+
+// query key together with its position in the original vector
+template <typename KeyType>
+struct IndexedKey
+{
+    KeyType key;
+    uint32_t index;
+};
+
+template <typename KeyType>
+inline size_t PartitionDigit(const KeyType &key)
+{
+    return size_t(key) & (PARTITION_NUM - 1);
+}
+
+template <typename KeyType>
+inline size_t PartitionDigit(const IndexedKey<KeyType> &element)
+{
+    return size_t(element.key) & (PARTITION_NUM - 1);
+}
+
+// load LEN bytes starting from each data + i*STRIDE into a fixed-width integer (LEN <= sizeof(KeyType))
+template <typename KeyType>
+std::vector<KeyType> PackKeys(const uint8_t* data, size_t NUM, size_t STRIDE, size_t LEN)
+{
+    if(LEN > sizeof(KeyType)){
+        std::cerr << "key length exceeds the width of key type" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    std::vector<KeyType> vec_key(NUM);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < NUM; i++){
+        KeyType key = 0;
+        memcpy(&key, data + i*STRIDE, LEN);
+        vec_key[i] = key;
+    }
+    return vec_key;
+}
+
+/*
+** scatter vec_input to vec_output according to PartitionDigit (stable within each partition)
+** return the offset vector: partition p lies in [vec_offset[p], vec_offset[p+1])
+*/
+template <typename ElementType>
+std::vector<size_t> RadixPartition(const std::vector<ElementType> &vec_input, std::vector<ElementType> &vec_output)
+{
+    size_t NUM = vec_input.size();
+    size_t THREAD_NUM = NUMBER_OF_THREADS;
+    size_t CHUNK_SIZE = (NUM + THREAD_NUM - 1)/THREAD_NUM;
+
+    // per thread histogram
+    std::vector<std::vector<size_t>> vec_histogram(THREAD_NUM, std::vector<size_t>(PARTITION_NUM, 0));
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto t = 0; t < THREAD_NUM; t++){
+        size_t begin = std::min(NUM, t*CHUNK_SIZE);
+        size_t end = std::min(NUM, begin + CHUNK_SIZE);
+        for(auto i = begin; i < end; i++) vec_histogram[t][PartitionDigit(vec_input[i])]++;
+    }
+
+    // exclusive prefix sum in (partition, thread) order
+    std::vector<size_t> vec_offset(PARTITION_NUM + 1);
+    size_t sum = 0;
+    for(auto p = 0; p < PARTITION_NUM; p++){
+        vec_offset[p] = sum;
+        for(auto t = 0; t < THREAD_NUM; t++){
+            size_t count = vec_histogram[t][p];
+            vec_histogram[t][p] = sum;
+            sum += count;
+        }
+    }
+    vec_offset[PARTITION_NUM] = sum;
+
+    vec_output.resize(NUM);
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto t = 0; t < THREAD_NUM; t++){
+        size_t begin = std::min(NUM, t*CHUNK_SIZE);
+        size_t end = std::min(NUM, begin + CHUNK_SIZE);
+        for(auto i = begin; i < end; i++){
+            vec_output[vec_histogram[t][PartitionDigit(vec_input[i])]++] = vec_input[i];
+        }
+    }
+
+    return vec_offset;
+}
+
+/*
+** return the indication bit vector of vec_query: b[i] = 1 iff vec_query[i] appears in vec_set
+*/
+template <typename KeyType>
+std::vector<uint8_t> SortMergeIndicationBit(const std::vector<KeyType> &vec_set, const std::vector<KeyType> &vec_query)
+{
+    if(vec_query.size() > std::numeric_limits<uint32_t>::max()){
+        std::cerr << "the number of queries exceeds 2^32" << std::endl;
+        exit(1); // EXIT_FAILURE
+    }
+
+    std::vector<KeyType> vec_partitioned_set;
+    std::vector<size_t> vec_set_offset = RadixPartition(vec_set, vec_partitioned_set);
+
+    std::vector<IndexedKey<KeyType>> vec_indexed_query(vec_query.size());
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS)
+    for(auto i = 0; i < vec_query.size(); i++){
+        vec_indexed_query[i].key = vec_query[i];
+        vec_indexed_query[i].index = i;
+    }
+    std::vector<IndexedKey<KeyType>> vec_partitioned_query;
+    std::vector<size_t> vec_query_offset = RadixPartition(vec_indexed_query, vec_partitioned_query);
+    std::vector<IndexedKey<KeyType>>().swap(vec_indexed_query);
+
+    std::vector<uint8_t> vec_indication_bit(vec_query.size(), 0);
+
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) schedule(dynamic)
+    for(auto p = 0; p < PARTITION_NUM; p++){
+        auto set_begin = vec_partitioned_set.begin() + vec_set_offset[p];
+        auto set_end = vec_partitioned_set.begin() + vec_set_offset[p+1];
+        auto query_begin = vec_partitioned_query.begin() + vec_query_offset[p];
+        auto query_end = vec_partitioned_query.begin() + vec_query_offset[p+1];
+
+        std::sort(set_begin, set_end);
+        std::sort(query_begin, query_end, [](const IndexedKey<KeyType> &a, const IndexedKey<KeyType> &b){
+            return a.key < b.key;
+        });
+
+        // merge two sorted runs
+        auto it = set_begin;
+        for(auto jt = query_begin; jt != query_end; jt++){
+            while(it != set_end && *it < jt->key) it++;
+            if(it == set_end) break;
+            if(*it == jt->key) vec_indication_bit[jt->index] = 1;
+        }
+    }
+
+    return vec_indication_bit;
+}
+
+// return the indices (in ascending order) of the items in vec_query that appear in vec_set
+template <typename KeyType>
+std::vector<size_t> SortMergeIntersect(const std::vector<KeyType> &vec_set, const std::vector<KeyType> &vec_query)
+{
+    std::vector<uint8_t> vec_indication_bit = SortMergeIndicationBit(vec_set, vec_query);
+    std::vector<size_t> vec_index;
+    for(auto i = 0; i < vec_indication_bit.size(); i++){
+        if(vec_indication_bit[i] == 1) vec_index.emplace_back(i);
+    }
+    return vec_index;
+}
+
+}
+
+#endif
@@ -0,0 +1,147 @@
+/****************************************************************************
+this hpp implements bit streams and Golomb-Rice coding of non-negative integers
+*****************************************************************************
+* @author     This file is part of Kunlun, developed by Yu Chen
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_GOLOMB_CODING_HPP_
+#define KUNLUN_GOLOMB_CODING_HPP_
+
+#include "../include/std.inc"
+
+/*
+** bits are packed LSB first through a 64-bit word, which is stored with one unaligned write (little-endian host)
+** Rice code with parameter r: the quotient value >> r in unary (q ones and a zero), then the low r bits of value
+** for geometrically distributed values, e.g. gaps between sorted uniform positions, it is within 3% of the entropy
+*/
+
+namespace GolombCoding{
+
+class BitWriter{
+public:
+    std::vector<uint8_t> byte_vector; // holds exactly the written bytes after Flush
+    size_t byte_len = 0;
+    uint64_t word = 0; // pending bits, the low bit_num bits are valid
+    size_t bit_num = 0;
+
+    // append the low LEN bits of value, LEN <= 32
+    inline void Write(uint64_t value, size_t LEN)
+    {
+        word |= (value & ((uint64_t(1) << LEN) - 1)) << bit_num;
+        bit_num += LEN;
+        if(bit_num < 32) return;
+        // store the whole word and keep the incomplete byte pending
+        if(byte_len + 8 > byte_vector.size()) byte_vector.resize(2*byte_vector.size() + 64);
+        memcpy(byte_vector.data() + byte_len, &word, 8);
+        byte_len += bit_num >> 3;
+        word >>= bit_num & ~size_t(7);
+        bit_num &= 7;
+    }
+
+    inline void WriteUnary(uint64_t q)
+    {
+        for(; q >= 31; q -= 31) Write(0x7FFFFFFF, 31);
+        Write((uint64_t(1) << q) - 1, q + 1);
+    }
+
+    // r < 64, the remainder is written 32 bits at a time
+    inline void WriteRice(uint64_t value, size_t r)
+    {
+        WriteUnary(value >> r);
+        for(size_t LEN = 0; LEN < r; LEN += 32) Write(value >> LEN, std::min<size_t>(32, r - LEN));
+    }
+
+    // pad the last byte with zeros
+    inline void Flush()
+    {
+        byte_vector.resize(byte_len + 8);
+        memcpy(byte_vector.data() + byte_len, &word, 8);
+        byte_len += (bit_num + 7) >> 3;
+        byte_vector.resize(byte_len);
+        word = 0;
+        bit_num = 0;
+    }
+
+    inline size_t BitLen() const
+    {
+        return 8*byte_len + bit_num;
+    }
+};
+
+class BitReader{
+public:
+    const uint8_t* data;
+    size_t LEN; // in bytes
+    size_t position = 0; // next byte to load
+    uint64_t word = 0;
+    size_t bit_num = 0;
+    bool exhausted = false; // set once a read runs past the end of data
+
+    BitReader(const uint8_t* data, size_t LEN) : data(data), LEN(LEN) {}
+
+    inline void Refill()
+    {
+        while(bit_num <= 56 && position < LEN){
+            word |= uint64_t(data[position++]) << bit_num;
+            bit_num += 8;
+        }
+    }
+
+    // LEN <= 32
+    inline uint64_t Read(size_t READ_LEN)
+    {
+        if(bit_num < READ_LEN) Refill();
+        if(bit_num < READ_LEN){
+            exhausted = true;
+            return 0;
+        }
+        uint64_t value = word & ((uint64_t(1) << READ_LEN) - 1);
+        word >>= READ_LEN;
+        bit_num -= READ_LEN;
+        return value;
+    }
+
+    inline uint64_t ReadUnary()
+    {
+        uint64_t q = 0;
+        while(true){
+            if(bit_num == 0) Refill();
+            if(bit_num == 0){
+                exhausted = true;
+                return q;
+            }
+            // bits above bit_num are zero, so ~word has a set bit at or below bit_num unless all 64 bits are ones
+            uint64_t inverse = ~word;
+            size_t one_num = (inverse == 0) ? 64 : __builtin_ctzll(inverse);
+            if(one_num >= bit_num){
+                q += bit_num;
+                word = 0;
+                bit_num = 0;
+                continue;
+            }
+            q += one_num;
+            word = (one_num == 63) ? 0 : word >> (one_num + 1);
+            bit_num -= one_num + 1;
+            return q;
+        }
+    }
+
+    inline uint64_t ReadRice(size_t r)
+    {
+        uint64_t value = ReadUnary() << r;
+        for(size_t LEN = 0; LEN < r; LEN += 32) value |= Read(std::min<size_t>(32, r - LEN)) << LEN;
+        return value;
+    }
+};
+
+// Rice parameter for values of the given mean, close to the optimal Golomb parameter when it is rounded to a power of 2
+inline size_t RiceParameter(double mean)
+{
+    if(mean <= 1) return 0;
+    double r = std::round(std::log2(mean * std::log(2.0)));
+    return r < 0 ? 0 : std::min<size_t>(size_t(r), 63);
+}
+
+}
+
+#endif
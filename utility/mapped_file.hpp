@@ -0,0 +1,192 @@
+/****************************************************************************
+this hpp implements read-only memory mapped files with a versioned layout
+*****************************************************************************
+* @author     This file is part of Kunlun, developed by Yu Chen
+* @copyright  MIT license (see LICENSE file)
+*****************************************************************************/
+#ifndef KUNLUN_MAPPED_FILE_HPP_
+#define KUNLUN_MAPPED_FILE_HPP_
+
+#include "../include/std.inc"
+#include "../include/global.hpp"
+#include "murmurhash3.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+** layout: | MappedFileHeader | parameters | zero padding | table |
+** the table starts at a page boundary, so that a filter can query it in place from a read-only mapping:
+** loading is O(1), and all processes mapping the same file share one copy in the page cache
+** the header checksum is always verified, the table checksum costs a full pass and is verified on request
+*/
+
+inline const size_t MAPPED_FILE_PAGE_SIZE = 4096;
+inline const uint32_t MAPPED_FILE_VERSION = 1;
+inline const size_t MAPPED_FILE_CHECKSUM_CHUNK = size_t(1) << 20;
+
+struct MappedFileHeader{
+    char magic[8];            // identifies the filter type
+    uint32_t version;         // MAPPED_FILE_VERSION
+    uint32_t header_len;      // offset of the table, a multiple of MAPPED_FILE_PAGE_SIZE
+    uint64_t parameter_len;   // bytes of filter parameters right after this struct
+    uint64_t table_len;
+    uint64_t table_checksum;
+    uint64_t header_checksum; // checksum of the first header_len bytes with this field set to 0
+};
+
+namespace MappedFile{
+
+// chunk i is hashed with seed i and the results are folded by xor, so the chunks are hashed in parallel
+inline uint64_t Checksum(const uint8_t* data, size_t LEN)
+{
+    size_t CHUNK_NUM = (LEN + MAPPED_FILE_CHECKSUM_CHUNK - 1)/MAPPED_FILE_CHECKSUM_CHUNK;
+    uint64_t checksum = LEN;
+    #pragma omp parallel for num_threads(NUMBER_OF_THREADS) reduction(^:checksum)
+    for(auto i = 0; i < CHUNK_NUM; i++){
+        uint64_t digest[2];
+        size_t CHUNK_LEN = std::min(MAPPED_FILE_CHECKSUM_CHUNK, LEN - i*MAPPED_FILE_CHECKSUM_CHUNK);
+        MurmurHash3_x64_128(data + i*MAPPED_FILE_CHECKSUM_CHUNK, int(CHUNK_LEN), uint32_t(i), digest);
+        checksum ^= fmix64(digest[0] ^ (digest[1] + i));
+    }
+    return checksum;
+}
+
+// a read-only mapping of a whole file, unmapped when the last owner goes away
+class Mapping{
+public:
+    const uint8_t* data = nullptr;
+    size_t file_len = 0;
+
+    Mapping() {};
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    ~Mapping()
+    {
+        if(data != nullptr) munmap(const_cast<uint8_t*>(data), file_len);
+    }
+
+    bool Open(std::string file_name)
+    {
+        int fd = open(file_name.c_str(), O_RDONLY);
+        if(fd < 0){
+            std::cerr << file_name << " open error" << std::endl;
+            return false;
+        }
+        struct stat file_stat;
+        if(fstat(fd, &file_stat) != 0 || file_stat.st_size == 0){
+            std::cerr << file_name << " stat error" << std::endl;
+            close(fd);
+            return false;
+        }
+        file_len = file_stat.st_size;
+        void* ptr = mmap(nullptr, file_len, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd); // the mapping stays valid after the descriptor is closed
+        if(ptr == MAP_FAILED){
+            std::cerr << file_name << " mmap error" << std::endl;
+            file_len = 0;
+            return false;
+        }
+        data = static_cast<const uint8_t*>(ptr);
+        return true;
+    }
+
+    inline const MappedFileHeader* Header() const
+    {
+        return reinterpret_cast<const MappedFileHeader*>(data);
+    }
+
+    inline const uint8_t* Parameter() const
+    {
+        return data + sizeof(MappedFileHeader);
+    }
+
+    inline const uint8_t* Table() const
+    {
+        return data + Header()->header_len;
+    }
+};
+
+inline uint64_t HeaderChecksum(const uint8_t* header, size_t header_len)
+{
+    if(header_len < sizeof(MappedFileHeader)) return 0;
+    std::vector<uint8_t> buffer(header, header + header_len);
+    memset(buffer.data() + offsetof(MappedFileHeader, header_checksum), 0, sizeof(uint64_t));
+    return Checksum(buffer.data(), header_len);
+}
+
+// write | header | parameter | padding | table | to file_name
+inline bool Write(std::string file_name, const char magic[8], const std::vector<uint8_t> &parameter,
+                  const uint8_t* table, size_t table_len)
+{
+    MappedFileHeader header;
+    memcpy(header.magic, magic, 8);
+    header.version = MAPPED_FILE_VERSION;
+    size_t header_len = sizeof(MappedFileHeader) + parameter.size();
+    header.header_len = uint32_t((header_len + MAPPED_FILE_PAGE_SIZE - 1)/MAPPED_FILE_PAGE_SIZE*MAPPED_FILE_PAGE_SIZE);
+    header.parameter_len = parameter.size();
+    header.table_len = table_len;
+    header.table_checksum = Checksum(table, table_len);
+    header.header_checksum = 0;
+
+    std::vector<uint8_t> buffer(header.header_len, 0);
+    memcpy(buffer.data(), &header, sizeof(MappedFileHeader));
+    memcpy(buffer.data() + sizeof(MappedFileHeader), parameter.data(), parameter.size());
+    header.header_checksum = Checksum(buffer.data(), buffer.size());
+    memcpy(buffer.data() + offsetof(MappedFileHeader, header_checksum), &header.header_checksum, sizeof(uint64_t));
+
+    std::ofstream fout;
+    fout.open(file_name, std::ios::binary);
+    if(!fout){
+        std::cerr << file_name << " open error" << std::endl;
+        return false;
+    }
+    fout.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+    fout.write(reinterpret_cast<const char*>(table), table_len);
+    fout.close();
+
+    #ifdef DEBUG
+        std::cout << "'" << file_name << "' size = " << buffer.size() + table_len << " bytes" << std::endl;
+    #endif
+
+    return true;
+}
+
+// map file_name and check its magic, version, lengths and header checksum
+inline std::shared_ptr<Mapping> Open(std::string file_name, const char magic[8], bool verify_table_checksum = false)
+{
+    std::shared_ptr<Mapping> mapping = std::make_shared<Mapping>();
+    if(mapping->Open(file_name) == false) return nullptr;
+
+    const MappedFileHeader* header = mapping->Header();
+    if(mapping->file_len < sizeof(MappedFileHeader) || memcmp(header->magic, magic, 8) != 0){
+        std::cerr << file_name << " is not a mapped " << std::string(magic, strnlen(magic, 8)) << " file" << std::endl;
+        return nullptr;
+    }
+    if(header->version != MAPPED_FILE_VERSION){
+        std::cerr << file_name << " has version " << header->version << ", expect " << MAPPED_FILE_VERSION << std::endl;
+        return nullptr;
+    }
+    // the lengths come from the file, so compare by subtraction to avoid wrapping
+    if(header->header_len % MAPPED_FILE_PAGE_SIZE != 0 
+       || header->header_len < sizeof(MappedFileHeader) || header->parameter_len > header->header_len - sizeof(MappedFileHeader)
+       || header->header_len > mapping->file_len || header->table_len != mapping->file_len - header->header_len){
+        std::cerr << file_name << " has inconsistent lengths" << std::endl;
+        return nullptr;
+    }
+    if(HeaderChecksum(mapping->data, header->header_len) != header->header_checksum){
+        std::cerr << file_name << " header checksum mismatch" << std::endl;
+        return nullptr;
+    }
+    if(verify_table_checksum && Checksum(mapping->Table(), header->table_len) != header->table_checksum){
+        std::cerr << file_name << " table checksum mismatch" << std::endl;
+        return nullptr;
+    }
+    return mapping;
+}
+
+}
+
+#endif
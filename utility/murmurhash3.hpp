@@ -382,5 +382,219 @@ inline uint32_t LiteMurmurHash(uint32_t salt, const void* input, size_t LEN)
    return digest;
 }
 
+/*
+** multi-lane LiteMurmurHash, the output is identical to the scalar version
+** LiteMurmurHashBatch: one salt, ITEM_NUM keys of ITEM_LEN bytes stored contiguously, one key per lane
+** LiteMurmurHashMultiSalt: one key, SALT_NUM salts, one salt per lane, so that the hash functions of a bloom filter are derived in one pass
+** the lane number is chosen by cpuid: 16 with AVX-512, 8 with AVX2, otherwise the scalar version is called
+*/
+
+inline size_t LiteMurmurHashLaneNum()
+{
+   static const size_t lane_num = __builtin_cpu_supports("avx512f") ? 16 : (__builtin_cpu_supports("avx2") ? 8 : 1);
+   return lane_num;
+}
+
+// keys are gathered per lane, or broadcast when all lanes hash the same key
+__attribute__((target("avx2")))
+inline __m256i LiteMurmurLoadAVX2(const uint8_t* ptr, __m256i vindex, bool broadcast)
+{
+   if (broadcast){
+      uint32_t a;
+      memcpy(&a, ptr, 4);
+      return _mm256_set1_epi32(a);
+   }
+   return _mm256_i32gather_epi32(reinterpret_cast<const int*>(ptr), vindex, 1);
+}
+
+/*
+** lane i starts from digest[i] and hashes the LEN bytes at input + vindex[i] step by step as LiteMurmurHash
+** requires LEN >= 4: the 2- and 1-byte tails are read as the high part of the 4-byte word ending at them, 
+** so that no lane reads past its key
+*/
+__attribute__((target("avx2")))
+inline __m256i LiteMurmurHashAVX2(__m256i digest, const uint8_t* input, size_t LEN, __m256i vindex, bool broadcast)
+{
+   const __m256i all_one = _mm256_set1_epi32(-1);
+   size_t offset = 0;
+   uint32_t loop = 0;
+   for (; offset + 8 <= LEN; offset += 8){
+      __m256i a = LiteMurmurLoadAVX2(input + offset, vindex, broadcast);
+      __m256i b = LiteMurmurLoadAVX2(input + offset + 4, vindex, broadcast);
+      // digest ^= (digest << 7) ^ a * (digest >> 3) ^ (~((digest << 11) + (b ^ (digest >> 5))))
+      __m256i t = _mm256_add_epi32(_mm256_slli_epi32(digest, 11), _mm256_xor_si256(b, _mm256_srli_epi32(digest, 5)));
+      t = _mm256_xor_si256(_mm256_xor_si256(t, all_one), _mm256_slli_epi32(digest, 7));
+      t = _mm256_xor_si256(t, _mm256_mullo_epi32(a, _mm256_srli_epi32(digest, 3)));
+      digest = _mm256_xor_si256(digest, t);
+   }
+   if (LEN - offset >= 4){
+      __m256i c = LiteMurmurLoadAVX2(input + offset, vindex, broadcast);
+      __m256i t = _mm256_add_epi32(_mm256_slli_epi32(digest, 11), _mm256_xor_si256(c, _mm256_srli_epi32(digest, 5)));
+      digest = _mm256_xor_si256(digest, _mm256_xor_si256(t, all_one));
+      ++loop;
+      offset += 4;
+   }
+   if (LEN - offset >= 2){
+      __m256i d = _mm256_srli_epi32(LiteMurmurLoadAVX2(input + offset - 2, vindex, broadcast), 16);
+      __m256i t;
+      if (loop & 0x01){
+         t = _mm256_xor_si256(_mm256_slli_epi32(digest, 7), _mm256_mullo_epi32(d, _mm256_srli_epi32(digest, 3)));
+      }
+      else{
+         t = _mm256_add_epi32(_mm256_slli_epi32(digest, 11), _mm256_xor_si256(d, _mm256_srli_epi32(digest, 5)));
+         t = _mm256_xor_si256(t, all_one);
+      }
+      digest = _mm256_xor_si256(digest, t);
+      ++loop;
+      offset += 2;
+   }
+   if (LEN - offset == 1){
+      __m256i e = _mm256_srli_epi32(LiteMurmurLoadAVX2(input + offset - 3, vindex, broadcast), 24);
+      __m256i t = _mm256_xor_si256(e, _mm256_mullo_epi32(digest, _mm256_set1_epi32(0xA5A5A5A5)));
+      digest = _mm256_add_epi32(digest, _mm256_add_epi32(t, _mm256_set1_epi32(loop)));
+   }
+   return digest;
+}
+
+__attribute__((target("avx512f")))
+inline __m512i LiteMurmurLoadAVX512(const uint8_t* ptr, __m512i vindex, bool broadcast)
+{
+   if (broadcast){
+      uint32_t a;
+      memcpy(&a, ptr, 4);
+      return _mm512_set1_epi32(a);
+   }
+   return _mm512_i32gather_epi32(vindex, ptr, 1);
+}
+
+// 16-lane version of LiteMurmurHashAVX2
+__attribute__((target("avx512f")))
+inline __m512i LiteMurmurHashAVX512(__m512i digest, const uint8_t* input, size_t LEN, __m512i vindex, bool broadcast)
+{
+   const __m512i all_one = _mm512_set1_epi32(-1);
+   size_t offset = 0;
+   uint32_t loop = 0;
+   for (; offset + 8 <= LEN; offset += 8){
+      __m512i a = LiteMurmurLoadAVX512(input + offset, vindex, broadcast);
+      __m512i b = LiteMurmurLoadAVX512(input + offset + 4, vindex, broadcast);
+      __m512i t = _mm512_add_epi32(_mm512_slli_epi32(digest, 11), _mm512_xor_si512(b, _mm512_srli_epi32(digest, 5)));
+      t = _mm512_xor_si512(_mm512_xor_si512(t, all_one), _mm512_slli_epi32(digest, 7));
+      t = _mm512_xor_si512(t, _mm512_mullo_epi32(a, _mm512_srli_epi32(digest, 3)));
+      digest = _mm512_xor_si512(digest, t);
+   }
+   if (LEN - offset >= 4){
+      __m512i c = LiteMurmurLoadAVX512(input + offset, vindex, broadcast);
+      __m512i t = _mm512_add_epi32(_mm512_slli_epi32(digest, 11), _mm512_xor_si512(c, _mm512_srli_epi32(digest, 5)));
+      digest = _mm512_xor_si512(digest, _mm512_xor_si512(t, all_one));
+      ++loop;
+      offset += 4;
+   }
+   if (LEN - offset >= 2){
+      __m512i d = _mm512_srli_epi32(LiteMurmurLoadAVX512(input + offset - 2, vindex, broadcast), 16);
+      __m512i t;
+      if (loop & 0x01){
+         t = _mm512_xor_si512(_mm512_slli_epi32(digest, 7), _mm512_mullo_epi32(d, _mm512_srli_epi32(digest, 3)));
+      }
+      else{
+         t = _mm512_add_epi32(_mm512_slli_epi32(digest, 11), _mm512_xor_si512(d, _mm512_srli_epi32(digest, 5)));
+         t = _mm512_xor_si512(t, all_one);
+      }
+      digest = _mm512_xor_si512(digest, t);
+      ++loop;
+      offset += 2;
+   }
+   if (LEN - offset == 1){
+      __m512i e = _mm512_srli_epi32(LiteMurmurLoadAVX512(input + offset - 3, vindex, broadcast), 24);
+      __m512i t = _mm512_xor_si512(e, _mm512_mullo_epi32(digest, _mm512_set1_epi32(0xA5A5A5A5)));
+      digest = _mm512_add_epi32(digest, _mm512_add_epi32(t, _mm512_set1_epi32(loop)));
+   }
+   return digest;
+}
+
+// returns the number of keys hashed, a multiple of 8, the rest is left to the caller
+__attribute__((target("avx2")))
+inline size_t LiteMurmurHashBatchAVX2(uint32_t salt, const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM, uint32_t* digest)
+{
+   const __m256i vindex = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(ITEM_LEN));
+   size_t i = 0;
+   for (; i + 8 <= ITEM_NUM; i += 8){
+      __m256i h = LiteMurmurHashAVX2(_mm256_set1_epi32(salt), input + i*ITEM_LEN, ITEM_LEN, vindex, false);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(digest + i), h);
+   }
+   return i;
+}
+
+__attribute__((target("avx512f")))
+inline size_t LiteMurmurHashBatchAVX512(uint32_t salt, const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM, uint32_t* digest)
+{
+   const __m512i vindex = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), 
+                                             _mm512_set1_epi32(ITEM_LEN));
+   size_t i = 0;
+   for (; i + 16 <= ITEM_NUM; i += 16){
+      __m512i h = LiteMurmurHashAVX512(_mm512_set1_epi32(salt), input + i*ITEM_LEN, ITEM_LEN, vindex, false);
+      _mm512_storeu_si512(digest + i, h);
+   }
+   return i;
+}
+
+// digest[i] = LiteMurmurHash(salt, input + i*ITEM_LEN, ITEM_LEN)
+inline void LiteMurmurHashBatch(uint32_t salt, const uint8_t* input, size_t ITEM_LEN, size_t ITEM_NUM, uint32_t* digest)
+{
+   size_t i = 0;
+   // gather offsets are 32-bit
+   if (ITEM_LEN >= 4 && ITEM_LEN < (size_t(1) << 26)){
+      switch(LiteMurmurHashLaneNum()){
+         case 16: i = LiteMurmurHashBatchAVX512(salt, input, ITEM_LEN, ITEM_NUM, digest); break;
+         case  8: i = LiteMurmurHashBatchAVX2(salt, input, ITEM_LEN, ITEM_NUM, digest); break;
+      }
+   }
+   for (; i < ITEM_NUM; i++){
+      digest[i] = LiteMurmurHash(salt, input + i*ITEM_LEN, ITEM_LEN);
+   }
+}
+
+// the last group of salts is padded, so that every salt goes through the vector path
+__attribute__((target("avx2")))
+inline void LiteMurmurHashMultiSaltAVX2(const uint32_t* salt, size_t SALT_NUM, const void* input, size_t LEN, uint32_t* digest)
+{
+   const uint8_t* key = static_cast<const uint8_t*>(input);
+   for (size_t i = 0; i < SALT_NUM; i += 8){
+      uint32_t lane[8] = {0};
+      size_t LANE_NUM = std::min<size_t>(8, SALT_NUM - i);
+      memcpy(lane, salt + i, LANE_NUM*sizeof(uint32_t));
+      __m256i h = LiteMurmurHashAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lane)), key, LEN, _mm256_setzero_si256(), true);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lane), h);
+      memcpy(digest + i, lane, LANE_NUM*sizeof(uint32_t));
+   }
+}
+
+__attribute__((target("avx512f")))
+inline void LiteMurmurHashMultiSaltAVX512(const uint32_t* salt, size_t SALT_NUM, const void* input, size_t LEN, uint32_t* digest)
+{
+   const uint8_t* key = static_cast<const uint8_t*>(input);
+   for (size_t i = 0; i < SALT_NUM; i += 16){
+      uint32_t lane[16] = {0};
+      size_t LANE_NUM = std::min<size_t>(16, SALT_NUM - i);
+      memcpy(lane, salt + i, LANE_NUM*sizeof(uint32_t));
+      __m512i h = LiteMurmurHashAVX512(_mm512_loadu_si512(lane), key, LEN, _mm512_setzero_si512(), true);
+      _mm512_storeu_si512(lane, h);
+      memcpy(digest + i, lane, LANE_NUM*sizeof(uint32_t));
+   }
+}
+
+// digest[i] = LiteMurmurHash(salt[i], input, LEN)
+inline void LiteMurmurHashMultiSalt(const uint32_t* salt, size_t SALT_NUM, const void* input, size_t LEN, uint32_t* digest)
+{
+   if (LEN >= 4){
+      switch(LiteMurmurHashLaneNum()){
+         case 16: LiteMurmurHashMultiSaltAVX512(salt, SALT_NUM, input, LEN, digest); return;
+         case  8: LiteMurmurHashMultiSaltAVX2(salt, SALT_NUM, input, LEN, digest); return;
+      }
+   }
+   for (size_t i = 0; i < SALT_NUM; i++){
+      digest[i] = LiteMurmurHash(salt[i], input, LEN);
+   }
+}
+
 
 #endif
\ No newline at end of file